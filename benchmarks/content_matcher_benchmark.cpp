@@ -0,0 +1,158 @@
+/**
+ * @file content_matcher_benchmark.cpp
+ * @brief Measures ContentMatcher throughput against a large banned-term list
+ *
+ * Compiles N random terms plus a few hundred regexes, scans random
+ * message-sized texts, and compares against searching each term
+ * separately on a sample of the messages. Regex prefilter correctness
+ * is checked first.
+ */
+
+#include <discord/events/content_matcher.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string random_word(std::mt19937& rng, size_t min_length, size_t max_length) {
+    std::uniform_int_distribution<size_t> length(min_length, max_length);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::string word(length(rng), ' ');
+    for (char& c : word) {
+        c = static_cast<char>(letter(rng));
+    }
+    return word;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Check that escape operands are not taken as required text
+ *
+ * Regex prefilters must only require text every match contains; "\\x41"
+ * must not turn into a required "41".
+ *
+ * @return True if every pattern matches its text
+ */
+bool check_escape_literals() {
+    struct Case {
+        std::string pattern;
+        std::string text;
+    };
+    const Case cases[] = {
+        {"\\x41bcd", "Abcd"},
+        {"\\u0041bcd", "Abcd"},
+        {"\\0bcd", std::string("\0bcd", 4)},
+        {"(ab)\\1cde", "ababcde"},
+    };
+
+    bool passed = true;
+    for (const auto& test : cases) {
+        discord::ContentPatternSet set;
+        set.add_regex(test.pattern);
+        if (!set.compile().matches(test.text)) {
+            std::printf("FAIL: /%s/ does not match its text\n", test.pattern.c_str());
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t term_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    size_t message_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    constexpr size_t REGEX_COUNT = 200;
+    constexpr size_t NAIVE_SAMPLE = 200;
+
+    if (!check_escape_literals()) {
+        return 1;
+    }
+
+    std::mt19937 rng(42);
+
+    std::vector<std::string> terms;
+    terms.reserve(term_count);
+    for (size_t i = 0; i < term_count; ++i) {
+        terms.push_back(random_word(rng, 5, 10));
+    }
+
+    // Messages are random words with a banned term in roughly one in a hundred
+    std::vector<std::string> vocabulary;
+    for (size_t i = 0; i < 2000; ++i) {
+        vocabulary.push_back(random_word(rng, 2, 8));
+    }
+    std::uniform_int_distribution<size_t> pick_word(0, vocabulary.size() - 1);
+    std::uniform_int_distribution<size_t> pick_term(0, terms.size() - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    std::vector<std::string> messages;
+    size_t total_bytes = 0;
+    for (size_t i = 0; i < message_count; ++i) {
+        std::string message;
+        for (int w = 0; w < 30; ++w) {
+            message += vocabulary[pick_word(rng)];
+            message += ' ';
+        }
+        if (percent(rng) == 0) {
+            message += terms[pick_term(rng)];
+        }
+        total_bytes += message.size();
+        messages.push_back(std::move(message));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    discord::ContentPatternSet set;
+    for (const auto& term : terms) {
+        set.add_term(term);
+    }
+    for (size_t i = 0; i < REGEX_COUNT; ++i) {
+        set.add_regex(random_word(rng, 4, 6) + "\\s*\\d{2,}");
+    }
+    discord::ContentMatcher matcher = set.compile();
+    std::printf("compile: %zu patterns, %zu states, %.1f ms\n",
+                matcher.pattern_count(), matcher.state_count(), seconds_since(start) * 1000.0);
+
+    size_t matched = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& message : messages) {
+        matched += matcher.matches(message) ? 1 : 0;
+    }
+    double elapsed = seconds_since(start);
+    std::printf("matches():  %8.1f MB/s %10.0f messages/s (%zu matched)\n",
+                total_bytes / elapsed / 1e6, message_count / elapsed, matched);
+
+    size_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& message : messages) {
+        found += matcher.find_all(message).size();
+    }
+    elapsed = seconds_since(start);
+    std::printf("find_all(): %8.1f MB/s %10.0f messages/s (%zu found)\n",
+                total_bytes / elapsed / 1e6, message_count / elapsed, found);
+
+    // One find() per term, as a list of by_content filters would do
+    size_t sample = std::min(NAIVE_SAMPLE, messages.size());
+    size_t naive_matched = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < sample; ++i) {
+        for (const auto& term : terms) {
+            if (messages[i].find(term) != std::string::npos) {
+                naive_matched++;
+                break;
+            }
+        }
+    }
+    elapsed = seconds_since(start);
+    std::printf("per-term find: %16.0f messages/s (%zu of %zu matched, terms only)\n",
+                sample / elapsed, naive_matched, sample);
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file middleware_benchmark.cpp
+ * @brief Measures EventDispatcher::emit() through an empty and a five-step middleware chain
+ *
+ * Prints the time and the number of heap allocations per event.
+ */
+
+#include <discord/events/event_dispatcher.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+/**
+ * @brief Middleware that only passes the event on
+ */
+class PassThrough : public discord::IEventMiddleware {
+private:
+    int priority_;
+
+public:
+    explicit PassThrough(int priority) : priority_(priority) {}
+
+    bool process(const std::string&, const nlohmann::json&, discord::MiddlewareNext next) override {
+        next();
+        return true;
+    }
+
+    int get_priority() const override { return priority_; }
+    std::string get_name() const override { return "PassThrough" + std::to_string(priority_); }
+};
+
+void run(const char* label, discord::EventDispatcher& dispatcher, const nlohmann::json& event, int iterations) {
+    // Warm up so lazily created state is not counted
+    for (int i = 0; i < 1000; ++i) {
+        dispatcher.emit(discord::EventType::MESSAGE_CREATE, event);
+    }
+
+    uint64_t allocations_before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; ++i) {
+        dispatcher.emit(discord::EventType::MESSAGE_CREATE, event);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    uint64_t allocated = allocations.load() - allocations_before;
+
+    double ns_per_event = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    std::printf("%-24s %10.1f ns/event %8.2f allocations/event\n",
+                label, ns_per_event, static_cast<double>(allocated) / iterations);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    nlohmann::json event = {
+        {"id", "1234567890123456789"},
+        {"channel_id", "1234567890123456789"},
+        {"content", "hello"}
+    };
+
+    uint64_t handled = 0;
+
+    discord::EventDispatcher empty_chain;
+    empty_chain.on(discord::EventType::MESSAGE_CREATE, [&handled](const nlohmann::json&) { handled++; });
+    run("empty chain", empty_chain, event, iterations);
+
+    discord::EventDispatcher five_middleware;
+    five_middleware.on(discord::EventType::MESSAGE_CREATE, [&handled](const nlohmann::json&) { handled++; });
+    for (int priority = 0; priority < 5; ++priority) {
+        five_middleware.add_middleware(std::make_shared<PassThrough>(priority));
+    }
+    run("five middleware", five_middleware, event, iterations);
+
+    return handled > 0 ? 0 : 1;
+}
@@ -6,12 +6,20 @@
  */
 
 #include "config.h"
+#include "events/content_matcher.h"
+#include "events/event_filter.h"
+#include "events/event_types.h"
+#include "events/typed_events.h"
+#include "events/waiter_index.h"
+#include "events/interaction_router.h"
+#include "events/event_ingest_queue.h"
 #include "events/event_dispatcher.h"
 #include "events/event_handlers.h"
 #include "events/middleware.h"
 
 namespace discord::events {
     // Re-export commonly used types
+    using discord::EventType;
     using discord::EventDispatcher;
     using discord::EventHandler;
     using discord::Middleware;
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace discord {
+
+class ContentMatcher;
+
+/**
+ * @brief Set of terms and regexes to compile into a ContentMatcher
+ *
+ * Pattern IDs are assigned in insertion order, starting at 0, and are
+ * what the matcher reports.
+ */
+class ContentPatternSet {
+public:
+    struct Pattern {
+        std::string text;                         // Term, or regex source
+        std::shared_ptr<const std::regex> regex;  // Set for regexes
+        bool whole_word;
+    };
+
+private:
+    std::vector<Pattern> patterns_;
+    bool case_insensitive_;
+
+public:
+    /**
+     * @brief Construct an empty pattern set
+     * @param case_insensitive Whether ASCII letters match regardless of case
+     */
+    explicit ContentPatternSet(bool case_insensitive = true);
+
+    /**
+     * @brief Add a literal term
+     * @param term Text to find anywhere in the content
+     * @param whole_word Whether the term must not touch letters, digits or '_' on either side
+     * @return Pattern ID
+     */
+    size_t add_term(std::string term, bool whole_word = false);
+
+    /**
+     * @brief Add a regular expression
+     *
+     * The pattern is searched for, not matched against the whole content.
+     *
+     * @param pattern ECMAScript pattern
+     * @return Pattern ID
+     * @throws std::regex_error if the pattern is invalid
+     */
+    size_t add_regex(const std::string& pattern);
+
+    /**
+     * @brief Get number of patterns
+     * @return Pattern count
+     */
+    size_t size() const { return patterns_.size(); }
+
+    /**
+     * @brief Compile the set
+     * @return Matcher sharing nothing mutable with this set
+     */
+    ContentMatcher compile() const;
+};
+
+/**
+ * @brief Compiled multi-pattern matcher for message content
+ *
+ * All terms go into one Aho-Corasick automaton, so a scan costs one pass
+ * over the content however many terms there are. When it fits in 64 MiB
+ * the automaton is expanded into a full transition table over the bytes
+ * the patterns use, so each content byte costs one lookup. Each regex
+ * contributes a literal it cannot match without to the same automaton
+ * and is only run when that literal was seen; regexes without such a
+ * literal run on every scan. While no partial match is in progress the
+ * scan skips bytes that cannot start a term. Copies share the compiled
+ * automaton.
+ */
+class ContentMatcher {
+public:
+    struct Automaton;
+
+private:
+    std::shared_ptr<const Automaton> automaton_;
+
+    explicit ContentMatcher(std::shared_ptr<const Automaton> automaton);
+
+public:
+    /**
+     * @brief Construct a matcher that matches nothing
+     */
+    ContentMatcher() = default;
+
+    /**
+     * @brief Check whether any pattern occurs in the content
+     * @param content Text to scan
+     * @return True on the first match found
+     */
+    bool matches(std::string_view content) const;
+
+    /**
+     * @brief Find every pattern that occurs in the content
+     * @param content Text to scan
+     * @return Sorted IDs of the matching patterns
+     */
+    std::vector<size_t> find_all(std::string_view content) const;
+
+    /**
+     * @brief Get number of compiled patterns
+     * @return Pattern count
+     */
+    size_t pattern_count() const;
+
+    /**
+     * @brief Get number of automaton states
+     * @return State count
+     */
+    size_t state_count() const;
+
+    friend class ContentPatternSet;
+};
+
+} // namespace discord
@@ -1,15 +1,27 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <string>
+#include <string_view>
 #include <functional>
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <chrono>
+#include <condition_variable>
+#include <optional>
 #include <variant>
 #include <nlohmann/json.hpp>
 #include "../core/interfaces.h"
+#include "../utils/keyed_executor.h"
+#include "event_filter.h"
+#include "event_types.h"
+#include "typed_events.h"
+#include "waiter_index.h"
 
 namespace discord {
 
@@ -38,24 +50,43 @@ struct EventHandlerInfo {
         , created_at(std::chrono::steady_clock::now()) {}
 };
 
+/**
+ * @brief Key that keeps asynchronously dispatched events in order
+ */
+enum class DispatchOrdering {
+    GUILD,  // Events of one guild run in order; guild-less events by channel
+    CHANNEL // Events of one channel run in order; channel-less events by guild
+};
+
 /**
  * @brief Event collector configuration
  */
 struct CollectorConfig {
-    std::chrono::milliseconds timeout;
-    int max_matches;
-    bool dispose_on_timeout;
+    std::chrono::milliseconds timeout;  // 0 for no timeout
+    int max_matches;                    // 0 for no limit
+    bool dispose_on_timeout;            // Whether the timeout ends collection
+    WaitKey key;                        // Only offer events with this field...
+    Snowflake key_id;                   // ...set to this ID
     
     CollectorConfig(std::chrono::milliseconds to = std::chrono::milliseconds(30000), 
-                   int max = 1, bool dispose = true)
-        : timeout(to), max_matches(max), dispose_on_timeout(dispose) {}
+                   int max = 1, bool dispose = true,
+                   WaitKey wait_key = WaitKey::NONE, Snowflake wait_key_id = 0)
+        : timeout(to), max_matches(max), dispose_on_timeout(dispose)
+        , key(wait_key), key_id(wait_key_id) {}
 };
 
+class EventDispatcher;
+
 /**
  * @brief Event collector for waiting for specific events
+ *
+ * Registers with the dispatcher's waiter index, so it only sees events
+ * of its type and key, and is removed when it reaches max_matches, times
+ * out, is stopped or is destroyed. Must be owned by a shared_ptr while
+ * started; create_collector() does this.
  */
 template<typename T>
-class EventCollector {
+class EventCollector : public IEventWaiter, public std::enable_shared_from_this<EventCollector<T>> {
 public:
     using FilterFunction = std::function<bool(const T&)>;
     using CollectorCallback = std::function<void(const T&)>;
@@ -64,32 +95,20 @@ private:
     std::vector<T> collected_items_;
     FilterFunction filter_;
     CollectorConfig config_;
-    std::string handler_id_;
+    EventDispatcher* dispatcher_ = nullptr;
+    WaiterIndex::WaiterId waiter_id_ = 0;
     bool is_active_;
-    std::chrono::steady_clock::time_point start_time_;
-    mutable std::shared_mutex mutex_;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
     
     /**
-     * @brief Check if collector should stop
+     * @brief Check if collector should stop (mutex_ held)
      * @return True if max matches reached
      */
     bool should_stop_collecting() const {
         return config_.max_matches > 0 && 
                collected_items_.size() >= static_cast<size_t>(config_.max_matches);
     }
-    
-    /**
-     * @brief Check if collector has timed out
-     * @return True if timeout exceeded
-     */
-    bool is_timed_out() const {
-        if (config_.timeout.count() == 0) {
-            return false;
-        }
-        
-        auto now = std::chrono::steady_clock::now();
-        return (now - start_time_) > config_.timeout;
-    }
 
 public:
     /**
@@ -104,7 +123,7 @@ public:
     /**
      * @brief Destructor - cleans up handler
      */
-    ~EventCollector() {
+    ~EventCollector() override {
         stop();
     }
     
@@ -112,28 +131,37 @@ public:
      * @brief Start collecting events
      * @param dispatcher Event dispatcher to register with
      * @param event_name Event name to listen for
-     * @return Handler ID for cleanup
+     * @return Waiter ID in the dispatcher's index
      */
-    std::string start(class EventDispatcher* dispatcher, const std::string& event_name);
+    WaiterIndex::WaiterId start(EventDispatcher* dispatcher, const std::string& event_name);
     
     /**
-     * @brief Stop collecting events
+     * @brief Stop collecting events and deregister from the dispatcher
      */
     void stop();
     
     /**
      * @brief Process incoming event
      * @param event Event to process
-     * @return True if event was collected
+     * @return True if the collector is full
      */
     bool process_event(const nlohmann::json& event);
     
+    bool offer(const nlohmann::json& event_data) override { return process_event(event_data); }
+    
+    void finish() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_active_ = false;
+        dispatcher_ = nullptr;
+        changed_.notify_all();
+    }
+    
     /**
      * @brief Get collected items
      * @return Vector of collected items
      */
     std::vector<T> get_collected() const {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::lock_guard<std::mutex> lock(mutex_);
         return collected_items_;
     }
     
@@ -142,7 +170,7 @@ public:
      * @return First item or empty optional
      */
     std::optional<T> first() const {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::lock_guard<std::mutex> lock(mutex_);
         return collected_items_.empty() ? std::nullopt : std::optional<T>(collected_items_.front());
     }
     
@@ -154,9 +182,9 @@ public:
     std::optional<T> wait_for_first(std::chrono::milliseconds timeout = std::chrono::milliseconds(30000));
     
     /**
-     * @brief Wait for all matches
+     * @brief Wait until the collector is full or has ended
      * @param timeout Maximum time to wait
-     * @return All matching items or empty vector
+     * @return Items collected so far
      */
     std::vector<T> wait_for_all(std::chrono::milliseconds timeout = std::chrono::milliseconds(30000));
     
@@ -165,7 +193,7 @@ public:
      * @return True if actively collecting
      */
     bool is_active() const {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::lock_guard<std::mutex> lock(mutex_);
         return is_active_;
     }
     
@@ -174,7 +202,7 @@ public:
      * @return Number of items collected
      */
     size_t count() const {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::lock_guard<std::mutex> lock(mutex_);
         return collected_items_.size();
     }
     
@@ -182,11 +210,42 @@ public:
      * @brief Clear collected items
      */
     void clear() {
-        std::unique_lock<std::shared_mutex> lock(mutex_);
+        std::lock_guard<std::mutex> lock(mutex_);
         collected_items_.clear();
     }
 };
 
+class MiddlewareChain;
+
+/**
+ * @brief Continuation handed to a middleware
+ *
+ * Calling it runs the rest of the chain and then the event handlers. It
+ * only refers to the chain being executed, so copying or calling it
+ * never allocates; it must not be kept after process() returns.
+ */
+class MiddlewareNext {
+private:
+    const MiddlewareChain* chain_;
+    size_t index_;
+    const std::string* event_name_;
+    const nlohmann::json* event_data_;
+    void* handler_;
+    void (*invoke_handler_)(void*);
+
+public:
+    MiddlewareNext(const MiddlewareChain* chain, size_t index,
+                   const std::string& event_name, const nlohmann::json& event_data,
+                   void* handler, void (*invoke_handler)(void*))
+        : chain_(chain), index_(index), event_name_(&event_name), event_data_(&event_data)
+        , handler_(handler), invoke_handler_(invoke_handler) {}
+
+    /**
+     * @brief Run the next middleware, or the handlers after the last one
+     */
+    void operator()() const;
+};
+
 /**
  * @brief Event middleware interface
  */
@@ -203,7 +262,7 @@ public:
      */
     virtual bool process(const std::string& event_name, 
                       const nlohmann::json& event_data, 
-                      std::function<void()> next) = 0;
+                      MiddlewareNext next) = 0;
     
     /**
      * @brief Get middleware priority
@@ -218,6 +277,202 @@ public:
     virtual std::string get_name() const = 0;
 };
 
+/**
+ * @brief Immutable, priority-ordered middleware chain
+ *
+ * Built once whenever middleware is added or removed. Running it walks
+ * the list by index through MiddlewareNext, so an event passes through
+ * the chain without building closures or allocating.
+ */
+class MiddlewareChain {
+public:
+    using MiddlewareList = std::vector<std::shared_ptr<IEventMiddleware>>;
+
+private:
+    MiddlewareList middleware_;
+
+public:
+    /**
+     * @brief Construct an empty chain
+     */
+    MiddlewareChain() = default;
+
+    /**
+     * @brief Construct MiddlewareChain
+     * @param middleware Middleware in any order; sorted by priority (higher first)
+     */
+    explicit MiddlewareChain(MiddlewareList middleware);
+
+    /**
+     * @brief Run an event through the chain
+     * @param event_name Event name
+     * @param event_data Event data
+     * @param final_handler Called if every middleware passes the event on
+     */
+    template<typename Handler>
+    void run(const std::string& event_name, const nlohmann::json& event_data, Handler& final_handler) const {
+        MiddlewareNext start(this, 0, event_name, event_data,
+                             const_cast<void*>(static_cast<const void*>(&final_handler)),
+                             [](void* handler) { (*static_cast<Handler*>(handler))(); });
+        start();
+    }
+
+    /**
+     * @brief Get middleware at a position
+     * @param index Position in priority order
+     * @return Middleware
+     */
+    IEventMiddleware& at(size_t index) const { return *middleware_[index]; }
+
+    /**
+     * @brief Get number of middleware
+     * @return Chain length
+     */
+    size_t size() const { return middleware_.size(); }
+
+    /**
+     * @brief Check whether the chain is empty
+     * @return True if there is no middleware
+     */
+    bool empty() const { return middleware_.empty(); }
+
+    /**
+     * @brief Get the middleware in priority order
+     * @return Middleware list
+     */
+    const MiddlewareList& get_middleware() const { return middleware_; }
+};
+
+/**
+ * @brief Handlers of one event type that take a decoded struct
+ *
+ * Type-erased so the dispatcher can keep one list per EventType. The
+ * event is decoded once per dispatch, for all handlers of the list, and
+ * only if the list exists.
+ */
+class ITypedHandlerList {
+public:
+    virtual ~ITypedHandlerList() = default;
+
+    /**
+     * @brief Decode event data and run the handlers
+     * @param event_data The payload's "d" object
+     * @param fired_once Receives IDs of once-handlers that ran
+     * @return Number of handlers executed
+     */
+    virtual size_t dispatch(const nlohmann::json& event_data, std::vector<std::string>& fired_once) const = 0;
+
+    /**
+     * @brief Decode a raw gateway frame and run the handlers
+     * @param frame Gateway payload text
+     * @param fired_once Receives IDs of once-handlers that ran
+     * @return Number of handlers executed
+     */
+    virtual size_t dispatch_frame(std::string_view frame, std::vector<std::string>& fired_once) const = 0;
+
+    /**
+     * @brief Copy the list without some handlers
+     * @param handler_ids IDs to leave out
+     * @return New list, or nullptr if no handler is left
+     */
+    virtual std::shared_ptr<const ITypedHandlerList> without(const std::vector<std::string>& handler_ids) const = 0;
+
+    /**
+     * @brief Check whether a handler is in the list
+     * @param handler_id Handler ID
+     * @return True if present
+     */
+    virtual bool contains(const std::string& handler_id) const = 0;
+
+    /**
+     * @brief Get number of handlers
+     * @return Handler count
+     */
+    virtual size_t size() const = 0;
+
+protected:
+    /**
+     * @brief Log an exception thrown by a typed handler
+     * @param type Event type
+     * @param error Exception
+     */
+    static void report_error(EventType type, const std::exception& error);
+};
+
+/**
+ * @brief Handlers of one event struct, sorted by priority
+ * @tparam Event Struct from typed_events.h
+ */
+template<typename Event>
+class TypedHandlerList : public ITypedHandlerList {
+public:
+    using Callback = std::function<void(const Event&)>;
+
+    struct Handler {
+        Callback callback;
+        int priority;
+        std::string id;
+        bool once;
+    };
+
+private:
+    std::vector<Handler> handlers_;
+
+    size_t run(const Event& event, std::vector<std::string>& fired_once) const {
+        size_t executed = 0;
+        for (const auto& handler : handlers_) {
+            try {
+                handler.callback(event);
+                executed++;
+                if (handler.once) {
+                    fired_once.push_back(handler.id);
+                }
+            } catch (const std::exception& e) {
+                report_error(Event::TYPE, e);
+            }
+        }
+        return executed;
+    }
+
+public:
+    /**
+     * @brief Add a handler, keeping higher priorities first
+     * @param handler Handler to add
+     */
+    void add(Handler handler) {
+        auto position = std::find_if(handlers_.begin(), handlers_.end(),
+            [&handler](const Handler& existing) { return existing.priority < handler.priority; });
+        handlers_.insert(position, std::move(handler));
+    }
+
+    size_t dispatch(const nlohmann::json& event_data, std::vector<std::string>& fired_once) const override {
+        Event event;
+        return decode_event_data(event_data, event) ? run(event, fired_once) : 0;
+    }
+
+    size_t dispatch_frame(std::string_view frame, std::vector<std::string>& fired_once) const override {
+        Event event;
+        return decode_event(frame, event) ? run(event, fired_once) : 0;
+    }
+
+    std::shared_ptr<const ITypedHandlerList> without(const std::vector<std::string>& handler_ids) const override {
+        auto list = std::make_shared<TypedHandlerList<Event>>();
+        for (const auto& handler : handlers_) {
+            if (std::find(handler_ids.begin(), handler_ids.end(), handler.id) == handler_ids.end()) {
+                list->handlers_.push_back(handler);
+            }
+        }
+        return list->handlers_.empty() ? nullptr : list;
+    }
+
+    bool contains(const std::string& handler_id) const override {
+        return std::any_of(handlers_.begin(), handlers_.end(),
+            [&handler_id](const Handler& handler) { return handler.id == handler_id; });
+    }
+
+    size_t size() const override { return handlers_.size(); }
+};
+
 /**
  * @brief Comprehensive Event Dispatcher for Discord.cpp
  * 
@@ -228,23 +483,33 @@ public:
  */
 class EventDispatcher {
 public:
-    using EventMap = std::unordered_map<std::string, std::vector<EventHandlerInfo>>;
-    using MiddlewareList = std::vector<std::shared_ptr<IEventMiddleware>>;
+    using HandlerList = std::vector<EventHandlerInfo>;
+    using HandlerSnapshot = std::shared_ptr<const HandlerList>;
+    using EventMap = std::unordered_map<std::string, HandlerSnapshot>;
+    using MiddlewareList = MiddlewareChain::MiddlewareList;
 
 private:
-    EventMap handlers_;
-    MiddlewareList middleware_;
-    mutable std::shared_mutex handlers_mutex_;
-    mutable std::shared_mutex middleware_mutex_;
+    // Handler lists are immutable snapshots: emit() loads one without locking
+    // or copying, and registration publishes an edited copy.
+    std::array<std::atomic<HandlerSnapshot>, EVENT_TYPE_COUNT> handlers_; // Indexed by EventType
+    std::atomic<std::shared_ptr<const EventMap>> custom_handlers_;        // Events without an EventType
+    std::array<std::atomic<std::shared_ptr<const ITypedHandlerList>>, EVENT_TYPE_COUNT> typed_handlers_; // on<Event>() handlers
+    std::atomic<std::shared_ptr<const MiddlewareChain>> middleware_; // Rebuilt when middleware changes
+    std::mutex handlers_mutex_;   // Serializes handler list writers
+    std::mutex middleware_mutex_; // Serializes middleware writers
+    
+    // Async dispatch; null while handlers run on the emitting thread
+    std::atomic<std::shared_ptr<KeyedExecutor>> executor_;
+    std::atomic<DispatchOrdering> ordering_{DispatchOrdering::GUILD};
     
     // Performance tracking
     std::atomic<uint64_t> events_dispatched_{0};
     std::atomic<uint64_t> handlers_executed_{0};
+    std::atomic<uint64_t> next_handler_id_{0};
     std::chrono::steady_clock::time_point start_time_;
     
-    // Active collectors tracking
-    std::unordered_map<std::string, std::shared_ptr<void>> active_collectors_;
-    mutable std::shared_mutex collectors_mutex_;
+    // Collectors and wait_for() calls, by event type and key
+    WaiterIndex waiters_;
 
     /**
      * @brief Sort handlers by priority
@@ -253,14 +518,55 @@ private:
     void sort_handlers(std::vector<EventHandlerInfo>& handlers) const;
 
     /**
-     * @brief Execute middleware chain
+     * @brief Get the current handler snapshot of an event
+     * @param type Event type
+     * @param event_name Event name, used when type is EventType::UNKNOWN
+     * @return Snapshot, or nullptr if the event has no handlers
+     */
+    HandlerSnapshot load_handlers(EventType type, const std::string& event_name) const;
+
+    /**
+     * @brief Publish an edited copy of an event's handler list (handlers_mutex_ held)
+     * @param type Event type
+     * @param event_name Event name, used when type is EventType::UNKNOWN
+     * @param edit Edits the copy; returns false to keep the current list
+     * @return True if a new list was published
+     */
+    bool update_handlers(EventType type, const std::string& event_name,
+                         const std::function<bool(HandlerList&)>& edit);
+
+    /**
+     * @brief Remove handlers from a typed handler list (handlers_mutex_ held)
+     * @param type Event type
+     * @param handler_ids IDs to remove
+     * @return True if any handler was removed
+     */
+    bool remove_typed_handlers(EventType type, const std::vector<std::string>& handler_ids);
+
+    /**
+     * @brief Run an event now, or queue it on its key when dispatch is async
+     * @param type Event type
+     * @param event_name Event name
+     * @param event_data Event data
+     */
+    void dispatch(EventType type, const std::string& event_name, const nlohmann::json& event_data);
+
+    /**
+     * @brief Run the middleware chain and handlers of an event on this thread
+     * @param type Event type
      * @param event_name Event name
      * @param event_data Event data
-     * @param final_handler Final handler to execute
      */
-    void execute_middleware_chain(const std::string& event_name,
-                               const nlohmann::json& event_data,
-                               std::function<void()> final_handler);
+    void dispatch_now(EventType type, const std::string& event_name, const nlohmann::json& event_data);
+
+    /**
+     * @brief Get the key an event is ordered by
+     * @param type Event type
+     * @param event_data Event data
+     * @param ordering Ordering mode
+     * @return Guild or channel snowflake, or 0 for events with neither
+     */
+    static uint64_t ordering_key(EventType type, const nlohmann::json& event_data, DispatchOrdering ordering);
 
     /**
      * @brief Update performance statistics
@@ -274,7 +580,7 @@ public:
     EventDispatcher();
 
     /**
-     * @brief Destructor - cleans up all handlers
+     * @brief Destructor - waits for every queued event, then cleans up all handlers
      */
     ~EventDispatcher();
 
@@ -293,9 +599,61 @@ public:
                    const std::string& handler_id = "",
                    bool once = false);
 
+    /**
+     * @brief Register event handler for a known event type
+     * @param type Event type
+     * @param callback Handler function
+     * @param priority Handler priority (higher = earlier)
+     * @param handler_id Unique handler identifier
+     * @param once Whether to remove after first execution
+     * @return Handler ID for removal
+     */
+    std::string on(EventType type,
+                   EventCallback callback,
+                   int priority = 0,
+                   const std::string& handler_id = "",
+                   bool once = false);
+
+    /**
+     * @brief Register a handler that receives a decoded event struct
+     *
+     * The event is decoded once per dispatch for all handlers of the
+     * struct, and only while such handlers exist. Typed handlers run after
+     * the middleware and before the JSON handlers of the same event.
+     *
+     * @tparam Event Event struct, e.g. MessageCreateEvent
+     * @param callback Handler function
+     * @param priority Handler priority (higher = earlier)
+     * @param handler_id Unique handler identifier
+     * @param once Whether to remove after first execution
+     * @return Handler ID for removal with off()
+     */
+    template<typename Event>
+    std::string on(std::function<void(const Event&)> callback,
+                   int priority = 0,
+                   const std::string& handler_id = "",
+                   bool once = false) {
+        std::string final_handler_id = handler_id;
+        if (final_handler_id.empty()) {
+            final_handler_id = "handler_" + std::to_string(++next_handler_id_);
+        }
+
+        std::lock_guard<std::mutex> lock(handlers_mutex_);
+
+        // A slot only ever holds the list of its own event struct
+        auto& slot = typed_handlers_[static_cast<size_t>(Event::TYPE)];
+        auto current = std::static_pointer_cast<const TypedHandlerList<Event>>(slot.load(std::memory_order_acquire));
+        auto list = current ? std::make_shared<TypedHandlerList<Event>>(*current)
+                            : std::make_shared<TypedHandlerList<Event>>();
+        list->add({std::move(callback), priority, final_handler_id, once});
+        slot.store(std::move(list), std::memory_order_release);
+
+        return final_handler_id;
+    }
+
     /**
      * @brief Remove event handler
-     * @param event_name Event name
+     * @param event_name Event name (empty searches every event)
      * @param handler_id Handler ID to remove
      * @return True if handler was removed
      */
@@ -315,6 +673,13 @@ public:
      */
     void emit(const std::string& event_name, const nlohmann::json& event_data);
 
+    /**
+     * @brief Emit a known event type to all handlers
+     * @param type Event type
+     * @param event_data Event data
+     */
+    void emit(EventType type, const nlohmann::json& event_data);
+
     /**
      * @brief Emit event with filters
      * @param event_name Event name
@@ -327,14 +692,22 @@ public:
 
     /**
      * @brief Wait for specific event
+     *
+     * With a key, only events carrying that ID are offered to the filter,
+     * e.g. WaitKey::MESSAGE for the buttons of one message.
+     *
      * @param event_name Event name to wait for
      * @param filter Filter function
      * @param timeout Maximum wait time
+     * @param key Field to key on
+     * @param key_id ID the field must have
      * @return Matching event data or empty optional
      */
     std::optional<nlohmann::json> wait_for(const std::string& event_name,
                                            EventFilter filter = nullptr,
-                                           std::chrono::milliseconds timeout = std::chrono::milliseconds(30000));
+                                           std::chrono::milliseconds timeout = std::chrono::milliseconds(30000),
+                                           WaitKey key = WaitKey::NONE,
+                                           Snowflake key_id = 0);
 
     /**
      * @brief Create event collector
@@ -347,7 +720,31 @@ public:
     template<typename T>
     std::shared_ptr<EventCollector<T>> create_collector(const std::string& event_name,
                                                     typename EventCollector<T>::FilterFunction filter = nullptr,
-                                                    const CollectorConfig& config = CollectorConfig{});
+                                                    const CollectorConfig& config = CollectorConfig{}) {
+        auto collector = std::make_shared<EventCollector<T>>(std::move(filter), config);
+        collector->start(this, event_name);
+        return collector;
+    }
+
+    /**
+     * @brief Register a waiter for events of a name and key
+     * @param event_name Event name
+     * @param key Field to key on
+     * @param key_id ID the field must have
+     * @param deadline When to remove the waiter
+     * @param waiter Waiter, held weakly
+     * @return Waiter ID
+     */
+    WaiterIndex::WaiterId add_waiter(const std::string& event_name, WaitKey key, Snowflake key_id,
+                                     std::chrono::steady_clock::time_point deadline,
+                                     std::weak_ptr<IEventWaiter> waiter);
+
+    /**
+     * @brief Remove a waiter and finish it
+     * @param waiter_id Waiter ID
+     * @return True if the waiter was registered
+     */
+    bool remove_waiter(WaiterIndex::WaiterId waiter_id);
 
     /**
      * @brief Add middleware
@@ -386,6 +783,53 @@ public:
      */
     void handle_dispatch(const nlohmann::json& payload);
 
+    /**
+     * @brief Handle a raw gateway dispatch frame
+     *
+     * Reads only the event name first. An event without handlers,
+     * waiters or middleware is dropped unparsed; an event with only typed
+     * handlers is decoded straight from the frame into its struct.
+     * Anything else is parsed into JSON and goes through handle_dispatch().
+     * Gateway frames reach it through ShardManager::set_frame_callback().
+     *
+     * @param frame Gateway payload text
+     */
+    void handle_frame(std::string_view frame);
+
+    /**
+     * @brief Run handlers on a thread pool instead of the emitting thread
+     *
+     * emit() and handle_dispatch() then only copy the event data and queue
+     * it; middleware and handlers run on the pool. Events with the same
+     * ordering key run one at a time in the order they were emitted,
+     * events of different guilds (or channels) run in parallel. Handlers
+     * must therefore be thread-safe.
+     *
+     * @param pool Thread pool to run handlers on
+     * @param ordering Key that events are ordered by
+     */
+    void enable_async_dispatch(std::shared_ptr<IThreadPool> pool,
+                               DispatchOrdering ordering = DispatchOrdering::GUILD);
+
+    /**
+     * @brief Go back to running handlers on the emitting thread
+     * @param timeout Maximum time to wait for queued events to finish
+     * @return True if every queued event finished
+     */
+    bool disable_async_dispatch(std::chrono::milliseconds timeout = std::chrono::milliseconds(30000));
+
+    /**
+     * @brief Check whether handlers run on a thread pool
+     * @return True if async dispatch is enabled
+     */
+    bool is_async_dispatch() const;
+
+    /**
+     * @brief Get number of queued events not yet handled
+     * @return Queued event count (0 when dispatch is synchronous)
+     */
+    size_t get_queued_event_count() const;
+
     /**
      * @brief Get number of registered handlers
      * @return Total handler count
@@ -404,8 +848,83 @@ public:
     void clear();
 };
 
+// EventCollector template implementations
+
+template<typename T>
+WaiterIndex::WaiterId EventCollector<T>::start(EventDispatcher* dispatcher, const std::string& event_name) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (is_active_) {
+            return waiter_id_;
+        }
+        is_active_ = true;
+        dispatcher_ = dispatcher;
+    }
+    
+    auto deadline = config_.dispose_on_timeout && config_.timeout.count() > 0
+        ? std::chrono::steady_clock::now() + config_.timeout
+        : std::chrono::steady_clock::time_point::max();
+    
+    // A stop() racing with this only marks the collector inactive; its next offer() then removes it
+    auto waiter_id = dispatcher->add_waiter(event_name, config_.key, config_.key_id, deadline, this->weak_from_this());
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    waiter_id_ = waiter_id;
+    return waiter_id;
+}
+
+template<typename T>
+void EventCollector<T>::stop() {
+    EventDispatcher* dispatcher;
+    WaiterIndex::WaiterId waiter_id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dispatcher = dispatcher_;
+        waiter_id = waiter_id_;
+    }
+    
+    // finish() marks the collector inactive, also when the dispatcher removed it first
+    if (!dispatcher || !dispatcher->remove_waiter(waiter_id)) {
+        finish();
+    }
+}
+
+template<typename T>
+bool EventCollector<T>::process_event(const nlohmann::json& event) {
+    T typed_event = event; // This requires T to be constructible from json
+    if (filter_ && !filter_(typed_event)) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_active_ || should_stop_collecting()) {
+        return true;
+    }
+    collected_items_.push_back(std::move(typed_event));
+    changed_.notify_all();
+    return should_stop_collecting();
+}
+
+template<typename T>
+std::optional<T> EventCollector<T>::wait_for_first(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait_for(lock, timeout, [this] { return !collected_items_.empty() || !is_active_; });
+    return collected_items_.empty() ? std::nullopt : std::optional<T>(collected_items_.front());
+}
+
+template<typename T>
+std::vector<T> EventCollector<T>::wait_for_all(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait_for(lock, timeout, [this] { return should_stop_collecting() || !is_active_; });
+    return collected_items_;
+}
+
 /**
  * @brief Built-in event filters
+ *
+ * The single-field filters are compiled FilterExpressions. To combine
+ * many conditions, build one FilterExpression and compile it, rather
+ * than chaining these with and_filter()/or_filter().
  */
 namespace EventFilters {
     /**
@@ -431,7 +950,7 @@ namespace EventFilters {
     
     /**
      * @brief Filter by message content
-     * @param content Content to match (supports wildcards)
+     * @param content Content to match ('*' matches any run of characters)
      * @return Filter function
      */
     EventFilter by_content(const std::string& content);
@@ -484,7 +1003,7 @@ namespace EventMiddleware {
         
         bool process(const std::string& event_name,
                    const nlohmann::json& event_data,
-                   std::function<void()> next) override;
+                   MiddlewareNext next) override;
         
         int get_priority() const override { return 100; }
         std::string get_name() const override { return "RateLimiter"; }
@@ -503,7 +1022,7 @@ namespace EventMiddleware {
         
         bool process(const std::string& event_name,
                    const nlohmann::json& event_data,
-                   std::function<void()> next) override;
+                   MiddlewareNext next) override;
         
         int get_priority() const override { return -100; }
         std::string get_name() const override { return "Logger"; }
@@ -521,11 +1040,40 @@ namespace EventMiddleware {
         
         bool process(const std::string& event_name,
                    const nlohmann::json& event_data,
-                   std::function<void()> next) override;
+                   MiddlewareNext next) override;
         
         int get_priority() const override { return 50; }
         std::string get_name() const override { return "Validator"; }
     };
+    
+    /**
+     * @brief Stops MESSAGE_CREATE and MESSAGE_UPDATE events whose content matches a pattern set
+     */
+    class ContentFilter : public IEventMiddleware {
+    public:
+        using MatchCallback = std::function<void(const std::string& event_name,
+                                                 const nlohmann::json& event_data,
+                                                 const std::vector<size_t>& pattern_ids)>;
+        
+    private:
+        ContentMatcher matcher_;
+        MatchCallback on_match_;
+        
+    public:
+        /**
+         * @brief Construct ContentFilter
+         * @param matcher Compiled pattern set
+         * @param on_match Called with the matching pattern IDs before the event is stopped
+         */
+        explicit ContentFilter(ContentMatcher matcher, MatchCallback on_match = nullptr);
+        
+        bool process(const std::string& event_name,
+                   const nlohmann::json& event_data,
+                   MiddlewareNext next) override;
+        
+        int get_priority() const override { return 75; }
+        std::string get_name() const override { return "ContentFilter"; }
+    };
 }
 
 } // namespace discord
\ No newline at end of file
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "content_matcher.h"
+#include "../utils/types.h"
+
+namespace discord {
+
+class CompiledFilter;
+
+/**
+ * @brief Declarative event filter, compiled once into a CompiledFilter
+ *
+ * Field paths are dot-separated keys into the event data, e.g.
+ * "author.id" or "member.user.id". Expressions are immutable and cheap
+ * to copy; combine them with &&, || and !.
+ */
+class FilterExpression {
+public:
+    struct Node;
+
+private:
+    std::shared_ptr<const Node> node_;
+
+    explicit FilterExpression(std::shared_ptr<const Node> node);
+
+public:
+    /**
+     * @brief Match a snowflake field
+     * @param path Field path
+     * @param id ID to match (string and integer fields both compare as integers)
+     * @return Expression
+     */
+    static FilterExpression snowflake(std::string_view path, Snowflake id);
+
+    /**
+     * @brief Match a snowflake field against a set of IDs
+     * @param path Field path
+     * @param ids IDs to match
+     * @return Expression
+     */
+    static FilterExpression snowflake_in(std::string_view path, std::vector<Snowflake> ids);
+
+    /**
+     * @brief Match a string field exactly
+     * @param path Field path
+     * @param value Value to match
+     * @return Expression
+     */
+    static FilterExpression equals(std::string_view path, std::string value);
+
+    /**
+     * @brief Match a boolean field
+     * @param path Field path
+     * @param value Value to match
+     * @return Expression
+     */
+    static FilterExpression flag(std::string_view path, bool value);
+
+    /**
+     * @brief Match a string field against a glob where '*' is any run of characters
+     * @param path Field path
+     * @param pattern Glob pattern, anchored at both ends
+     * @return Expression
+     */
+    static FilterExpression glob(std::string_view path, const std::string& pattern);
+
+    /**
+     * @brief Search a string field for a regular expression
+     * @param path Field path
+     * @param pattern ECMAScript pattern, compiled once
+     * @return Expression
+     * @throws std::regex_error if the pattern is invalid
+     */
+    static FilterExpression regex(std::string_view path, const std::string& pattern);
+
+    /**
+     * @brief Match a string field containing any pattern of a content matcher
+     * @param path Field path
+     * @param matcher Compiled pattern set
+     * @return Expression
+     */
+    static FilterExpression contains_any(std::string_view path, ContentMatcher matcher);
+
+    /**
+     * @brief Match when a field is present and not null
+     * @param path Field path
+     * @return Expression
+     */
+    static FilterExpression exists(std::string_view path);
+
+    /**
+     * @brief Match when every expression matches (true when empty)
+     * @param expressions Expressions to combine
+     * @return Expression
+     */
+    static FilterExpression all_of(std::vector<FilterExpression> expressions);
+
+    /**
+     * @brief Match when any expression matches (false when empty)
+     * @param expressions Expressions to combine
+     * @return Expression
+     */
+    static FilterExpression any_of(std::vector<FilterExpression> expressions);
+
+    FilterExpression operator&&(const FilterExpression& other) const;
+    FilterExpression operator||(const FilterExpression& other) const;
+    FilterExpression operator!() const;
+
+    /**
+     * @brief Compile into a flat predicate program
+     * @return Compiled filter
+     */
+    CompiledFilter compile() const;
+
+    friend class CompiledFilter;
+};
+
+/**
+ * @brief Flat, branching predicate program built from a FilterExpression
+ *
+ * Each instruction tests one field and jumps to the next instruction on
+ * success or failure, so AND/OR/NOT short-circuit without recursion or
+ * virtual calls. Children of AND and OR are ordered by estimated cost
+ * and selectivity, cheap integer compares before regexes. Each field is
+ * looked up at most once per event, and only when an instruction on the
+ * taken path reads it. Copies share the compiled program.
+ */
+class CompiledFilter {
+public:
+    struct Program;
+
+private:
+    std::shared_ptr<const Program> program_;
+
+    explicit CompiledFilter(std::shared_ptr<const Program> program);
+
+public:
+    /**
+     * @brief Construct a filter that matches every event
+     */
+    CompiledFilter() = default;
+
+    /**
+     * @brief Evaluate against event data
+     * @param event_data Event data
+     * @return True if the event matches
+     */
+    bool matches(const nlohmann::json& event_data) const;
+
+    /**
+     * @brief Evaluate against event data, so the filter can be used as an EventFilter
+     * @param event_data Event data
+     * @return True if the event matches
+     */
+    bool operator()(const nlohmann::json& event_data) const { return matches(event_data); }
+
+    /**
+     * @brief Get number of instructions in the program
+     * @return Instruction count
+     */
+    size_t instruction_count() const;
+
+    friend class FilterExpression;
+};
+
+} // namespace discord
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "event_types.h"
+
+namespace discord {
+
+class EventDispatcher;
+
+/**
+ * @brief What the ingestion queue does with an event type under load
+ */
+enum class ShedPolicy : uint8_t {
+    SHED_EARLY,     // Dropped once the queue reaches its shed depth
+    SHED_WHEN_FULL, // Dropped once only the reserved slots are left
+    NEVER_SHED      // Never dropped; overflows into an unbounded side queue
+};
+
+/**
+ * @brief Event ingestion queue configuration
+ */
+struct IngestQueueConfig {
+    size_t capacity;       // Ring slots, rounded up to a power of two
+    size_t shed_depth;     // Depth at which SHED_EARLY events are dropped (0 for half the capacity)
+    size_t reserved_slots; // Slots only NEVER_SHED events may take (0 for 1/16 of the capacity)
+    size_t consumers;      // Threads feeding the dispatcher; 1 keeps gateway order
+
+    IngestQueueConfig(size_t cap = 4096, size_t shed = 0, size_t reserved = 0, size_t threads = 1)
+        : capacity(cap), shed_depth(shed), reserved_slots(reserved), consumers(threads) {}
+};
+
+/**
+ * @brief Bounded buffer between gateway clients and an EventDispatcher
+ *
+ * Gateway callbacks push dispatch payloads and return at once; consumer
+ * threads hand them to EventDispatcher::handle_dispatch(). A burst thus
+ * never holds up the socket reader, which must keep reading heartbeat
+ * ACKs. The ring is a lock-free multi-producer multi-consumer array
+ * (one sequence number per slot), so shards push without contending on
+ * a lock.
+ *
+ * When handlers fall behind the queue sheds load by event type instead
+ * of growing: SHED_EARLY types (TYPING_START and PRESENCE_UPDATE by
+ * default) go first, at the shed depth; SHED_WHEN_FULL types when only
+ * the reserved slots are left; NEVER_SHED types (INTERACTION_CREATE,
+ * READY and RESUMED by default) take the reserved slots and, past those,
+ * an unbounded side queue. Every event takes an arrival ticket and
+ * consumers pop whichever of the ring and side queue heads is older, so
+ * with one consumer each shard's events keep their gateway order.
+ *
+ * Nothing feeds the queue on its own; forward gateway events to it:
+ * shard_manager.set_event_callback([&queue](int, const nlohmann::json& payload) { queue.push(payload); });
+ */
+class EventIngestQueue {
+private:
+    struct Entry {
+        EventType type = EventType::UNKNOWN;
+        nlohmann::json payload;
+        uint64_t ticket = 0; // Arrival order across the ring and the side queue
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence;
+        std::atomic<uint64_t> ticket; // Copy of entry.ticket, peeked without taking the entry
+        Entry entry;
+    };
+
+    // Ring
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    size_t shed_depth_;
+    size_t full_depth_; // Depth at which SHED_WHEN_FULL events are dropped
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+
+    // NEVER_SHED events that found the ring full
+    std::mutex overflow_mutex_;
+    std::deque<Entry> overflow_;
+    std::atomic<size_t> overflow_size_{0};
+    std::atomic<uint64_t> next_ticket_{0};
+
+    std::array<std::atomic<ShedPolicy>, EVENT_TYPE_COUNT + 1> policies_; // Indexed by EventType
+
+    // Consumers
+    EventDispatcher* dispatcher_ = nullptr;
+    std::vector<std::thread> consumers_;
+    size_t consumer_count_;
+    std::atomic<bool> running_{false};
+    std::mutex wait_mutex_;
+    std::condition_variable not_empty_;
+    std::atomic<uint32_t> sleepers_{0};
+
+    // Metrics
+    std::atomic<uint64_t> enqueued_{0};
+    std::atomic<uint64_t> dispatched_{0};
+    std::atomic<uint64_t> overflowed_{0};
+    std::atomic<size_t> peak_depth_{0};
+    mutable std::array<std::atomic<uint64_t>, EVENT_TYPE_COUNT + 1> dropped_{};
+
+    /**
+     * @brief Check the queue depth against an event's policy, counting a drop if it is shed
+     * @param type Event type
+     * @return True if the event may be queued
+     */
+    bool admit(EventType type) const;
+
+    /**
+     * @brief Put an admitted entry into the ring, or the side queue for NEVER_SHED events
+     * @param entry Entry to queue
+     * @return True if queued
+     */
+    bool enqueue(Entry& entry);
+
+    /**
+     * @brief Take the older of the ring and side queue heads
+     * @param out Receives the entry
+     * @return True if an entry was taken
+     */
+    bool try_pop(Entry& out);
+
+    /**
+     * @brief Wake a sleeping consumer after a push
+     */
+    void notify_consumer();
+
+    /**
+     * @brief Consumer thread body
+     */
+    void consumer_loop();
+
+public:
+    /**
+     * @brief Construct EventIngestQueue
+     * @param config Queue configuration
+     */
+    explicit EventIngestQueue(const IngestQueueConfig& config = IngestQueueConfig());
+
+    /**
+     * @brief Destructor; stops the consumers
+     */
+    ~EventIngestQueue();
+
+    EventIngestQueue(const EventIngestQueue&) = delete;
+    EventIngestQueue& operator=(const EventIngestQueue&) = delete;
+
+    /**
+     * @brief Queue a gateway payload (any thread)
+     *
+     * Payloads other than dispatches are ignored; the gateway client has
+     * already acted on them.
+     *
+     * @param payload Gateway payload
+     * @return True if queued, false if ignored or shed
+     */
+    bool push(const nlohmann::json& payload);
+
+    /**
+     * @brief Queue a gateway payload without copying it (any thread)
+     * @param payload Gateway payload
+     * @return True if queued, false if ignored or shed
+     */
+    bool push(nlohmann::json&& payload);
+
+    /**
+     * @brief Set the shedding policy of an event type
+     * @param type Event type (EventType::UNKNOWN for events without one)
+     * @param policy Shedding policy
+     */
+    void set_policy(EventType type, ShedPolicy policy);
+
+    /**
+     * @brief Get the shedding policy of an event type
+     * @param type Event type
+     * @return Shedding policy
+     */
+    ShedPolicy get_policy(EventType type) const;
+
+    /**
+     * @brief Start feeding a dispatcher
+     * @param dispatcher Dispatcher to hand events to; must outlive the consumers
+     * @return False if already started
+     */
+    bool start(EventDispatcher& dispatcher);
+
+    /**
+     * @brief Dispatch what is queued, then stop the consumers
+     */
+    void stop();
+
+    /**
+     * @brief Check whether consumers are running
+     * @return True if started
+     */
+    bool is_running() const;
+
+    /**
+     * @brief Get number of queued events (any thread)
+     * @return Approximate queue depth, side queue included
+     */
+    size_t depth() const;
+
+    /**
+     * @brief Get number of ring slots
+     * @return Capacity
+     */
+    size_t capacity() const { return mask_ + 1; }
+
+    /**
+     * @brief Check whether SHED_EARLY events are being dropped
+     * @return True if the queue is at or past its shed depth
+     */
+    bool is_under_pressure() const;
+
+    /**
+     * @brief Get number of dropped events of a type
+     * @param type Event type
+     * @return Dropped count
+     */
+    uint64_t get_dropped_count(EventType type) const;
+
+    /**
+     * @brief Get number of dropped events
+     * @return Dropped count over all types
+     */
+    uint64_t get_dropped_count() const;
+
+    /**
+     * @brief Get queue statistics
+     * @return Depth, peak depth, enqueued, dispatched, overflowed and dropped counts
+     */
+    nlohmann::json get_statistics() const;
+
+    /**
+     * @brief Reset counters and the peak depth
+     */
+    void reset_statistics();
+};
+
+} // namespace discord
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace discord {
+
+/**
+ * @brief Dense IDs of the gateway dispatch events known to the library
+ *
+ * The values index flat tables, so they start at 0 and have no gaps.
+ * Event names the table does not know map to UNKNOWN and are handled by
+ * name instead.
+ */
+enum class EventType : uint16_t {
+    READY,
+    RESUMED,
+    APPLICATION_COMMAND_PERMISSIONS_UPDATE,
+    AUTO_MODERATION_RULE_CREATE,
+    AUTO_MODERATION_RULE_UPDATE,
+    AUTO_MODERATION_RULE_DELETE,
+    AUTO_MODERATION_ACTION_EXECUTION,
+    CHANNEL_CREATE,
+    CHANNEL_UPDATE,
+    CHANNEL_DELETE,
+    CHANNEL_PINS_UPDATE,
+    THREAD_CREATE,
+    THREAD_UPDATE,
+    THREAD_DELETE,
+    THREAD_LIST_SYNC,
+    THREAD_MEMBER_UPDATE,
+    THREAD_MEMBERS_UPDATE,
+    ENTITLEMENT_CREATE,
+    ENTITLEMENT_UPDATE,
+    ENTITLEMENT_DELETE,
+    GUILD_CREATE,
+    GUILD_UPDATE,
+    GUILD_DELETE,
+    GUILD_AUDIT_LOG_ENTRY_CREATE,
+    GUILD_BAN_ADD,
+    GUILD_BAN_REMOVE,
+    GUILD_EMOJIS_UPDATE,
+    GUILD_STICKERS_UPDATE,
+    GUILD_INTEGRATIONS_UPDATE,
+    GUILD_MEMBER_ADD,
+    GUILD_MEMBER_REMOVE,
+    GUILD_MEMBER_UPDATE,
+    GUILD_MEMBERS_CHUNK,
+    GUILD_ROLE_CREATE,
+    GUILD_ROLE_UPDATE,
+    GUILD_ROLE_DELETE,
+    GUILD_SCHEDULED_EVENT_CREATE,
+    GUILD_SCHEDULED_EVENT_UPDATE,
+    GUILD_SCHEDULED_EVENT_DELETE,
+    GUILD_SCHEDULED_EVENT_USER_ADD,
+    GUILD_SCHEDULED_EVENT_USER_REMOVE,
+    GUILD_SOUNDBOARD_SOUND_CREATE,
+    GUILD_SOUNDBOARD_SOUND_UPDATE,
+    GUILD_SOUNDBOARD_SOUND_DELETE,
+    GUILD_SOUNDBOARD_SOUNDS_UPDATE,
+    SOUNDBOARD_SOUNDS,
+    INTEGRATION_CREATE,
+    INTEGRATION_UPDATE,
+    INTEGRATION_DELETE,
+    INTERACTION_CREATE,
+    INVITE_CREATE,
+    INVITE_DELETE,
+    MESSAGE_CREATE,
+    MESSAGE_UPDATE,
+    MESSAGE_DELETE,
+    MESSAGE_DELETE_BULK,
+    MESSAGE_REACTION_ADD,
+    MESSAGE_REACTION_REMOVE,
+    MESSAGE_REACTION_REMOVE_ALL,
+    MESSAGE_REACTION_REMOVE_EMOJI,
+    MESSAGE_POLL_VOTE_ADD,
+    MESSAGE_POLL_VOTE_REMOVE,
+    PRESENCE_UPDATE,
+    STAGE_INSTANCE_CREATE,
+    STAGE_INSTANCE_UPDATE,
+    STAGE_INSTANCE_DELETE,
+    SUBSCRIPTION_CREATE,
+    SUBSCRIPTION_UPDATE,
+    SUBSCRIPTION_DELETE,
+    TYPING_START,
+    USER_UPDATE,
+    VOICE_CHANNEL_EFFECT_SEND,
+    VOICE_STATE_UPDATE,
+    VOICE_SERVER_UPDATE,
+    WEBHOOKS_UPDATE,
+    UNKNOWN // Not a table index; also the number of known types
+};
+
+/**
+ * @brief Number of known event types
+ */
+inline constexpr size_t EVENT_TYPE_COUNT = static_cast<size_t>(EventType::UNKNOWN);
+
+/**
+ * @brief Get the ID of a gateway event name
+ *
+ * Looks the name up in a collision-free hash table built at compile
+ * time: one hash of the name and one comparison, no allocation.
+ *
+ * @param name Event name as sent in the "t" field
+ * @return Event type, or EventType::UNKNOWN
+ */
+EventType event_type_from_name(std::string_view name);
+
+/**
+ * @brief Get the gateway name of an event type
+ * @param type Event type
+ * @return Event name, or an empty string for EventType::UNKNOWN
+ */
+const std::string& event_type_name(EventType type);
+
+} // namespace discord
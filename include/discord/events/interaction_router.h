@@ -0,0 +1,261 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "../utils/types.h"
+
+namespace discord {
+
+class EventDispatcher;
+
+/**
+ * @brief Parameters captured from a custom_id by its route
+ *
+ * Values are views into the interaction's custom_id and are only valid
+ * during the handler call.
+ */
+class RouteParams {
+public:
+    static constexpr size_t MAX_PARAMS = 8;
+
+private:
+    std::array<std::string_view, MAX_PARAMS> names_{};
+    std::array<std::string_view, MAX_PARAMS> values_{};
+    size_t count_ = 0;
+
+public:
+    /**
+     * @brief Get a parameter
+     * @param name Parameter name, or "*" for the rest of a prefix route
+     * @return Value, or empty if the route has no such parameter
+     */
+    std::string_view get(std::string_view name) const;
+
+    /**
+     * @brief Get a parameter as a snowflake
+     * @param name Parameter name
+     * @return ID, or nullopt if absent or not numeric
+     */
+    std::optional<Snowflake> get_snowflake(std::string_view name) const;
+
+    /**
+     * @brief Get number of parameters
+     * @return Parameter count
+     */
+    size_t size() const { return count_; }
+
+    /**
+     * @brief Append a parameter
+     * @param name Parameter name
+     * @param value Captured value
+     */
+    void push(std::string_view name, std::string_view value);
+};
+
+/**
+ * @brief Routes custom_ids to handlers by pattern
+ *
+ * Patterns are literal text with {name} parameters, e.g.
+ * "vote:{poll_id}:{choice}", and may end in '*' to match any rest, e.g.
+ * "ticket:*". A parameter captures up to the next occurrence of the
+ * character that follows it in the pattern, or to the end of the ID.
+ * Patterns without parameters live in a hash map; the others share a
+ * character trie walked along the ID, where literal text is preferred
+ * over parameters and parameters over '*'. Lookups cost O(length of the
+ * ID) and do not depend on how many routes are registered.
+ */
+class CustomIdRouter {
+public:
+    using Handler = std::function<void(const nlohmann::json& interaction, const RouteParams& params)>;
+
+    /**
+     * @brief Registered route
+     */
+    struct Route {
+        Handler handler;
+        std::vector<std::string> param_names; // In pattern order
+    };
+
+    using RouteHandle = std::shared_ptr<const Route>;
+
+private:
+    struct ParamEdge {
+        char terminator; // '\0' when the parameter runs to the end of the ID
+        uint32_t child;
+    };
+
+    struct Node {
+        std::vector<std::pair<char, uint32_t>> children; // Sorted by character
+        std::vector<ParamEdge> params;
+        RouteHandle route;    // Pattern ending here
+        RouteHandle wildcard; // Pattern ending here in '*'
+    };
+
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+    };
+
+    std::unordered_map<std::string, RouteHandle, StringHash, std::equal_to<>> exact_;
+    std::vector<Node> nodes_{1};
+    size_t pattern_routes_ = 0;
+
+    /**
+     * @brief Find the node of a literal child, creating it if asked
+     * @return Node index, or 0 if absent and not created
+     */
+    uint32_t literal_child(uint32_t node, char c, bool create);
+
+    bool match(uint32_t node, std::string_view id, size_t position,
+               std::array<std::string_view, RouteParams::MAX_PARAMS>& values, size_t depth,
+               RouteHandle& route) const;
+
+public:
+    /**
+     * @brief Register a route, replacing one with the same pattern
+     * @param pattern Route pattern
+     * @param handler Handler function
+     * @throws std::invalid_argument if the pattern is malformed or captures more
+     *         than RouteParams::MAX_PARAMS values ('*' counts as one)
+     */
+    void add(const std::string& pattern, Handler handler);
+
+    /**
+     * @brief Remove a route
+     * @param pattern Route pattern as registered
+     * @return True if the route existed
+     */
+    bool remove(const std::string& pattern);
+
+    /**
+     * @brief Find the route of a custom_id
+     * @param custom_id Custom ID
+     * @param params Receives the captured parameters
+     * @return Route, or nullptr if none matches
+     */
+    RouteHandle find(std::string_view custom_id, RouteParams& params) const;
+
+    /**
+     * @brief Get number of routes
+     * @return Route count
+     */
+    size_t size() const;
+};
+
+/**
+ * @brief Routes INTERACTION_CREATE events to handlers
+ *
+ * Application commands and autocomplete go by command name, components
+ * and modal submits by custom_id through a CustomIdRouter. Routes can be
+ * added and removed while events are routed; handlers run outside the
+ * router's lock.
+ */
+class InteractionRouter {
+public:
+    using Handler = CustomIdRouter::Handler;
+
+private:
+    std::unordered_map<std::string, CustomIdRouter::RouteHandle> commands_;
+    std::unordered_map<std::string, CustomIdRouter::RouteHandle> autocomplete_;
+    CustomIdRouter components_;
+    CustomIdRouter modals_;
+    mutable std::shared_mutex mutex_;
+
+    /**
+     * @brief Find a command route by its name path (mutex_ held)
+     * @param routes Command or autocomplete routes
+     * @param data Interaction data
+     * @return Route, or nullptr if none matches
+     */
+    static CustomIdRouter::RouteHandle find_command(
+        const std::unordered_map<std::string, CustomIdRouter::RouteHandle>& routes,
+        const nlohmann::json& data);
+
+public:
+    /**
+     * @brief Route an application command
+     * @param name Command name, optionally followed by subcommand group and subcommand, e.g. "admin ban"
+     * @param handler Handler function
+     */
+    void on_command(const std::string& name, Handler handler);
+
+    /**
+     * @brief Route autocomplete requests of a command
+     * @param name Command name path as for on_command()
+     * @param handler Handler function
+     */
+    void on_autocomplete(const std::string& name, Handler handler);
+
+    /**
+     * @brief Route message components by custom_id pattern
+     * @param pattern Custom ID pattern
+     * @param handler Handler function
+     * @throws std::invalid_argument if the pattern is malformed
+     */
+    void on_component(const std::string& pattern, Handler handler);
+
+    /**
+     * @brief Route modal submits by custom_id pattern
+     * @param pattern Custom ID pattern
+     * @param handler Handler function
+     * @throws std::invalid_argument if the pattern is malformed
+     */
+    void on_modal(const std::string& pattern, Handler handler);
+
+    /**
+     * @brief Remove a command route
+     * @param name Command name path
+     * @return True if the route existed
+     */
+    bool remove_command(const std::string& name);
+
+    /**
+     * @brief Remove a component route
+     * @param pattern Custom ID pattern
+     * @return True if the route existed
+     */
+    bool remove_component(const std::string& pattern);
+
+    /**
+     * @brief Remove a modal route
+     * @param pattern Custom ID pattern
+     * @return True if the route existed
+     */
+    bool remove_modal(const std::string& pattern);
+
+    /**
+     * @brief Route an interaction
+     * @param interaction INTERACTION_CREATE event data
+     * @return True if a handler ran
+     */
+    bool route(const nlohmann::json& interaction) const;
+
+    /**
+     * @brief Route the INTERACTION_CREATE events of a dispatcher
+     *
+     * The router must outlive the registration.
+     *
+     * @param dispatcher Event dispatcher
+     * @param priority Handler priority
+     * @return Handler ID for EventDispatcher::off()
+     */
+    std::string attach(EventDispatcher& dispatcher, int priority = 0);
+
+    /**
+     * @brief Get number of routes
+     * @return Route count over all interaction kinds
+     */
+    size_t size() const;
+};
+
+} // namespace discord
@@ -4,6 +4,7 @@
 #include <functional>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include "event_dispatcher.h"
 
@@ -28,16 +29,11 @@ public:
      */
     using MiddlewareFunction = std::function<bool(const std::string&,
                                                    const nlohmann::json&,
-                                                   std::function<void()>)>;
+                                                   MiddlewareNext)>;
 
 private:
-    std::vector<std::shared_ptr<IEventMiddleware>> middleware_;
-    mutable std::shared_mutex mutex_;
-
-    /**
-     * @brief Sort middleware by priority
-     */
-    void sort_middleware();
+    std::atomic<std::shared_ptr<const MiddlewareChain>> chain_; // Rebuilt when middleware changes
+    std::mutex mutex_;                                          // Serializes writers
 
 public:
     /**
@@ -71,7 +67,7 @@ public:
      */
     void process_event(const std::string& event_name,
                      const nlohmann::json& event_data,
-                     std::function<void()> final_handler);
+                     const std::function<void()>& final_handler);
 
     /**
      * @brief Get all middleware
@@ -106,7 +102,7 @@ namespace BuiltInMiddleware {
         
         bool process(const std::string& event_name,
                    const nlohmann::json& event_data,
-                   std::function<void()> next) override;
+                   MiddlewareNext next) override;
         
         int get_priority() const override { return 90; }
         std::string get_name() const override { return "Authentication"; }
@@ -127,7 +123,7 @@ namespace BuiltInMiddleware {
         
         bool process(const std::string& event_name,
                    const nlohmann::json& event_data,
-                   std::function<void()> next) override;
+                   MiddlewareNext next) override;
         
         int get_priority() const override { return 80; }
         std::string get_name() const override { return "PermissionChecker"; }
@@ -149,7 +145,7 @@ namespace BuiltInMiddleware {
         
         bool process(const std::string& event_name,
                    const nlohmann::json& event_data,
-                   std::function<void()> next) override;
+                   MiddlewareNext next) override;
         
         int get_priority() const override { return 60; }
         std::string get_name() const override { return "Transformer"; }
@@ -171,7 +167,7 @@ namespace BuiltInMiddleware {
         
         bool process(const std::string& event_name,
                    const nlohmann::json& event_data,
-                   std::function<void()> next) override;
+                   MiddlewareNext next) override;
         
         int get_priority() const override { return 70; }
         std::string get_name() const override { return "Filter"; }
@@ -201,7 +197,7 @@ namespace BuiltInMiddleware {
         
         bool process(const std::string& event_name,
                    const nlohmann::json& event_data,
-                   std::function<void()> next) override;
+                   MiddlewareNext next) override;
         
         int get_priority() const override { return 40; }
         std::string get_name() const override { return "Cache"; }
@@ -238,7 +234,7 @@ namespace BuiltInMiddleware {
         
         bool process(const std::string& event_name,
                    const nlohmann::json& event_data,
-                   std::function<void()> next) override;
+                   MiddlewareNext next) override;
         
         int get_priority() const override { return -50; } // Low priority to run last
         std::string get_name() const override { return "Metrics"; }
@@ -274,7 +270,7 @@ namespace BuiltInMiddleware {
         
         bool process(const std::string& event_name,
                    const nlohmann::json& event_data,
-                   std::function<void()> next) override;
+                   MiddlewareNext next) override;
         
         int get_priority() const override { return -100; } // Very low priority
         std::string get_name() const override { return "Debugger"; }
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "event_types.h"
+#include "../utils/types.h"
+
+namespace discord {
+
+/**
+ * @brief Decoded MESSAGE_CREATE event
+ */
+struct MessageCreateEvent {
+    static constexpr EventType TYPE = EventType::MESSAGE_CREATE;
+
+    Snowflake id = 0;
+    Snowflake channel_id = 0;
+    Snowflake guild_id = 0;  // 0 in DMs
+    Snowflake author_id = 0;
+    Snowflake webhook_id = 0;
+    Snowflake referenced_message_id = 0;
+    std::string author_username;
+    std::string content;
+    std::string timestamp;
+    int type = 0;
+    bool author_bot = false;
+    bool mention_everyone = false;
+    std::vector<Snowflake> mention_ids;
+    std::vector<Snowflake> mention_role_ids;
+};
+
+/**
+ * @brief Decoded MESSAGE_DELETE event
+ */
+struct MessageDeleteEvent {
+    static constexpr EventType TYPE = EventType::MESSAGE_DELETE;
+
+    Snowflake id = 0;
+    Snowflake channel_id = 0;
+    Snowflake guild_id = 0;
+};
+
+/**
+ * @brief Decoded MESSAGE_REACTION_ADD event
+ */
+struct MessageReactionAddEvent {
+    static constexpr EventType TYPE = EventType::MESSAGE_REACTION_ADD;
+
+    Snowflake user_id = 0;
+    Snowflake channel_id = 0;
+    Snowflake message_id = 0;
+    Snowflake guild_id = 0;
+    Snowflake message_author_id = 0;
+    Snowflake emoji_id = 0;     // 0 for unicode emoji
+    std::string emoji_name;
+    bool burst = false;
+};
+
+/**
+ * @brief Decoded INTERACTION_CREATE event
+ */
+struct InteractionCreateEvent {
+    static constexpr EventType TYPE = EventType::INTERACTION_CREATE;
+
+    Snowflake id = 0;
+    Snowflake application_id = 0;
+    Snowflake guild_id = 0;
+    Snowflake channel_id = 0;
+    Snowflake user_id = 0;      // From member.user in guilds, user in DMs
+    int type = 0;
+    int component_type = 0;    // data.component_type for component interactions
+    std::string token;
+    std::string command_name;  // data.name for application commands
+    std::string custom_id;     // data.custom_id for components and modals
+    std::string locale;
+};
+
+/**
+ * @brief Decoded GUILD_MEMBER_ADD event
+ */
+struct GuildMemberAddEvent {
+    static constexpr EventType TYPE = EventType::GUILD_MEMBER_ADD;
+
+    Snowflake guild_id = 0;
+    Snowflake user_id = 0;
+    std::string username;
+    std::string global_name;
+    std::string nick;
+    std::string joined_at;
+    bool bot = false;
+    bool pending = false;
+    std::vector<Snowflake> role_ids;
+};
+
+/**
+ * @brief Decode a typed event from a raw gateway frame
+ *
+ * Runs a SAX pass over the frame text and stores only the fields the
+ * struct has; no JSON document is built. The frame's "t" must match
+ * the struct's TYPE.
+ *
+ * @param frame Gateway payload text ({"op":0,"t":...,"d":{...}})
+ * @param event Struct to fill
+ * @return True if the frame was valid and of the right type
+ */
+bool decode_event(std::string_view frame, MessageCreateEvent& event);
+bool decode_event(std::string_view frame, MessageDeleteEvent& event);
+bool decode_event(std::string_view frame, MessageReactionAddEvent& event);
+bool decode_event(std::string_view frame, InteractionCreateEvent& event);
+bool decode_event(std::string_view frame, GuildMemberAddEvent& event);
+
+/**
+ * @brief Decode a typed event from already parsed event data
+ * @param data The payload's "d" object
+ * @param event Struct to fill
+ * @return True if data was an object
+ */
+bool decode_event_data(const nlohmann::json& data, MessageCreateEvent& event);
+bool decode_event_data(const nlohmann::json& data, MessageDeleteEvent& event);
+bool decode_event_data(const nlohmann::json& data, MessageReactionAddEvent& event);
+bool decode_event_data(const nlohmann::json& data, InteractionCreateEvent& event);
+bool decode_event_data(const nlohmann::json& data, GuildMemberAddEvent& event);
+
+/**
+ * @brief Read the event type of a raw gateway frame
+ *
+ * Stops scanning as soon as the top-level "t" field has been read.
+ *
+ * @param frame Gateway payload text
+ * @return Event type, or EventType::UNKNOWN if absent or not a known name
+ */
+EventType peek_event_type(std::string_view frame);
+
+/**
+ * @brief Top-level fields of a raw gateway frame
+ */
+struct FrameHeader {
+    int opcode = -1;
+    int64_t sequence = -1; // -1 if absent or null
+    EventType type = EventType::UNKNOWN;
+};
+
+/**
+ * @brief Read the opcode, sequence number and event type of a raw gateway frame
+ *
+ * Stops scanning once "op", "s" and "t" have all been read; no JSON
+ * document is built.
+ *
+ * @param frame Gateway payload text
+ * @return Header; fields absent from the frame keep their defaults
+ */
+FrameHeader peek_frame_header(std::string_view frame);
+
+} // namespace discord
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "event_types.h"
+#include "../utils/types.h"
+
+namespace discord {
+
+/**
+ * @brief Event field a waiter is keyed on
+ */
+enum class WaitKey : uint8_t {
+    NONE,    // Every event of the type
+    CHANNEL, // channel_id
+    GUILD,   // guild_id
+    USER,    // author.id, user_id, member.user.id or user.id
+    MESSAGE  // message_id, message.id, or id of MESSAGE_UPDATE/MESSAGE_DELETE
+};
+
+inline constexpr size_t WAIT_KEY_COUNT = 5;
+
+/**
+ * @brief Something waiting for events, such as a collector or wait_for()
+ */
+class IEventWaiter {
+public:
+    virtual ~IEventWaiter() = default;
+
+    /**
+     * @brief Offer an event whose type and key match the registration
+     * @param event_data Event data
+     * @return True if the waiter is done and should be removed
+     */
+    virtual bool offer(const nlohmann::json& event_data) = 0;
+
+    /**
+     * @brief Called once when the waiter is removed
+     *
+     * Removal happens when offer() returns true, the deadline passes,
+     * the waiter is removed explicitly, or the index is cleared.
+     */
+    virtual void finish() = 0;
+};
+
+/**
+ * @brief Waiters indexed by event type and key
+ *
+ * An event is offered only to waiters registered for its type and for
+ * its channel, guild, user or message ID, found by hash lookups, so
+ * thousands of waiters keyed on different messages cost nothing per
+ * unrelated event. Deadlines share one min-heap, swept from the dispatch
+ * path and by a timer thread started with the first deadline, so
+ * waiters time out even when no events arrive. The index holds waiters
+ * weakly; a waiter whose owner released it is dropped on its next match.
+ */
+class WaiterIndex {
+public:
+    using WaiterId = uint64_t;
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct BucketKey {
+        EventType type;
+        WaitKey key;
+        Snowflake id;
+        std::string name; // Event name, only for EventType::UNKNOWN
+
+        bool operator==(const BucketKey&) const = default;
+    };
+
+    struct BucketKeyHash {
+        size_t operator()(const BucketKey& key) const;
+    };
+
+    struct Entry {
+        std::weak_ptr<IEventWaiter> waiter;
+        BucketKey bucket;
+    };
+
+    using Deadline = std::pair<Clock::time_point, WaiterId>;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<WaiterId, Entry> entries_;
+    std::unordered_map<BucketKey, std::vector<WaiterId>, BucketKeyHash> buckets_;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines_;
+    std::array<std::array<uint32_t, WAIT_KEY_COUNT>, EVENT_TYPE_COUNT + 1> key_counts_{}; // Per type, per key
+    std::array<std::atomic<uint32_t>, EVENT_TYPE_COUNT + 1> type_counts_{};
+    std::atomic<Clock::rep> next_deadline_{Clock::time_point::max().time_since_epoch().count()};
+    WaiterId next_id_ = 0;
+
+    // Expires waiters while no events arrive
+    std::thread timer_;
+    std::condition_variable timer_cv_;
+    bool stopping_ = false;
+
+    /**
+     * @brief Remove an entry from its bucket and the counters (mutex_ held)
+     * @param entry Entry to unlink
+     * @param id Waiter ID
+     */
+    void unlink(const Entry& entry, WaiterId id);
+
+    /**
+     * @brief Remove waiters whose deadline has passed (mutex_ held)
+     * @param now Current time
+     * @return Removed waiters, to finish after unlocking
+     */
+    std::vector<std::shared_ptr<IEventWaiter>> take_expired(Clock::time_point now);
+
+    /**
+     * @brief Publish the earliest deadline for the lock-free check (mutex_ held)
+     */
+    void update_next_deadline();
+
+    /**
+     * @brief Timer thread body; sleeps until the earliest deadline
+     */
+    void run_timer();
+
+public:
+    WaiterIndex() = default;
+
+    /**
+     * @brief Destructor - stops the timer thread
+     */
+    ~WaiterIndex();
+
+    WaiterIndex(const WaiterIndex&) = delete;
+    WaiterIndex& operator=(const WaiterIndex&) = delete;
+
+    /**
+     * @brief Register a waiter
+     * @param type Event type
+     * @param event_name Event name, used when type is EventType::UNKNOWN
+     * @param key Field to key on
+     * @param key_id ID the field must have (ignored for WaitKey::NONE)
+     * @param deadline When to remove the waiter (Clock::time_point::max() for never)
+     * @param waiter Waiter, held weakly
+     * @return Waiter ID
+     */
+    WaiterId add(EventType type, const std::string& event_name, WaitKey key, Snowflake key_id,
+                 Clock::time_point deadline, std::weak_ptr<IEventWaiter> waiter);
+
+    /**
+     * @brief Remove a waiter and finish it
+     * @param id Waiter ID
+     * @return True if the waiter was registered
+     */
+    bool remove(WaiterId id);
+
+    /**
+     * @brief Offer an event to the waiters registered for it
+     * @param type Event type
+     * @param event_name Event name
+     * @param event_data Event data
+     */
+    void offer(EventType type, const std::string& event_name, const nlohmann::json& event_data);
+
+    /**
+     * @brief Check whether any waiter is registered for a type
+     * @param type Event type
+     * @return True if waiters exist
+     */
+    bool has_waiters(EventType type) const;
+
+    /**
+     * @brief Remove and finish every waiter
+     */
+    void clear();
+
+    /**
+     * @brief Get number of registered waiters
+     * @return Waiter count
+     */
+    size_t size() const;
+};
+
+} // namespace discord
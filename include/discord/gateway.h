@@ -7,6 +7,15 @@
 
 #include "config.h"
 #include "gateway/websocket_client.h"
+#include "gateway/heartbeat_scheduler.h"
+#include "gateway/io_context_pool.h"
+#include "gateway/send_queue.h"
+#include "gateway/identify_scheduler.h"
+#include "gateway/cluster_coordinator.h"
+#include "gateway/shard_state.h"
+#include "gateway/shard_set.h"
+#include "gateway/member_chunker.h"
+#include "gateway/session_store.h"
 #include "gateway/gateway_events.h"
 #include "gateway/reconnection.h"
 #include "gateway/shard_manager.h"
@@ -17,5 +26,12 @@ namespace discord::gateway {
     using discord::GatewayOpcode;
     using discord::GatewayCloseEvent;
     using discord::ReconnectionManager;
+    using discord::HeartbeatScheduler;
+    using discord::IoContextPool;
+    using discord::IdentifyScheduler;
+    using discord::ClusterCoordinator;
+    using discord::EventDeduplicator;
+    using discord::MemberChunker;
+    using discord::SessionStore;
     using discord::ShardManager;
 } // namespace discord::gateway
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace discord {
+
+/**
+ * @brief Contiguous range of shard IDs owned by one cluster
+ */
+struct ShardRange {
+    int first = 0;
+    int last = -1; // Inclusive; empty when last < first
+
+    bool contains(int shard_id) const {
+        return shard_id >= first && shard_id <= last;
+    }
+
+    int size() const {
+        return last >= first ? last - first + 1 : 0;
+    }
+};
+
+/**
+ * @brief Cluster configuration
+ */
+struct ClusterConfig {
+    int cluster_id = 0;
+    int cluster_count = 1;
+    std::string lock_directory; // Shared by all clusters on a host (empty = system temp dir)
+    std::chrono::milliseconds identify_interval{5000};
+};
+
+/**
+ * @brief Coordinates shard clusters running in separate processes
+ *
+ * Each process (cluster) owns a contiguous shard range derived from its
+ * cluster ID. Processes on the same host share a lock directory: one
+ * lock file per identify bucket serializes IDENTIFYs across processes,
+ * a restart lock lets only one cluster restart at a time, and every
+ * cluster publishes its state as a small JSON file.
+ */
+class ClusterCoordinator {
+private:
+    ClusterConfig config_;
+    intptr_t restart_file_ = -1; // Held restart lock: file descriptor, or HANDLE on Windows
+    mutable std::mutex mutex_;
+
+    /**
+     * @brief Get the path of a file in the lock directory
+     * @param name File name
+     * @return Full path
+     */
+    std::string lock_path(const std::string& name) const;
+
+public:
+    /**
+     * @brief Construct ClusterCoordinator
+     * @param config Cluster configuration
+     */
+    explicit ClusterCoordinator(const ClusterConfig& config);
+
+    /**
+     * @brief Destructor - releases the restart lock if held
+     */
+    ~ClusterCoordinator();
+
+    ClusterCoordinator(const ClusterCoordinator&) = delete;
+    ClusterCoordinator& operator=(const ClusterCoordinator&) = delete;
+
+    /**
+     * @brief Split shard_count shards into cluster_count contiguous ranges
+     * @param cluster_id Cluster ID
+     * @param cluster_count Number of clusters
+     * @param shard_count Total shard count
+     * @return Range owned by the cluster
+     */
+    static ShardRange assign_range(int cluster_id, int cluster_count, int shard_count);
+
+    /**
+     * @brief Get the shard range owned by this cluster
+     * @param shard_count Total shard count
+     * @return Owned shard range
+     */
+    ShardRange get_range(int shard_count) const;
+
+    /**
+     * @brief Claim the next IDENTIFY of a bucket across all clusters
+     * @param bucket Rate limit bucket (shard_id % max_concurrency)
+     * @return Zero if claimed, otherwise the time until the bucket opens
+     */
+    std::chrono::milliseconds try_acquire_identify(int bucket);
+
+    /**
+     * @brief Take the host-wide restart lock
+     * @param timeout Maximum time to wait for another cluster's restart
+     * @return True if the lock is held
+     */
+    bool begin_restart(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Release the restart lock
+     */
+    void end_restart();
+
+    /**
+     * @brief Publish this cluster's state for other clusters and tooling
+     * @param state State name (e.g. "starting", "running", "restarting")
+     * @param range Owned shard range
+     */
+    void publish_state(const std::string& state, const ShardRange& range) const;
+
+    /**
+     * @brief Read the published state of every cluster
+     * @return One JSON object per cluster
+     */
+    std::vector<nlohmann::json> get_cluster_states() const;
+
+    /**
+     * @brief Get this cluster's ID
+     * @return Cluster ID
+     */
+    int get_cluster_id() const;
+
+    /**
+     * @brief Get the number of clusters
+     * @return Cluster count
+     */
+    int get_cluster_count() const;
+};
+
+} // namespace discord
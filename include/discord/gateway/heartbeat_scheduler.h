@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace discord {
+
+/**
+ * @brief Heartbeat state of a single gateway connection
+ */
+struct HeartbeatStats {
+    std::chrono::milliseconds interval{0};
+    std::chrono::milliseconds latency{-1};
+    int missed_acks = 0;
+    uint64_t heartbeats_sent = 0;
+    uint64_t acks_received = 0;
+    std::chrono::steady_clock::time_point last_sent;
+    std::chrono::steady_clock::time_point last_ack;
+};
+
+/**
+ * @brief Shared heartbeat scheduler for gateway connections
+ *
+ * Drives the heartbeats of every registered connection from a single
+ * timer thread instead of one sleeping thread per connection. The first
+ * beat of each connection is jittered as Discord requires, HEARTBEAT_ACKs
+ * are tracked to measure gateway latency, and a connection that misses
+ * its ACK is reported as zombied.
+ */
+class HeartbeatScheduler {
+public:
+    using HeartbeatId = uint64_t;
+    using HeartbeatCallback = std::function<void()>;
+    using ZombieCallback = std::function<void()>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::chrono::milliseconds interval;
+        HeartbeatCallback send;
+        ZombieCallback on_zombie;
+        HeartbeatStats stats;
+        bool awaiting_ack = false;
+    };
+
+    struct Deadline {
+        Clock::time_point when;
+        HeartbeatId id;
+
+        bool operator>(const Deadline& other) const {
+            return when > other.when;
+        }
+    };
+
+    std::unordered_map<HeartbeatId, Entry> entries_;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>> deadlines_;
+    HeartbeatId next_id_ = 1;
+    int max_missed_acks_;
+
+    // Callback currently executing on the timer thread
+    HeartbeatId firing_id_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable firing_cv_;
+    std::thread worker_;
+    bool stopping_ = false;
+
+    /**
+     * @brief Timer thread main loop
+     */
+    void run();
+
+    /**
+     * @brief Invoke a callback outside the lock and mark its connection as firing
+     * @param lock Held scheduler lock, released while the callback runs
+     * @param id Connection the callback belongs to
+     * @param callback Callback to invoke
+     */
+    void fire(std::unique_lock<std::mutex>& lock, HeartbeatId id, std::function<void()> callback);
+
+public:
+    /**
+     * @brief Construct HeartbeatScheduler
+     * @param max_missed_acks Missed ACKs after which a connection is zombied
+     */
+    explicit HeartbeatScheduler(int max_missed_acks = 1);
+
+    /**
+     * @brief Destructor - stops the timer thread
+     */
+    ~HeartbeatScheduler();
+
+    HeartbeatScheduler(const HeartbeatScheduler&) = delete;
+    HeartbeatScheduler& operator=(const HeartbeatScheduler&) = delete;
+
+    /**
+     * @brief Get the process-wide scheduler shared by all connections
+     * @return Shared scheduler instance
+     */
+    static HeartbeatScheduler& instance();
+
+    /**
+     * @brief Start heartbeating a connection
+     * @param interval Heartbeat interval from HELLO
+     * @param send Sends a heartbeat payload
+     * @param on_zombie Called once if the connection stops acknowledging
+     * @return Identifier used for later calls
+     */
+    HeartbeatId add(std::chrono::milliseconds interval, HeartbeatCallback send, ZombieCallback on_zombie);
+
+    /**
+     * @brief Stop heartbeating a connection
+     *
+     * Waits for a callback of this connection that is currently running,
+     * unless called from that callback.
+     * @param id Connection identifier
+     */
+    void remove(HeartbeatId id);
+
+    /**
+     * @brief Record a HEARTBEAT_ACK
+     * @param id Connection identifier
+     */
+    void acknowledge(HeartbeatId id);
+
+    /**
+     * @brief Send a heartbeat immediately (gateway opcode 1 request)
+     *
+     * The next scheduled heartbeat moves to one interval after this one.
+     * @param id Connection identifier
+     */
+    void beat_now(HeartbeatId id);
+
+    /**
+     * @brief Get heartbeat statistics of a connection
+     * @param id Connection identifier
+     * @return Statistics or empty optional if not registered
+     */
+    std::optional<HeartbeatStats> get_stats(HeartbeatId id) const;
+
+    /**
+     * @brief Get number of connections being heartbeated
+     * @return Connection count
+     */
+    size_t get_connection_count() const;
+
+    /**
+     * @brief Set missed ACK threshold for zombie detection
+     * @param max_missed_acks Missed ACKs after which a connection is zombied
+     */
+    void set_max_missed_acks(int max_missed_acks);
+};
+
+} // namespace discord
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace discord {
+
+/**
+ * @brief Schedules shard IDENTIFYs within Discord's session start limits
+ *
+ * Discord lets a bot start max_concurrency sessions every 5 seconds, one
+ * per rate limit bucket (shard_id % max_concurrency), and caps the total
+ * number of session starts per day. Shards queue their IDENTIFY here and
+ * each bucket releases one every interval, so up to max_concurrency
+ * shards identify in parallel. The remaining session starts can be
+ * persisted to a file so restarts do not forget how many were used.
+ */
+class IdentifyScheduler {
+public:
+    using IdentifyCallback = std::function<void()>;
+    // Returns zero to let the bucket identify now, otherwise how long to wait
+    using BucketGate = std::function<std::chrono::milliseconds(int)>;
+
+    static constexpr std::chrono::milliseconds DEFAULT_BUCKET_INTERVAL{5000};
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        int shard_id;
+        uint64_t shard_set;
+        IdentifyCallback identify;
+    };
+
+    struct Bucket {
+        std::deque<Request> queue;
+        Clock::time_point next_allowed{};
+    };
+
+    int max_concurrency_;
+    std::chrono::milliseconds bucket_interval_;
+    std::vector<Bucket> buckets_;
+
+    // Session start limit
+    int session_start_total_ = 1000;
+    int session_start_remaining_ = 1000;
+    std::chrono::system_clock::time_point session_start_reset_at_{};
+    std::string persistence_path_;
+    BucketGate bucket_gate_;
+
+    std::thread worker_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+
+    /**
+     * @brief Worker loop releasing IDENTIFYs as buckets open
+     */
+    void run();
+
+    /**
+     * @brief Refill the session start limit once its window has passed (mutex_ held)
+     */
+    void roll_session_limit();
+
+    /**
+     * @brief Write the session start limit to the persistence file (mutex_ held)
+     */
+    void persist() const;
+
+    /**
+     * @brief Read the session start limit from the persistence file (mutex_ held)
+     */
+    void load();
+
+public:
+    /**
+     * @brief Construct IdentifyScheduler
+     * @param max_concurrency Number of rate limit buckets
+     * @param bucket_interval Minimum time between IDENTIFYs of one bucket
+     */
+    explicit IdentifyScheduler(int max_concurrency,
+                               std::chrono::milliseconds bucket_interval = DEFAULT_BUCKET_INTERVAL);
+
+    /**
+     * @brief Destructor - stops the worker thread
+     */
+    ~IdentifyScheduler();
+
+    IdentifyScheduler(const IdentifyScheduler&) = delete;
+    IdentifyScheduler& operator=(const IdentifyScheduler&) = delete;
+
+    /**
+     * @brief Queue an IDENTIFY for a shard
+     * @param shard_id Shard ID (selects the bucket)
+     * @param identify Called on the scheduler thread when the shard may identify
+     * @param shard_set Shard set generation; while resharding two sets share shard IDs
+     */
+    void schedule(int shard_id, IdentifyCallback identify, uint64_t shard_set = 0);
+
+    /**
+     * @brief Drop queued IDENTIFYs of a shard
+     * @param shard_id Shard ID
+     * @param shard_set Shard set generation
+     */
+    void cancel(int shard_id, uint64_t shard_set = 0);
+
+    /**
+     * @brief Stop the worker thread and drop all queued IDENTIFYs
+     */
+    void stop();
+
+    /**
+     * @brief Set the session start limit reported by /gateway/bot
+     * @param total Session starts allowed per window
+     * @param remaining Session starts left in the current window
+     * @param reset_after Time until the window resets
+     */
+    void set_session_start_limit(int total, int remaining, std::chrono::milliseconds reset_after);
+
+    /**
+     * @brief Persist remaining session starts to a file
+     * @param path File path (empty disables persistence)
+     */
+    void set_persistence_path(const std::string& path);
+
+    /**
+     * @brief Consult an external gate before a bucket identifies (e.g. other processes)
+     * @param gate Called on the scheduler thread with the bucket index
+     */
+    void set_bucket_gate(BucketGate gate);
+
+    /**
+     * @brief Get remaining session starts in the current window
+     * @return Remaining session starts
+     */
+    int get_remaining_session_starts() const;
+
+    /**
+     * @brief Get number of queued IDENTIFYs
+     * @return Pending IDENTIFY count
+     */
+    size_t get_pending_count() const;
+
+    /**
+     * @brief Get number of rate limit buckets
+     * @return max_concurrency
+     */
+    int get_max_concurrency() const;
+
+    /**
+     * @brief Get the rate limit bucket of a shard
+     * @param shard_id Shard ID
+     * @return Bucket index
+     */
+    int get_bucket(int shard_id) const;
+};
+
+} // namespace discord
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace boost::asio {
+class io_context;
+}
+
+namespace discord {
+
+/**
+ * @brief Shared asio io_context driven by a fixed pool of threads
+ *
+ * Lets many WebSocketClient instances (e.g. all shards of a process)
+ * share one event loop instead of each running its own io_context on a
+ * dedicated thread. Handlers of a single connection are still serialized
+ * by the connection's strand.
+ */
+class IoContextPool {
+public:
+    /**
+     * @brief Construct IoContextPool
+     * @param threads Number of threads running the io_context (0 = one per core)
+     */
+    explicit IoContextPool(size_t threads = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Destructor - stops the pool
+     */
+    ~IoContextPool();
+
+    IoContextPool(const IoContextPool&) = delete;
+    IoContextPool& operator=(const IoContextPool&) = delete;
+
+    /**
+     * @brief Pin the worker threads to a CPU (Linux only, call before start)
+     * @param cpu CPU index, or -1 to let the OS schedule the threads
+     */
+    void set_cpu_affinity(int cpu);
+
+    /**
+     * @brief Start the worker threads
+     */
+    void start();
+
+    /**
+     * @brief Stop the io_context and join the worker threads
+     */
+    void stop();
+
+    /**
+     * @brief Check if the pool is running
+     * @return True if worker threads are running
+     */
+    bool is_running() const;
+
+    /**
+     * @brief Get number of worker threads
+     * @return Thread count
+     */
+    size_t get_thread_count() const;
+
+    /**
+     * @brief Get the shared io_context
+     * @return io_context driven by this pool
+     */
+    boost::asio::io_context& get_io_context();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace discord
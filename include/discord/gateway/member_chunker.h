@@ -0,0 +1,197 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "../core/interfaces.h"
+#include "../utils/types.h"
+
+namespace discord {
+
+/**
+ * @brief Options of a REQUEST_GUILD_MEMBERS (opcode 8) request
+ */
+struct MemberChunkOptions {
+    bool presences = false;          // Also receive presences (needs GUILD_PRESENCES)
+    std::string query;               // Username prefix; empty with limit 0 returns every member
+    int limit = 0;                   // Maximum members for a query (0 = no limit)
+    std::vector<Snowflake> user_ids; // Fetch these users instead of querying
+};
+
+/**
+ * @brief Summary of a completed member request
+ */
+struct MemberChunkResult {
+    Snowflake guild_id = 0;
+    size_t member_count = 0;
+    size_t presence_count = 0;
+    int chunk_count = 0;
+    std::vector<Snowflake> not_found;
+};
+
+/**
+ * @brief Requests guild members over the gateway and streams the chunks
+ *
+ * Each request gets a nonce; GUILD_MEMBERS_CHUNK events carrying it are
+ * passed to handle_event(), which writes every member (and presence)
+ * straight into the member cache and the member callback. Nothing is
+ * aggregated: the returned future only carries counts and resolves when
+ * the nonce's last chunk arrives. Requests are queued per shard and at
+ * most max_in_flight are outstanding on a shard, so bulk requests never
+ * crowd out other gateway commands within the shard's send limit.
+ */
+class MemberChunker {
+public:
+    using SendFunction = std::function<bool(Snowflake, const nlohmann::json&)>;
+    using ShardFunction = std::function<int(Snowflake)>;
+    using MemberCallback = std::function<void(Snowflake, const nlohmann::json&)>;
+
+    static constexpr size_t DEFAULT_MAX_IN_FLIGHT = 4;
+    static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{120000};
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        std::string nonce;
+        Snowflake guild_id;
+        int shard_id;
+        nlohmann::json payload;
+        Clock::time_point sent_at;
+        MemberChunkResult result;
+        std::promise<MemberChunkResult> promise;
+    };
+    using RequestPtr = std::shared_ptr<Request>;
+
+    SendFunction send_;
+    ShardFunction shard_of_;
+    std::shared_ptr<ICache> member_cache_;
+    MemberCallback member_callback_;
+    MemberCallback presence_callback_;
+    size_t max_in_flight_;
+    std::chrono::milliseconds timeout_;
+
+    std::unordered_map<std::string, RequestPtr> in_flight_;
+    std::unordered_map<int, std::deque<RequestPtr>> queued_;
+    std::unordered_map<int, size_t> in_flight_per_shard_;
+    uint64_t next_nonce_ = 0;
+    Clock::time_point next_expiry_check_{};
+    mutable std::mutex mutex_;
+
+    /**
+     * @brief Take the next queued request of a shard if it has a free slot (mutex_ held)
+     * @param shard_id Shard ID
+     * @return Request to send, or nullptr
+     */
+    RequestPtr take_next(int shard_id);
+
+    /**
+     * @brief Send requests until the send succeeds or the shard's queue is empty
+     * @param request First request to send (may be nullptr)
+     */
+    void dispatch(RequestPtr request);
+
+    /**
+     * @brief Release a request's slot (mutex_ held)
+     * @param request Finished request
+     * @return Next request of the same shard to send, or nullptr
+     */
+    RequestPtr finish(const RequestPtr& request);
+
+public:
+    /**
+     * @brief Construct MemberChunker
+     * @param send Sends a payload on the shard owning a guild
+     * @param shard_of Maps a guild to its shard
+     * @param max_in_flight Outstanding requests allowed per shard
+     * @param timeout Time after which an unanswered request fails
+     */
+    MemberChunker(SendFunction send, ShardFunction shard_of,
+                  size_t max_in_flight = DEFAULT_MAX_IN_FLIGHT,
+                  std::chrono::milliseconds timeout = DEFAULT_TIMEOUT);
+
+    /**
+     * @brief Destructor - fails outstanding requests
+     */
+    ~MemberChunker();
+
+    MemberChunker(const MemberChunker&) = delete;
+    MemberChunker& operator=(const MemberChunker&) = delete;
+
+    /**
+     * @brief Request members of a guild
+     * @param guild_id Guild snowflake
+     * @param options Request options
+     * @return Future resolved by the last chunk
+     */
+    std::future<MemberChunkResult> request(Snowflake guild_id, const MemberChunkOptions& options = {});
+
+    /**
+     * @brief Request members of many guilds
+     *
+     * Opcode 8 takes one guild per request; the requests are queued per
+     * shard and sent as slots free up.
+     *
+     * @param guild_ids Guild snowflakes
+     * @param options Options applied to every request
+     * @return One future per guild, in order
+     */
+    std::vector<std::future<MemberChunkResult>> request_many(const std::vector<Snowflake>& guild_ids,
+                                                             const MemberChunkOptions& options = {});
+
+    /**
+     * @brief Consume a GUILD_MEMBERS_CHUNK dispatch
+     * @param event Gateway dispatch payload
+     * @return True if the chunk belonged to a request of this chunker
+     */
+    bool handle_event(const nlohmann::json& event);
+
+    /**
+     * @brief Store streamed members in a cache as "member:<guild_id>:<user_id>"
+     * @param cache Member cache (nullptr disables caching)
+     */
+    void set_member_cache(std::shared_ptr<ICache> cache);
+
+    /**
+     * @brief Set member callback
+     * @param callback Called with (guild_id, member) for every streamed member
+     */
+    void set_member_callback(MemberCallback callback);
+
+    /**
+     * @brief Set presence callback
+     * @param callback Called with (guild_id, presence) for every streamed presence
+     */
+    void set_presence_callback(MemberCallback callback);
+
+    /**
+     * @brief Fail requests that got no final chunk within the timeout
+     *
+     * Runs on every request() and should also run on a timer, so a
+     * request still fails when no further requests are made; ShardManager
+     * calls it from its health monitor.
+     */
+    void expire();
+
+    /**
+     * @brief Fail all queued and outstanding requests
+     */
+    void cancel_all();
+
+    /**
+     * @brief Get number of queued and outstanding requests
+     * @return Pending request count
+     */
+    size_t get_pending_count() const;
+};
+
+} // namespace discord
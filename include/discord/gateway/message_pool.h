@@ -0,0 +1,130 @@
+#pragma once
+
+#include <websocketpp/config/asio_client.hpp>
+#include <websocketpp/message_buffer/message.hpp>
+#include <websocketpp/message_buffer/alloc.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace discord {
+
+/**
+ * @brief Per-connection websocketpp message manager that recycles messages
+ *
+ * The default manager allocates a fresh message (and payload buffer) for
+ * every frame. This one keeps the messages it hands out and reuses any
+ * that nobody else references anymore, so a connection in steady state
+ * reads and writes frames without touching the heap.
+ */
+template<typename message>
+class PooledMessageManager : public std::enable_shared_from_this<PooledMessageManager<message>> {
+public:
+    using type = PooledMessageManager<message>;
+    using ptr = std::shared_ptr<PooledMessageManager>;
+    using weak_ptr = std::weak_ptr<PooledMessageManager>;
+    using message_ptr = typename message::ptr;
+
+    static constexpr size_t MAX_POOLED_MESSAGES = 16;
+    static constexpr size_t DEFAULT_PAYLOAD_SIZE = 128;
+    static constexpr size_t MAX_RETAINED_PAYLOAD = 64 * 1024; // Larger buffers are freed once idle
+
+private:
+    std::vector<message_ptr> pool_;
+    std::mutex mutex_;
+
+    /**
+     * @brief Find a pooled message that is no longer referenced elsewhere
+     *
+     * Idle messages whose payload grew past MAX_RETAINED_PAYLOAD (e.g. for
+     * a large GUILD_CREATE) give that memory back instead of holding it for
+     * the life of the connection.
+     *
+     * @return Reset message or nullptr
+     */
+    message_ptr take_free(websocketpp::frame::opcode::value op, size_t size) {
+        message_ptr found;
+        for (auto& candidate : pool_) {
+            if (candidate.use_count() != 1) {
+                continue;
+            }
+
+            auto& payload = candidate->get_raw_payload();
+            if (payload.capacity() > MAX_RETAINED_PAYLOAD) {
+                std::string().swap(payload);
+            }
+
+            if (!found) {
+                candidate->set_opcode(op);
+                candidate->set_header("");
+                candidate->set_prepared(false);
+                candidate->set_fin(true);
+                candidate->set_compressed(false);
+                candidate->set_terminal(false);
+
+                // clear() keeps the payload capacity from previous frames
+                payload.clear();
+                payload.reserve(size);
+                found = candidate;
+            }
+        }
+        return found;
+    }
+
+    message_ptr acquire(websocketpp::frame::opcode::value op, size_t size) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (auto reused = take_free(op, size)) {
+            return reused;
+        }
+
+        auto created = std::make_shared<message>(type::shared_from_this(), op, size);
+        if (pool_.size() < MAX_POOLED_MESSAGES) {
+            pool_.push_back(created);
+        }
+        return created;
+    }
+
+public:
+    /**
+     * @brief Get a message with default settings
+     * @return Message pointer
+     */
+    message_ptr get_message() {
+        return acquire(websocketpp::frame::opcode::text, DEFAULT_PAYLOAD_SIZE);
+    }
+
+    /**
+     * @brief Get a message for a frame of the given type and size
+     * @param op Frame opcode
+     * @param size Expected payload size
+     * @return Message pointer
+     */
+    message_ptr get_message(websocketpp::frame::opcode::value op, size_t size) {
+        return acquire(op, size);
+    }
+
+    /**
+     * @brief Recycle hook called by websocketpp (unused, reuse is driven by use_count)
+     * @return Always false
+     */
+    bool recycle(message*) {
+        return false;
+    }
+};
+
+/**
+ * @brief asio TLS client config using pooled messages
+ */
+struct PooledTlsClientConfig : public websocketpp::config::asio_tls_client {
+    using type = PooledTlsClientConfig;
+
+    using message_type = websocketpp::message_buffer::message<PooledMessageManager>;
+    using con_msg_manager_type = PooledMessageManager<message_type>;
+    using endpoint_msg_manager_type =
+        websocketpp::message_buffer::alloc::endpoint_msg_manager<con_msg_manager_type>;
+};
+
+} // namespace discord
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 #include <chrono>
 #include <functional>
 #include <thread>
@@ -34,11 +35,12 @@ public:
     void stop_reconnecting();
     
     void reset_session();
+    void update_session(const std::string& session_id);
 
 private:
     struct SessionInfo {
         std::string session_id;
-        int sequence_number = 0;
+        int64_t sequence_number = 0;
         bool can_resume = false;
         std::chrono::steady_clock::time_point last_heartbeat;
     };
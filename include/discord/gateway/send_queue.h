@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace discord {
+
+/**
+ * @brief Unbounded lock-free multi-producer single-consumer queue
+ *
+ * Producers never block: push() is a single atomic exchange. Only one
+ * thread (or strand) may call try_pop() and empty() at a time.
+ */
+template<typename T>
+class MpscQueue {
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+
+    alignas(64) std::atomic<Node*> head_;
+    alignas(64) Node* tail_;
+    std::atomic<size_t> size_{0};
+
+public:
+    MpscQueue() {
+        Node* stub = new Node();
+        head_.store(stub, std::memory_order_relaxed);
+        tail_ = stub;
+    }
+
+    ~MpscQueue() {
+        T discarded;
+        while (try_pop(discarded)) {
+        }
+        delete tail_;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief Push a value (any thread)
+     * @param value Value to enqueue
+     */
+    void push(T value) {
+        Node* node = new Node();
+        node->value = std::move(value);
+
+        // Counted before the node is published, so its pop can never take size_ below zero
+        size_.fetch_add(1, std::memory_order_relaxed);
+        Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief Pop the oldest value (consumer only)
+     * @param out Receives the value
+     * @return True if a value was popped
+     */
+    bool try_pop(T& out) {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+
+        out = std::move(next->value);
+        tail_ = next;
+        delete tail;
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Check if the queue is empty (consumer only)
+     * @return True if there is nothing to pop
+     */
+    bool empty() const {
+        return tail_->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+    /**
+     * @brief Approximate number of queued values (any thread)
+     * @return Queue size
+     */
+    size_t size() const {
+        return size_.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Gateway command limiter (120 commands per 60 seconds per connection)
+ *
+ * Discord disconnects a connection that sends more than 120 gateway
+ * commands in a 60 second window. A few slots of every window are
+ * reserved for priority payloads (heartbeats, IDENTIFY, RESUME) so that
+ * bursts of regular commands can never delay a heartbeat.
+ */
+class GatewaySendLimiter {
+public:
+    static constexpr int GATEWAY_COMMAND_LIMIT = 120;
+    static constexpr std::chrono::milliseconds GATEWAY_COMMAND_WINDOW{60000};
+    static constexpr int PRIORITY_RESERVE = 5;
+
+private:
+    int limit_;
+    int reserved_;
+    std::chrono::milliseconds window_;
+    int used_ = 0;
+    std::chrono::steady_clock::time_point window_start_;
+    mutable std::mutex mutex_;
+
+    /**
+     * @brief Start a new window if the current one has elapsed
+     * @param now Current time
+     */
+    void roll_window(std::chrono::steady_clock::time_point now);
+
+public:
+    /**
+     * @brief Construct GatewaySendLimiter
+     * @param limit Commands allowed per window
+     * @param window Window length
+     * @param reserved Slots only priority payloads may use
+     */
+    explicit GatewaySendLimiter(int limit = GATEWAY_COMMAND_LIMIT,
+                                std::chrono::milliseconds window = GATEWAY_COMMAND_WINDOW,
+                                int reserved = PRIORITY_RESERVE);
+
+    /**
+     * @brief Take a slot in the current window
+     * @param priority Whether the payload may use the reserved slots
+     * @return True if the payload may be sent now
+     */
+    bool try_acquire(bool priority);
+
+    /**
+     * @brief Time until a slot becomes available
+     * @param priority Whether the payload may use the reserved slots
+     * @return Zero if a slot is available now
+     */
+    std::chrono::milliseconds time_until_available(bool priority) const;
+
+    /**
+     * @brief Get remaining slots for regular payloads in the current window
+     * @return Remaining slots
+     */
+    int get_remaining() const;
+
+    /**
+     * @brief Start a fresh window (new connection)
+     */
+    void reset();
+};
+
+} // namespace discord
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace discord {
+
+/**
+ * @brief Saved gateway session of one shard
+ */
+struct StoredSession {
+    int shard_id = 0;
+    std::string session_id;
+    std::string resume_gateway_url;
+    int64_t sequence_number = -1;
+    std::chrono::system_clock::time_point saved_at;
+};
+
+/**
+ * @brief Keeps shard sessions in a small memory-mapped file
+ *
+ * The file holds one fixed-size record per owned shard. A save is a few
+ * stores into the mapping, so it can run on every READY and on a timer
+ * without blocking; the kernel writes the pages back even if the
+ * process is killed. Each record carries a sequence counter that is odd
+ * while the record is being written, so a torn record is detected and
+ * ignored on load. After a quick restart the shards find their session
+ * here and RESUME instead of identifying.
+ */
+class SessionStore {
+public:
+    static constexpr size_t MAX_SESSION_ID = 64;
+    static constexpr size_t MAX_RESUME_URL = 160;
+    static constexpr std::chrono::minutes DEFAULT_MAX_AGE{3};
+
+private:
+    struct Header;
+    struct Record;
+
+    std::string path_;
+    std::chrono::milliseconds max_age_;
+    intptr_t file_ = -1; // File descriptor, or HANDLE on Windows
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    int first_shard_ = 0;
+    int size_ = 0;
+    mutable std::mutex mutex_;
+
+    /**
+     * @brief Get the record of a shard (mutex_ held)
+     * @param shard_id Shard ID
+     * @return Record, or nullptr if the shard is not in the mapped range
+     */
+    Record* record(int shard_id) const;
+
+    /**
+     * @brief Unmap and close the file (mutex_ held)
+     */
+    void unmap();
+
+public:
+    /**
+     * @brief Construct SessionStore
+     * @param path File path
+     * @param max_age Sessions saved longer ago than this are not resumed
+     */
+    explicit SessionStore(const std::string& path, std::chrono::milliseconds max_age = DEFAULT_MAX_AGE);
+
+    /**
+     * @brief Destructor - flushes and unmaps the file
+     */
+    ~SessionStore();
+
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    /**
+     * @brief Map the file for a shard range
+     *
+     * Records written for a different shard count or range are discarded.
+     *
+     * @param first_shard First owned shard ID
+     * @param size Number of owned shards
+     * @param shard_count Total shard count
+     * @return True if the file is mapped
+     */
+    bool open(int first_shard, int size, int shard_count);
+
+    /**
+     * @brief Check whether the file is mapped
+     * @return True if open() succeeded
+     */
+    bool is_open() const;
+
+    /**
+     * @brief Save a shard's session
+     * @param shard_id Shard ID
+     * @param session_id Session ID (empty clears the record)
+     * @param sequence_number Last sequence number
+     * @param resume_gateway_url resume_gateway_url from READY
+     */
+    void save(int shard_id, const std::string& session_id, int64_t sequence_number,
+              const std::string& resume_gateway_url);
+
+    /**
+     * @brief Update only the sequence number of a saved session
+     * @param shard_id Shard ID
+     * @param sequence_number Last sequence number
+     */
+    void save_sequence(int shard_id, int64_t sequence_number);
+
+    /**
+     * @brief Forget a shard's session
+     * @param shard_id Shard ID
+     */
+    void clear(int shard_id);
+
+    /**
+     * @brief Load a shard's session if it is recent enough to resume
+     * @param shard_id Shard ID
+     * @return Session, or nullopt if none is stored, it is torn or too old
+     */
+    std::optional<StoredSession> load(int shard_id) const;
+
+    /**
+     * @brief Write dirty pages to disk now
+     */
+    void flush();
+};
+
+} // namespace discord
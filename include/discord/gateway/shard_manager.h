@@ -4,52 +4,78 @@
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <functional>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
 #include <chrono>
+#include <optional>
+#include <future>
 #include <nlohmann/json.hpp>
 #include "websocket_client.h"
 #include "reconnection.h"
+#include "io_context_pool.h"
+#include "identify_scheduler.h"
+#include "cluster_coordinator.h"
+#include "shard_state.h"
+#include "shard_set.h"
+#include "member_chunker.h"
+#include "session_store.h"
 
 namespace discord {
 
-/**
- * @brief Shard information and state
- */
-struct ShardInfo {
-    int shard_id;
-    int shard_count;
-    std::string session_id;
-    int sequence_number;
-    bool is_connected;
-    bool is_resumable;
-    std::chrono::steady_clock::time_point last_heartbeat;
-    std::chrono::steady_clock::time_point connect_time;
-    int reconnect_attempts;
-    
-    ShardInfo(int id, int total) 
-        : shard_id(id), shard_count(total), sequence_number(0), 
-          is_connected(false), is_resumable(false), reconnect_attempts(0) {}
-};
-
 /**
  * @brief Shard configuration
  */
 struct ShardConfig {
     int shard_count;
     int max_concurrency;
-    std::chrono::milliseconds connection_delay;
     std::chrono::milliseconds heartbeat_interval;
     bool auto_sharding;
     bool compress;
+    size_t io_threads; // Threads driving the shared gateway io_context (0 = one per core)
+    
+    // Shard groups: each group of shards gets its own single-threaded event loop,
+    // so a shard's frames are decoded, dispatched and cached on one thread
+    int shard_groups;      // 0 = all shards share the io_threads pool
+    bool pin_shard_groups; // Pin group N's thread to CPU N % cores (Linux)
+    std::string session_limit_path; // File persisting remaining session starts (empty = off)
+    
+    // Memory-mapped file of shard sessions, saved on READY, every health check
+    // and on stop(), so a restarted process resumes instead of identifying
+    std::string session_store_path; // Empty = off
+    
+    // Cluster mode: this process runs cluster_id's share of the shards and
+    // coordinates IDENTIFYs and restarts with the other clusters on the host
+    int cluster_id;
+    int cluster_count;
+    std::string cluster_lock_directory; // Empty = system temp directory
+    
+    int reconnect_concurrency; // Shards resuming at once during reconnect_all()
+    
+    // Health monitor: samples every shard and resumes shards that went silent
+    std::chrono::milliseconds health_check_interval; // 0 = no monitor
+    std::chrono::milliseconds zombie_timeout;        // Silence before a resume (0 = 1.5 heartbeat intervals)
+    
+    // Live resharding: how long delivered events are remembered before the
+    // switch, and how long both shard sets deliver (deduplicated) after it
+    std::chrono::milliseconds reshard_overlap;
     
     ShardConfig() 
         : shard_count(1), max_concurrency(1), 
-          connection_delay(std::chrono::milliseconds(5000)),
           heartbeat_interval(std::chrono::milliseconds(41250)),
-          auto_sharding(true), compress(true) {}
+          auto_sharding(true), compress(true), io_threads(0),
+          shard_groups(0), pin_shard_groups(false),
+          cluster_id(0), cluster_count(1), reconnect_concurrency(16),
+          health_check_interval(std::chrono::milliseconds(5000)),
+          zombie_timeout(std::chrono::milliseconds(0)),
+          reshard_overlap(std::chrono::milliseconds(5000)) {}
+    
+    bool is_clustered() const {
+        return cluster_count > 1;
+    }
 };
 
 /**
@@ -61,11 +87,33 @@ struct GatewaySession {
     int session_start_limit_total;
     int session_start_limit_remaining;
     int session_start_limit_reset_after;
+    int max_concurrency = 1;
     std::chrono::steady_clock::time_point last_reset;
+};
+
+/**
+ * @brief Shard manager statistics (snapshot)
+ */
+struct ShardStatistics {
+    int total_shards = 0;
+    int first_shard = 0;
+    int last_shard = -1;
+    int shard_groups = 0;
+    int cluster_id = 0;
+    int cluster_count = 1;
+    int connected_shards = 0;
+    bool is_running = false;
+    bool is_resharding = false;
+    int sessions_started_recently = 0;
+    int remaining_session_starts = -1; // -1 while stopped
+    size_t pending_identifies = 0;
+    std::vector<ShardHealth> shards;
     
-    bool can_start_session() const {
-        return session_start_limit_remaining > 0;
-    }
+    /**
+     * @brief Convert to JSON
+     * @return JSON object with the statistics
+     */
+    nlohmann::json to_json() const;
 };
 
 /**
@@ -79,82 +127,157 @@ struct GatewaySession {
 class ShardManager {
 public:
     using EventCallback = std::function<void(int, const nlohmann::json&)>;
+    using FrameCallback = std::function<bool(int, std::string_view)>;
     using ShardStateCallback = std::function<void(int, bool)>;
     using ReadyCallback = std::function<void(int, const nlohmann::json&)>;
 
 private:
     ShardConfig config_;
-    std::unordered_map<int, std::unique_ptr<WebSocketClient>> shards_;
-    std::unordered_map<int, ShardInfo> shard_info_;
+    std::shared_ptr<IoContextPool> io_pool_;
+    std::vector<std::shared_ptr<IoContextPool>> group_pools_;
+    std::unique_ptr<IdentifyScheduler> identify_scheduler_;
+    std::unique_ptr<ClusterCoordinator> cluster_;
+    ShardRange shard_range_;
+    std::atomic<int> identifies_released_{0};
+    
+    // Shard sets: the active set is swapped atomically by reshard()
+    std::atomic<std::shared_ptr<ShardSet>> shards_;
+    std::shared_ptr<ShardSet> pending_shards_; // Guarded by mutex_
+    std::atomic<uint64_t> next_generation_{1};
+    std::atomic<bool> is_resharding_{false};
+    std::atomic<bool> deduplicate_events_{false};
+    EventDeduplicator deduplicator_;
+    std::unique_ptr<MemberChunker> member_chunker_;
+    std::unique_ptr<SessionStore> session_store_;
     std::string gateway_url_;
     std::string bot_token_;
     
     // Callbacks
     EventCallback event_callback_;
+    FrameCallback frame_callback_;
     ShardStateCallback shard_state_callback_;
     ReadyCallback ready_callback_;
+    EventCallback warmup_callback_;
     
     // Threading and synchronization
     mutable std::mutex mutex_;
-    std::vector<std::thread> connection_threads_;
+    std::vector<std::thread> connection_threads_; // reconnect_all() jobs; guarded by mutex_
+    std::atomic<uint64_t> reconnect_job_{0};
+    std::thread health_thread_;
+    std::mutex health_mutex_;
+    std::condition_variable health_cv_;
     std::atomic<bool> is_running_{false};
     std::atomic<bool> is_shutting_down_{false};
     
     // Session management
     GatewaySession session_info_;
-    std::chrono::steady_clock::time_point last_session_update_;
     
-    // Rate limiting
+    // New sessions (IDENTIFYs, not RESUMEs) since the session start limit last reset
     std::atomic<int> sessions_started_recently_{0};
-    std::chrono::steady_clock::time_point last_session_reset_;
+
+    /**
+     * @brief Get the active shard set
+     * @return Active set (never null)
+     */
+    std::shared_ptr<ShardSet> active_set() const;
+
+    /**
+     * @brief Create an empty shard set for a shard count
+     * @param shard_count Total shard count of the set
+     * @return New set owning this process's range of that count
+     */
+    std::shared_ptr<ShardSet> create_shard_set(int shard_count);
+
+    /**
+     * @brief Connect every shard of a set in identify waves
+     * @param set Shard set to connect
+     */
+    void connect_set(ShardSet& set);
+
+    /**
+     * @brief Disconnect and destroy the clients of a set
+     * @param set Shard set to tear down
+     */
+    void retire_set(ShardSet& set);
 
     /**
      * @brief Initialize a single shard
+     * @param set Shard set the shard belongs to
      * @param shard_id Shard ID to initialize
-     * @return True if initialization was successful
+     * @return The shard's client, or nullptr if the set does not own the shard
      */
-    bool initialize_shard(int shard_id);
+    WebSocketClient* initialize_shard(ShardSet& set, int shard_id);
 
     /**
      * @brief Connect a single shard
+     * @param set Shard set the shard belongs to
      * @param shard_id Shard ID to connect
      */
-    void connect_shard(int shard_id);
+    void connect_shard(ShardSet& set, int shard_id);
 
     /**
-     * @brief Disconnect a single shard
+     * @brief Disconnect a single shard (mutex_ held)
+     * @param set Shard set the shard belongs to
      * @param shard_id Shard ID to disconnect
      */
-    void disconnect_shard(int shard_id);
+    void disconnect_shard(ShardSet& set, int shard_id);
 
     /**
      * @brief Handle shard connection events
+     * @param set Shard set the shard belongs to
      * @param shard_id Shard ID
      * @param event Event data
      */
-    void handle_shard_event(int shard_id, const nlohmann::json& event);
+    void handle_shard_event(ShardSet& set, int shard_id, const nlohmann::json& event);
+
+    /**
+     * @brief Offer a raw dispatch frame to the frame callback
+     * @param set Shard set the shard belongs to
+     * @param shard_id Shard ID
+     * @param frame Gateway payload text
+     * @param header Opcode, sequence number and type of the frame
+     * @return True if the frame was consumed and needs no parsing
+     */
+    bool handle_shard_frame(ShardSet& set, int shard_id, std::string_view frame, const FrameHeader& header);
+
+    /**
+     * @brief Count a received event and track its sequence number
+     * @param state Shard state
+     * @param sequence Sequence number of a dispatch, or -1
+     */
+    void record_shard_event(ShardState& state, int64_t sequence);
 
     /**
      * @brief Handle shard disconnection
+     * @param set Shard set the shard belongs to
      * @param shard_id Shard ID
      * @param close_code Close code
      * @param reason Close reason
      */
-    void handle_shard_disconnect(int shard_id, int close_code, const std::string& reason);
+    void handle_shard_disconnect(ShardSet& set, int shard_id, int close_code, const std::string& reason);
 
     /**
      * @brief Handle shard ready event
+     * @param set Shard set the shard belongs to
      * @param shard_id Shard ID
      * @param ready_data Ready event data
      */
-    void handle_shard_ready(int shard_id, const nlohmann::json& ready_data);
+    void handle_shard_ready(ShardSet& set, int shard_id, const nlohmann::json& ready_data);
 
     /**
      * @brief Handle shard resume
+     * @param set Shard set the shard belongs to
+     * @param shard_id Shard ID
+     */
+    void handle_shard_resume(ShardSet& set, int shard_id);
+
+    /**
+     * @brief Report a shard state change unless the set is still warming
+     * @param set Shard set the shard belongs to
      * @param shard_id Shard ID
-     * @param resume_data Resume event data
+     * @param connected New state
      */
-    void handle_shard_resume(int shard_id, const nlohmann::json& resume_data);
+    void notify_shard_state(const ShardSet& set, int shard_id, bool connected);
 
     /**
      * @brief Get gateway information from Discord
@@ -169,28 +292,10 @@ private:
     int calculate_shard_count();
 
     /**
-     * @brief Check if we can start a new session
-     * @return True if session can be started
-     */
-    bool can_start_session();
-
-    /**
-     * @brief Wait for session slot
-     */
-    void wait_for_session_slot();
-
-    /**
-     * @brief Update session start limits
+     * @brief Reset the session start counters once the limit window has passed (takes mutex_)
      */
     void update_session_limits();
 
-    /**
-     * @brief Get shard for guild ID
-     * @param guild_id Guild ID
-     * @return Shard ID that should handle this guild
-     */
-    int get_shard_for_guild(const std::string& guild_id);
-
     /**
      * @brief Validate shard configuration
      * @return True if configuration is valid
@@ -205,16 +310,121 @@ private:
 
     /**
      * @brief Send identify payload for specific shard
+     * @param client Shard connection
      * @param shard_id Shard ID to identify
      */
-    void identify_shard(int shard_id);
+    void identify_shard(WebSocketClient& client, int shard_id);
 
     /**
      * @brief Send resume payload for specific shard
+     * @param client Shard connection
      * @param shard_id Shard ID to resume
-     * @param resume_data Resume data (optional)
      */
-    void resume_shard(int shard_id, const nlohmann::json& resume_data);
+    void resume_shard(WebSocketClient& client, int shard_id);
+
+    /**
+     * @brief Reconnect a shard, resuming its session when possible (mutex_ held)
+     * @param set Shard set the shard belongs to
+     * @param shard_id Shard ID to reconnect
+     * @param resume Whether to attempt resume
+     * @return True if a resume was attempted
+     */
+    bool restart_shard(ShardSet& set, int shard_id, bool resume);
+
+    /**
+     * @brief Map the session store for a shard set and restore its sessions
+     * @param set Shard set about to connect
+     */
+    void open_session_store(ShardSet& set);
+
+    /**
+     * @brief Write the sessions of the active set to the session store
+     */
+    void persist_sessions();
+
+    /**
+     * @brief Update the stored sequence numbers of the active set's sessions
+     *
+     * READY and session invalidation already write the full record, so the
+     * periodic save only needs the sequence number.
+     */
+    void persist_sequences();
+
+    /**
+     * @brief Health monitor loop, runs every health_check_interval
+     */
+    void run_health_monitor();
+
+    /**
+     * @brief Sample heartbeat stats and event rates, and resume silent shards
+     * @param elapsed Time since the previous check
+     * @param last_counts Event counts at the previous check, by shard ID
+     */
+    void check_shard_health(std::chrono::steady_clock::duration elapsed,
+                            std::unordered_map<int, uint64_t>& last_counts);
+
+    /**
+     * @brief Start the health monitor thread
+     */
+    void start_health_monitor();
+
+    /**
+     * @brief Stop the health monitor thread
+     */
+    void stop_health_monitor();
+
+    /**
+     * @brief Body of a reconnect_all() job
+     * @param set Shard set to reconnect
+     * @param job Job number; a newer job cancels this one
+     * @param resumes Shards that resume their session
+     * @param identifies Shards that need a new session
+     */
+    void run_reconnect_job(std::shared_ptr<ShardSet> set, uint64_t job,
+                           std::vector<int> resumes, std::vector<int> identifies);
+
+    /**
+     * @brief Check whether a reconnect job should stop
+     * @param job Job number
+     * @return True if the job was superseded or the manager is stopping
+     */
+    bool is_reconnect_cancelled(uint64_t job) const;
+
+    /**
+     * @brief Create the identify scheduler from the gateway session limits
+     */
+    void create_identify_scheduler();
+
+    /**
+     * @brief Compute the shard range this process owns
+     */
+    void update_shard_range();
+
+    /**
+     * @brief Get the range this process owns for a shard count
+     * @param shard_count Total shard count
+     * @return Owned shard range
+     */
+    ShardRange get_range_for(int shard_count) const;
+
+    /**
+     * @brief Start the shared event loop or the per-group event loops
+     */
+    void start_event_loops();
+
+    /**
+     * @brief Stop and release all event loops
+     *
+     * Takes mutex_ only to detach the loops; they are joined without it.
+     */
+    void stop_event_loops();
+
+    /**
+     * @brief Get the event loop a shard runs on
+     * @param shard_id Shard ID
+     * @return Pool driving the shard's connection
+     */
+    std::shared_ptr<IoContextPool> get_event_loop(int shard_id) const;
 
 public:
     /**
@@ -261,10 +471,18 @@ public:
     void reconnect_shard(int shard_id, bool resume = true);
 
     /**
-     * @brief Reconnect all shards
+     * @brief Reconnect all shards in the background
+     *
+     * Shards holding a session resume in parallel, up to
+     * reconnect_concurrency at a time; RESUMEs do not count against the
+     * identify rate limit. The others queue an IDENTIFY in their rate limit
+     * bucket. No lock is held while waiting, and a new call cancels a
+     * job still running.
+     *
      * @param resume Whether to attempt resume for all shards
+     * @return Future that becomes ready once every shard was reconnected
      */
-    void reconnect_all(bool resume = true);
+    std::future<void> reconnect_all(bool resume = true);
 
     /**
      * @brief Send event to specific shard
@@ -274,6 +492,37 @@ public:
      */
     bool send_to_shard(int shard_id, const nlohmann::json& event);
 
+    /**
+     * @brief Send a gateway command to the shard that owns a guild
+     *
+     * For guild-scoped commands such as REQUEST_GUILD_MEMBERS and voice
+     * state updates, which Discord only accepts on the guild's shard.
+     *
+     * @param guild_id Guild snowflake
+     * @param payload Gateway payload ({"op": ..., "d": ...})
+     * @return True if the owning shard runs in this process and the payload was queued
+     */
+    bool send_to_guild(Snowflake guild_id, const nlohmann::json& payload);
+
+    /**
+     * @brief Request members of a guild over its shard (opcode 8)
+     *
+     * The GUILD_MEMBERS_CHUNK events answering it are consumed by the
+     * member chunker and not passed to the event callback.
+     *
+     * @param guild_id Guild snowflake
+     * @param options Request options
+     * @return Future resolved when the last chunk arrived
+     */
+    std::future<MemberChunkResult> request_guild_members(Snowflake guild_id,
+                                                         const MemberChunkOptions& options = {});
+
+    /**
+     * @brief Get the member chunker (cache and streaming callbacks)
+     * @return Member chunker
+     */
+    MemberChunker& get_member_chunker();
+
     /**
      * @brief Send event to all shards
      * @param event Event to send
@@ -284,9 +533,9 @@ public:
     /**
      * @brief Get shard information
      * @param shard_id Shard ID
-     * @return Shard information or nullptr if not found
+     * @return Snapshot of the shard's state, or nullopt if the shard is not owned
      */
-    const ShardInfo* get_shard_info(int shard_id) const;
+    std::optional<ShardInfo> get_shard_info(int shard_id) const;
 
     /**
      * @brief Get all shard information
@@ -300,12 +549,83 @@ public:
      */
     int get_connected_shard_count() const;
 
+    /**
+     * @brief Get the shard that receives a guild's events
+     * @param guild_id Guild snowflake
+     * @return Shard ID, (guild_id >> 22) % shard_count
+     */
+    int get_shard_for_guild(Snowflake guild_id) const;
+
+    /**
+     * @brief Get the shard that receives a guild's events
+     * @param guild_id Guild ID as sent in JSON
+     * @return Shard ID, or -1 if guild_id is not a snowflake
+     */
+    int get_shard_for_guild(std::string_view guild_id) const;
+
     /**
      * @brief Get total number of shards
      * @return Total shard count
      */
     int get_total_shard_count() const;
 
+    /**
+     * @brief Get the shard range run by this process
+     * @return Owned shard range (all shards unless clustered)
+     */
+    ShardRange get_shard_range() const;
+
+    /**
+     * @brief Get the shard group a shard runs on
+     * @param shard_id Shard ID
+     * @return Group index, or -1 when shard groups are disabled
+     */
+    int get_shard_group(int shard_id) const;
+
+    /**
+     * @brief Get the cluster coordinator
+     * @return Coordinator or nullptr when not clustered
+     */
+    ClusterCoordinator* get_cluster_coordinator() const;
+
+    /**
+     * @brief Restart this cluster while no other cluster on the host restarts
+     * @param timeout Maximum time to wait for the restart lock and for all shards to be ready
+     * @return True if the cluster restarted and all its shards became ready
+     */
+    bool rolling_restart(std::chrono::milliseconds timeout = std::chrono::minutes(10));
+
+    /**
+     * @brief Move to a new shard count without going offline
+     *
+     * Connects a second shard set with the new count next to the running
+     * one and waits until each new shard received READY and the
+     * GUILD_CREATE of every guild it lists (see set_warmup_callback()).
+     * Until then only the old set delivers events. For reshard_overlap
+     * before the switch the events it delivers are remembered; event
+     * delivery then switches to the new set atomically, and for another
+     * reshard_overlap both sets deliver with duplicates dropped. Finally
+     * the old set is disconnected.
+     *
+     * @param new_shard_count Shard count to move to
+     * @param timeout Maximum time for the new set to become ready
+     * @return True if the new set took over
+     */
+    bool reshard(int new_shard_count, std::chrono::milliseconds timeout = std::chrono::minutes(10));
+
+    /**
+     * @brief Check if a reshard is in progress
+     * @return True while reshard() runs
+     */
+    bool is_resharding() const;
+
+    /**
+     * @brief Get gateway round-trip time of a shard
+     * @param shard_id Shard ID
+     * @return Latency of the last acknowledged heartbeat, negative if unknown
+     */
+    std::chrono::milliseconds get_shard_latency(int shard_id) const;
+
     /**
      * @brief Check if shard manager is running
      * @return True if running
@@ -325,6 +645,21 @@ public:
      */
     void set_event_callback(EventCallback callback);
 
+    /**
+     * @brief Set raw frame callback (optional, call before start())
+     *
+     * Receives the text of each dispatch before it is parsed. Returning
+     * true consumes the frame: no JSON document is built and the event
+     * callback does not see it. Passing frames to
+     * EventDispatcher::handle_frame() this way enables its zero-DOM path.
+     * READY, RESUMED, GUILD_CREATE, GUILD_MEMBERS_CHUNK, unknown events and
+     * everything during a reshard's deduplication always take the event
+     * callback, since the manager reads them itself.
+     *
+     * @param callback Function to call with (shard_id, frame)
+     */
+    void set_frame_callback(FrameCallback callback);
+
     /**
      * @brief Set shard state callback
      * @param callback Function to call when shard state changes
@@ -337,6 +672,17 @@ public:
      */
     void set_ready_callback(ReadyCallback callback);
 
+    /**
+     * @brief Set warmup callback
+     *
+     * Receives the GUILD_CREATE events of a shard set that is still warming
+     * up during reshard(); these are not passed to the event callback, so
+     * caches can load the new layout without user handlers firing twice.
+     *
+     * @param callback Function to call with (shard_id, event)
+     */
+    void set_warmup_callback(EventCallback callback);
+
     /**
      * @brief Update shard configuration
      * @param config New configuration
@@ -357,19 +703,25 @@ public:
 
     /**
      * @brief Force identify all shards
+     * @return Future of the reconnect job (see reconnect_all())
      */
-    void identify_all();
+    std::future<void> identify_all();
 
     /**
      * @brief Force resume all shards
+     * @return Future of the reconnect job (see reconnect_all())
      */
-    void resume_all();
+    std::future<void> resume_all();
 
     /**
      * @brief Get shard statistics
-     * @return JSON object with shard statistics
+     *
+     * Reads lock-free counters only. Heartbeat latency, missed ACKs and
+     * event rates are sampled by the health monitor.
+     *
+     * @return Statistics of the active shard set (to_json() for JSON)
      */
-    nlohmann::json get_statistics() const;
+    ShardStatistics get_statistics() const;
 
     /**
      * @brief Enable/disable auto-reconnect for all shards
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "websocket_client.h"
+#include "cluster_coordinator.h"
+#include "shard_state.h"
+#include "../utils/types.h"
+
+namespace discord {
+
+/**
+ * @brief One generation of shard connections for a given shard count
+ *
+ * A ShardManager normally runs a single set. While resharding, a second
+ * set with the new shard count connects next to it and only takes over
+ * event delivery once its shards are ready and warm.
+ */
+struct ShardSet {
+    enum class Role {
+        PENDING,  // Connecting and warming; events are not delivered
+        ACTIVE,   // Delivers events and receives sends
+        RETIRING  // Replaced; still delivers (deduplicated) until torn down
+    };
+
+    uint64_t generation;
+    int shard_count;
+    uint64_t shard_mask; // shard_count - 1 when a power of two, else 0
+    ShardRange range;
+    std::atomic<Role> role{Role::PENDING};
+    std::vector<std::unique_ptr<WebSocketClient>> clients; // Indexed by shard_id - range.first; guarded by ShardManager's mutex
+    ShardStateTable states;
+
+    ShardSet(uint64_t set_generation, int count, const ShardRange& owned_range)
+        : generation(set_generation), shard_count(count),
+          shard_mask(count > 1 && (count & (count - 1)) == 0 ? static_cast<uint64_t>(count - 1) : 0),
+          range(owned_range), clients(static_cast<size_t>(owned_range.size())) {
+        states.reset(range.first, range.size(), shard_count);
+    }
+
+    /**
+     * @brief Get the shard that receives a guild's events
+     * @param guild_id Guild snowflake
+     * @return Shard ID, (guild_id >> 22) % shard_count
+     */
+    int shard_for_guild(Snowflake guild_id) const {
+        uint64_t shard_key = guild_id >> 22;
+        if (shard_mask != 0) {
+            return static_cast<int>(shard_key & shard_mask);
+        }
+        return shard_count > 1 ? static_cast<int>(shard_key % static_cast<uint64_t>(shard_count)) : 0;
+    }
+
+    /**
+     * @brief Get the client slot of a shard
+     * @param shard_id Shard ID
+     * @return Slot, or nullptr if the set does not own the shard
+     */
+    std::unique_ptr<WebSocketClient>* slot(int shard_id) {
+        return range.contains(shard_id) ? &clients[static_cast<size_t>(shard_id - range.first)] : nullptr;
+    }
+
+    /**
+     * @brief Get the client of a shard
+     * @param shard_id Shard ID
+     * @return Client, or nullptr if the shard is not owned or not initialized
+     */
+    WebSocketClient* get_client(int shard_id) const {
+        return range.contains(shard_id) ? clients[static_cast<size_t>(shard_id - range.first)].get() : nullptr;
+    }
+
+    /**
+     * @brief Destroy all clients, keeping shard state for resuming
+     */
+    void clear_clients() {
+        for (auto& client : clients) {
+            client.reset();
+        }
+    }
+
+    ShardSet(const ShardSet&) = delete;
+    ShardSet& operator=(const ShardSet&) = delete;
+};
+
+/**
+ * @brief Drops dispatch events already delivered by another shard set
+ *
+ * During a reshard the old and new shard sets both receive every
+ * dispatch. Events are fingerprinted by type and payload and remembered
+ * for a short window; only the first copy is delivered. Fingerprints are
+ * compared in full, so two distinct events never count as duplicates.
+ * The sequence number is per session and so is not part of it.
+ */
+class EventDeduplicator {
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_WINDOW{30000};
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::chrono::milliseconds window_;
+    std::unordered_set<std::string> seen_;
+    std::deque<std::pair<Clock::time_point, const std::string*>> order_; // Points into seen_, whose nodes do not move
+    mutable std::mutex mutex_;
+
+    /**
+     * @brief Forget fingerprints older than the window (mutex_ held)
+     * @param now Current time
+     */
+    void expire(Clock::time_point now);
+
+public:
+    /**
+     * @brief Construct EventDeduplicator
+     * @param window How long a fingerprint is remembered
+     */
+    explicit EventDeduplicator(std::chrono::milliseconds window = DEFAULT_WINDOW);
+
+    /**
+     * @brief Record an event and check whether it was seen before
+     * @param event Gateway dispatch payload
+     * @return True if this is the first copy and it should be delivered
+     */
+    bool check(const nlohmann::json& event);
+
+    /**
+     * @brief Forget all fingerprints
+     */
+    void clear();
+
+    /**
+     * @brief Get number of remembered fingerprints
+     * @return Fingerprint count
+     */
+    size_t size() const;
+
+    /**
+     * @brief Compute the fingerprint of a dispatch event
+     * @param event Gateway dispatch payload
+     * @return Event type and serialized data
+     */
+    static std::string fingerprint(const nlohmann::json& event);
+};
+
+} // namespace discord
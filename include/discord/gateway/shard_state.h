@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace discord {
+
+/**
+ * @brief Shard information and state (snapshot)
+ */
+struct ShardInfo {
+    int shard_id;
+    int shard_count;
+    std::string session_id;
+    std::string resume_gateway_url;
+    int64_t sequence_number; // -1 until the first dispatch
+    bool is_connected;
+    bool is_resumable;
+    std::chrono::steady_clock::time_point last_heartbeat;
+    std::chrono::steady_clock::time_point connect_time;
+    int reconnect_attempts;
+    uint64_t events_received = 0;
+
+    ShardInfo(int id, int total)
+        : shard_id(id), shard_count(total), sequence_number(-1),
+          is_connected(false), is_resumable(false), reconnect_attempts(0) {}
+};
+
+/**
+ * @brief Health of one shard (snapshot)
+ */
+struct ShardHealth {
+    int shard_id = 0;
+    bool is_connected = false;
+    bool is_resumable = false;
+    int64_t sequence_number = -1;
+    uint64_t events_received = 0;
+    double events_per_second = 0.0;
+    std::chrono::milliseconds heartbeat_latency{-1}; // Negative until the first ACK
+    int missed_acks = 0;
+    uint64_t sequence_gaps = 0;
+    uint32_t zombie_restarts = 0;
+    int reconnect_attempts = 0;
+    std::chrono::milliseconds silence{0}; // Time since the last frame
+    std::chrono::seconds uptime{0};
+};
+
+/**
+ * @brief Live state of one shard
+ *
+ * Each slot starts on its own cache line so shards running on different
+ * threads never share one. Hot fields (sequence number, event count,
+ * flags) are plain atomics written by the shard's own event thread; the
+ * session strings change only on READY and session resets and sit
+ * behind a per-slot mutex.
+ */
+struct alignas(64) ShardState {
+    using Clock = std::chrono::steady_clock;
+
+    std::atomic<int64_t> sequence_number{-1};
+    std::atomic<uint64_t> events_received{0};
+    std::atomic<Clock::rep> last_event{0};
+    std::atomic<Clock::rep> connect_time{0};
+    std::atomic<int> reconnect_attempts{0};
+    std::atomic<int> guilds_pending{-1}; // Guilds from READY not yet seen in GUILD_CREATE
+    std::atomic<uint32_t> handshakes{0};  // READY and RESUMED events received
+    std::atomic<uint64_t> sequence_gaps{0}; // Dispatches skipped between two sequence numbers
+
+    // Written by the health monitor
+    std::atomic<double> events_per_second{0.0};
+    std::atomic<int64_t> heartbeat_latency_ms{-1};
+    std::atomic<int> missed_acks{0};
+    std::atomic<uint32_t> zombie_restarts{0};
+    std::atomic<bool> is_connected{false};
+    std::atomic<bool> is_resumable{false};
+
+    mutable std::mutex session_mutex;
+    std::string session_id;
+    std::string resume_gateway_url;
+
+    /**
+     * @brief Record a new session from READY
+     * @param id Session ID
+     * @param url resume_gateway_url
+     */
+    void set_session(const std::string& id, const std::string& url);
+
+    /**
+     * @brief Forget the session so the next connection identifies
+     */
+    void clear_session();
+
+    /**
+     * @brief Record a (re)connection attempt
+     * @param success Whether the connection was initiated
+     */
+    void record_connect(bool success);
+
+    /**
+     * @brief Check whether every guild announced in READY has arrived
+     * @return True once the shard's GUILD_CREATE burst is complete
+     */
+    bool is_warm() const {
+        return guilds_pending.load(std::memory_order_relaxed) == 0;
+    }
+};
+
+/**
+ * @brief Fixed array of shard states indexed by shard ID
+ *
+ * Lookups are a bounds check and an offset; no lock is taken. The table
+ * is sized once per shard set for the owned shard range.
+ */
+class ShardStateTable {
+private:
+    std::unique_ptr<ShardState[]> states_;
+    int first_shard_ = 0;
+    int size_ = 0;
+    int shard_count_ = 0;
+
+public:
+    /**
+     * @brief Allocate fresh state for a shard range
+     * @param first_shard First owned shard ID
+     * @param size Number of owned shards
+     * @param shard_count Total shard count
+     */
+    void reset(int first_shard, int size, int shard_count);
+
+    /**
+     * @brief Get the state of a shard
+     * @param shard_id Shard ID
+     * @return State or nullptr if the shard is not owned
+     */
+    ShardState* get(int shard_id) {
+        int index = shard_id - first_shard_;
+        return index >= 0 && index < size_ ? &states_[index] : nullptr;
+    }
+
+    const ShardState* get(int shard_id) const {
+        int index = shard_id - first_shard_;
+        return index >= 0 && index < size_ ? &states_[index] : nullptr;
+    }
+
+    /**
+     * @brief Take a consistent copy of a shard's state
+     * @param shard_id Shard ID (must be owned)
+     * @return Shard information
+     */
+    ShardInfo snapshot(int shard_id) const;
+
+    /**
+     * @brief Read a shard's health counters, without taking any lock
+     * @param shard_id Shard ID (must be owned)
+     * @return Shard health
+     */
+    ShardHealth health(int shard_id) const;
+
+    /**
+     * @brief Count connected shards
+     * @return Number of shards whose connection was started and has not closed
+     */
+    int count_connected() const;
+
+    /**
+     * @brief Count shards holding a session
+     * @return Number of shards that received READY
+     */
+    int count_resumable() const;
+
+    /**
+     * @brief Count shards that received all guilds of their READY
+     * @return Number of warm shards
+     */
+    int count_warm() const;
+
+    int first_shard() const { return first_shard_; }
+    int size() const { return size_; }
+};
+
+} // namespace discord
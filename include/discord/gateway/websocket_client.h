@@ -1,9 +1,16 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>
 #include <functional>
 #include <nlohmann/json.hpp>
 #include "reconnection.h"
+#include "heartbeat_scheduler.h"
+#include "io_context_pool.h"
+#include "send_queue.h"
+#include "../events/typed_events.h"
 
 namespace discord {
 
@@ -41,23 +48,50 @@ enum class GatewayCloseEvent {
 class WebSocketClient {
 public:
     using EventCallback = std::function<void(const nlohmann::json&)>;
+    // Sees the raw text of a dispatch before it is parsed; returning true consumes it
+    using FrameCallback = std::function<bool(std::string_view, const FrameHeader&)>;
     using CloseCallback = std::function<void(int, const std::string&)>;
+    // Receives the IDENTIFY send and runs it once a session start slot is free
+    using IdentifyGate = std::function<void(std::function<void()>)>;
 
     WebSocketClient();
+    // Run on a shared event loop instead of a dedicated I/O thread
+    explicit WebSocketClient(std::shared_ptr<IoContextPool> io_pool);
     ~WebSocketClient();
 
-    bool connect(const std::string& url);
-    void disconnect();
+    // With resume set and a session held, dials resume_gateway_url and resumes after HELLO
+    bool connect(const std::string& url, bool resume = false);
+    // Closes without invalidating the session and reconnects, resuming when possible
+    bool reconnect(bool resume = true);
+    // keep_session closes with a non-1000 code so the session can be resumed later
+    void disconnect(bool keep_session = false);
     bool is_connected() const;
 
+    // Payloads are queued and sent within the gateway's 120 commands / 60s limit
     void send(const nlohmann::json& payload);
+    void send_serialized(std::string payload, bool priority = false);
+    size_t get_pending_send_count() const;
     
     void on_event(EventCallback callback);
+    // Optional; READY, RESUMED and unknown events always go to on_event
+    void on_frame(FrameCallback callback);
     void on_close(CloseCallback callback);
 
     void set_token(const std::string& token);
     void set_intents(int intents);
+    void set_shard(int shard_id, int shard_count);
+    
+    // Handshakes are deferred until HELLO arrives on the current connection
     void identify();
+    void resume();
+    void set_identify_gate(IdentifyGate gate);
+    
+    // Session state (sequence is -1 until the first dispatch)
+    std::string get_session_id() const;
+    std::string get_resume_gateway_url() const;
+    int64_t get_sequence() const;
+    void restore_session(const std::string& session_id, int64_t sequence,
+                         const std::string& resume_gateway_url);
     
     // Reconnection management
     void enable_auto_reconnect(bool enabled);
@@ -67,6 +101,10 @@ public:
     bool is_reconnecting() const;
     void stop_reconnecting();
     
+    // Heartbeat and latency
+    std::chrono::milliseconds get_latency() const;
+    HeartbeatStats get_heartbeat_stats() const;
+    
     // Compression support
     void enable_compression(bool enabled);
     bool is_compression_enabled() const;
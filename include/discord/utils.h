@@ -9,6 +9,7 @@
 #include "utils/types.h"
 #include "utils/logger.h"
 #include "utils/thread_pool.h"
+#include "utils/keyed_executor.h"
 #include "utils/config_manager.h"
 #include "utils/auth.h"
 #include "utils/embed_builder.h"
@@ -20,6 +21,7 @@ namespace discord::utils {
     
     using discord::Logger;
     using discord::ThreadPool;
+    using discord::KeyedExecutor;
     using discord::ConfigManager;
     using discord::Auth;
     using discord::EmbedBuilder;
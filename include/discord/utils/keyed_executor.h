@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../core/interfaces.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace discord {
+
+/**
+ * @brief Runs tasks on a thread pool, serially per key
+ *
+ * Tasks submitted with the same key run one at a time in submission
+ * order; tasks with different keys run in parallel on the pool's
+ * workers. Each key with pending work has a queue and at most one drain
+ * job on the pool, so a busy key never occupies more than one worker.
+ * Keys are spread over mutex-guarded stripes, so submitters for
+ * different keys rarely contend.
+ */
+class KeyedExecutor : public std::enable_shared_from_this<KeyedExecutor> {
+public:
+    using Task = std::function<void()>;
+
+    static constexpr size_t STRIPE_COUNT = 64;
+    static constexpr size_t MAX_BATCH = 64; // Tasks a drain job runs before yielding its worker
+
+private:
+    struct KeyQueue {
+        std::deque<Task> tasks;
+    };
+
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, KeyQueue> queues; // Only keys with a scheduled drain job
+    };
+
+    std::shared_ptr<IThreadPool> pool_;
+    std::array<Stripe, STRIPE_COUNT> stripes_;
+    std::atomic<size_t> pending_{0};
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+
+    /**
+     * @brief Get the stripe of a key
+     * @param key Ordering key
+     * @return Stripe
+     */
+    Stripe& stripe_for(uint64_t key);
+
+    /**
+     * @brief Schedule a drain job for a key on the pool
+     * @param key Ordering key
+     */
+    void schedule(uint64_t key);
+
+    /**
+     * @brief Run a batch of a key's tasks, then reschedule or retire the key
+     * @param key Ordering key
+     */
+    void drain(uint64_t key);
+
+    /**
+     * @brief Account for a finished task
+     */
+    void task_done();
+
+public:
+    /**
+     * @brief Construct KeyedExecutor
+     * @param pool Thread pool running the tasks
+     */
+    explicit KeyedExecutor(std::shared_ptr<IThreadPool> pool);
+
+    KeyedExecutor(const KeyedExecutor&) = delete;
+    KeyedExecutor& operator=(const KeyedExecutor&) = delete;
+
+    /**
+     * @brief Submit a task
+     *
+     * The executor must be owned by a shared_ptr, which drain jobs keep
+     * alive.
+     *
+     * @param key Ordering key
+     * @param task Task to run after earlier tasks of the same key
+     */
+    void submit(uint64_t key, Task task);
+
+    /**
+     * @brief Wait until every submitted task has run
+     * @param timeout Maximum wait time
+     * @return True if no tasks are pending
+     */
+    bool wait_idle(std::chrono::milliseconds timeout = std::chrono::milliseconds(30000));
+
+    /**
+     * @brief Get number of submitted tasks that have not finished
+     * @return Pending task count
+     */
+    size_t get_pending_count() const;
+};
+
+} // namespace discord
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <chrono>
+#include <charconv>
+#include <cstdint>
 #include <optional>
 #include <variant>
 #include <nlohmann/json.hpp>
@@ -79,6 +82,23 @@ public:
     }
 };
 
+// Discord IDs are 64-bit snowflakes, sent as strings in JSON
+using Snowflake = uint64_t;
+
+/**
+ * @brief Parse a snowflake from its decimal string form
+ * @param text Decimal ID
+ * @return ID, or nullopt if text is not a valid snowflake
+ */
+inline std::optional<Snowflake> parse_snowflake(std::string_view text) {
+    Snowflake id = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), id);
+    if (ec != std::errc() || end != text.data() + text.size() || text.empty()) {
+        return std::nullopt;
+    }
+    return id;
+}
+
 enum class GatewayIntent {
     GUILDS = 1 << 0,
     GUILD_MEMBERS = 1 << 1,
@@ -6,7 +6,6 @@
 #include <discord/events/event_dispatcher.h>
 #include <discord/utils/types.h>
 
-#include <thread>
 #include <chrono>
 
 namespace discord {
@@ -100,9 +99,8 @@ private:
                 handle_dispatch(event);
                 break;
             case static_cast<int>(GatewayOpcode::HELLO):
-                handle_hello(event);
-                break;
             case static_cast<int>(GatewayOpcode::HEARTBEAT_ACK):
+                // Heartbeating is driven by WebSocketClient through the shared HeartbeatScheduler
                 break;
             default:
                 break;
@@ -132,22 +130,6 @@ private:
         event_handler_.handle_dispatch(event);
     }
     
-    void handle_hello(const nlohmann::json& event) {
-        if (event.contains("d") && event["d"].contains("heartbeat_interval")) {
-            int heartbeat_interval = event["d"]["heartbeat_interval"];
-            std::thread([this, heartbeat_interval]() {
-                while (websocket_client_.is_connected()) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(heartbeat_interval));
-                    if (websocket_client_.is_connected()) {
-                        nlohmann::json heartbeat;
-                        heartbeat["op"] = static_cast<int>(GatewayOpcode::HEARTBEAT);
-                        websocket_client_.send(heartbeat);
-                    }
-                }
-            }).detach();
-        }
-    }
-    
     std::string token_;
     HTTPClient http_client_;
     WebSocketClient websocket_client_;
@@ -0,0 +1,496 @@
+#include <discord/events/content_matcher.h>
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <limits>
+
+namespace discord {
+
+namespace {
+
+constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t HAS_OUTPUT = uint32_t(1) << 31; // Set on transitions into states that end a key
+constexpr size_t MIN_REGEX_LITERAL = 3; // Shorter literals would send most messages to the regex
+constexpr size_t MAX_DENSE_CELLS = size_t(1) << 24; // 64 MiB of transitions before falling back to sparse edges
+
+bool is_word_byte(uint8_t byte) {
+    // Bytes of multi-byte UTF-8 sequences count as letters
+    return byte >= 0x80 || byte == '_' ||
+           (byte >= '0' && byte <= '9') || (byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z');
+}
+
+bool is_alnum(char c) {
+    return is_word_byte(static_cast<uint8_t>(c)) && c != '_' && static_cast<uint8_t>(c) < 0x80;
+}
+
+/**
+ * @brief Skip a quantifier at position, if any
+ * @return Whether the quantified atom may occur zero times
+ */
+bool skip_quantifier(std::string_view pattern, size_t& position, bool& quantified) {
+    quantified = false;
+    if (position >= pattern.size()) {
+        return false;
+    }
+
+    bool optional = false;
+    char c = pattern[position];
+    if (c == '*' || c == '?') {
+        optional = true;
+        position++;
+    } else if (c == '+') {
+        position++;
+    } else if (c == '{') {
+        size_t close = pattern.find('}', position);
+        if (close == std::string_view::npos) {
+            return false;
+        }
+        optional = pattern.substr(position + 1, 1) == "0" || pattern.substr(position + 1, 1) == ",";
+        position = close + 1;
+    } else {
+        return false;
+    }
+
+    quantified = true;
+    if (position < pattern.size() && pattern[position] == '?') {
+        position++; // Lazy quantifier
+    }
+    return optional;
+}
+
+/**
+ * @brief Find the longest literal every match of a regex must contain
+ *
+ * Conservative: alternations disable extraction, and groups, classes and
+ * escapes other than escaped punctuation (operands included) end a
+ * literal run.
+ *
+ * @param pattern ECMAScript pattern
+ * @return Literal, or empty if none was found
+ */
+std::string required_literal(std::string_view pattern) {
+    if (pattern.find('|') != std::string_view::npos) {
+        return "";
+    }
+
+    std::string best;
+    std::string run;
+    auto flush = [&best, &run]() {
+        if (run.size() > best.size()) {
+            best = run;
+        }
+        run.clear();
+    };
+
+    int depth = 0;
+    size_t position = 0;
+    while (position < pattern.size()) {
+        char c = pattern[position];
+        bool literal = false;
+        char value = c;
+
+        if (c == '\\' && position + 1 < pattern.size()) {
+            value = pattern[position + 1];
+            literal = !is_alnum(value);
+            position += 2;
+
+            // Skip the operands of \xHH, \uHHHH, \cX, \0 and backreferences so they are not read as text
+            if (value == 'x') {
+                position += 2;
+            } else if (value == 'u') {
+                position += 4;
+            } else if (value == 'c') {
+                position += 1;
+            } else if (value >= '0' && value <= '9') {
+                while (position < pattern.size() && pattern[position] >= '0' && pattern[position] <= '9') {
+                    position++;
+                }
+            }
+            position = std::min(position, pattern.size());
+        } else if (c == '[') {
+            size_t close = position + 1;
+            if (close < pattern.size() && pattern[close] == '^') close++;
+            if (close < pattern.size() && pattern[close] == ']') close++;
+            while (close < pattern.size() && pattern[close] != ']') {
+                close += pattern[close] == '\\' ? 2 : 1;
+            }
+            position = close + 1;
+        } else if (c == '(') {
+            depth++;
+            position++;
+            if (pattern.substr(position, 2) == "?:" || pattern.substr(position, 2) == "?=" ||
+                pattern.substr(position, 2) == "?!") {
+                position += 2;
+            }
+            flush();
+            continue;
+        } else if (c == ')') {
+            depth--;
+            position++;
+        } else {
+            literal = c != '.' && c != '^' && c != '$' && c != '*' && c != '+' && c != '?' && c != '{';
+            position++;
+        }
+
+        bool quantified = false;
+        bool optional = skip_quantifier(pattern, position, quantified);
+
+        if (!literal || depth > 0 || optional) {
+            flush();
+            continue;
+        }
+
+        run += value;
+        if (quantified) {
+            flush(); // A repeated character ends the run it belongs to
+        }
+    }
+    flush();
+
+    return best.size() >= MIN_REGEX_LITERAL ? best : "";
+}
+
+} // namespace
+
+struct ContentMatcher::Automaton {
+    struct State {
+        uint32_t fail = 0;
+        uint32_t dict_link = NONE;  // Nearest state on the failure chain that ends a key
+        uint32_t edges_begin = 0;
+        uint32_t edges_end = 0;
+        uint32_t keys_begin = 0;
+        uint32_t keys_end = 0;
+    };
+
+    struct Edge {
+        uint8_t byte;
+        uint32_t target;
+    };
+
+    // A term, or the required literal of a regex
+    struct Key {
+        uint32_t pattern;  // Pattern ID for terms, regex slot for regexes
+        uint32_t length;
+        bool whole_word;
+        bool is_regex;
+    };
+
+    struct Regex {
+        uint32_t pattern;
+        std::shared_ptr<const std::regex> regex;
+    };
+
+    std::array<uint8_t, 256> fold{};
+    std::array<uint32_t, 256> root_next{};   // Root transitions by folded byte, 0 = stay
+    std::array<bool, 256> starts{};          // Raw bytes that leave the root
+    std::array<uint16_t, 256> byte_class{};  // Raw byte to dense table column; 0 for bytes in no key
+    uint32_t class_count = 1;
+    std::vector<uint32_t> dense;             // Full transition table, state * class_count + class, with HAS_OUTPUT
+    std::vector<State> states;
+    std::vector<Edge> edges;
+    std::vector<Key> keys;
+    std::vector<Regex> regexes;
+    std::vector<uint32_t> unfiltered_regexes; // Regex slots without a literal, run on every scan
+    size_t pattern_count = 0;
+
+    uint32_t find_edge(uint32_t state, uint8_t byte) const {
+        auto begin = edges.begin() + states[state].edges_begin;
+        auto end = edges.begin() + states[state].edges_end;
+        auto it = std::lower_bound(begin, end, byte, [](const Edge& edge, uint8_t b) { return edge.byte < b; });
+        return it != end && it->byte == byte ? it->target : NONE;
+    }
+
+    uint32_t step(uint32_t state, uint8_t byte) const {
+        while (state != 0) {
+            uint32_t target = find_edge(state, byte);
+            if (target != NONE) {
+                return target;
+            }
+            state = states[state].fail;
+        }
+        return root_next[byte];
+    }
+
+    bool has_output(uint32_t state) const {
+        return states[state].keys_begin != states[state].keys_end || states[state].dict_link != NONE;
+    }
+
+    // Returns the next state, with HAS_OUTPUT set if it ends a key
+    uint32_t next(uint32_t state, uint8_t raw_byte) const {
+        if (!dense.empty()) {
+            return dense[static_cast<size_t>(state) * class_count + byte_class[raw_byte]];
+        }
+        uint32_t target = step(state, fold[raw_byte]);
+        return has_output(target) ? target | HAS_OUTPUT : target;
+    }
+
+    // Calls on_key(key, end) for every key occurrence until it returns true
+    template<typename OnKey>
+    void scan(std::string_view content, OnKey&& on_key) const {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(content.data());
+        size_t size = content.size();
+        uint32_t state = 0;
+
+        for (size_t i = 0; i < size; ++i) {
+            if (state == 0) {
+                while (i < size && !starts[bytes[i]]) {
+                    ++i;
+                }
+                if (i == size) {
+                    break;
+                }
+            }
+
+            uint32_t entry = next(state, bytes[i]);
+            state = entry & ~HAS_OUTPUT;
+            if (!(entry & HAS_OUTPUT)) {
+                continue;
+            }
+
+            uint32_t output = states[state].keys_begin != states[state].keys_end ? state : states[state].dict_link;
+            for (; output != NONE; output = states[output].dict_link) {
+                for (uint32_t k = states[output].keys_begin; k < states[output].keys_end; ++k) {
+                    if (on_key(keys[k], i + 1)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    bool word_bounded(std::string_view content, const Key& key, size_t end) const {
+        size_t start = end - key.length;
+        return (start == 0 || !is_word_byte(static_cast<uint8_t>(content[start - 1]))) &&
+               (end == content.size() || !is_word_byte(static_cast<uint8_t>(content[end])));
+    }
+};
+
+// ContentPatternSet implementation
+
+ContentPatternSet::ContentPatternSet(bool case_insensitive)
+    : case_insensitive_(case_insensitive) {}
+
+size_t ContentPatternSet::add_term(std::string term, bool whole_word) {
+    patterns_.push_back({std::move(term), nullptr, whole_word});
+    return patterns_.size() - 1;
+}
+
+size_t ContentPatternSet::add_regex(const std::string& pattern) {
+    auto flags = std::regex::ECMAScript | std::regex::optimize;
+    if (case_insensitive_) {
+        flags |= std::regex::icase;
+    }
+    patterns_.push_back({pattern, std::make_shared<const std::regex>(pattern, flags), false});
+    return patterns_.size() - 1;
+}
+
+ContentMatcher ContentPatternSet::compile() const {
+    using Automaton = ContentMatcher::Automaton;
+
+    auto automaton = std::make_shared<Automaton>();
+    automaton->pattern_count = patterns_.size();
+    for (size_t b = 0; b < 256; ++b) {
+        automaton->fold[b] = case_insensitive_ && b >= 'A' && b <= 'Z' ? static_cast<uint8_t>(b + ('a' - 'A'))
+                                                                      : static_cast<uint8_t>(b);
+    }
+
+    // Build the trie with per-state child lists, then flatten it
+    struct TrieNode {
+        std::vector<std::pair<uint8_t, uint32_t>> children;
+        std::vector<Automaton::Key> keys;
+    };
+    std::vector<TrieNode> trie(1);
+
+    auto insert = [&trie, &automaton](std::string_view text, Automaton::Key key) {
+        uint32_t node = 0;
+        for (char c : text) {
+            uint8_t byte = automaton->fold[static_cast<uint8_t>(c)];
+            auto& children = trie[node].children;
+            auto it = std::find_if(children.begin(), children.end(),
+                [byte](const auto& child) { return child.first == byte; });
+            if (it != children.end()) {
+                node = it->second;
+            } else {
+                uint32_t next = static_cast<uint32_t>(trie.size());
+                children.emplace_back(byte, next);
+                trie.emplace_back();
+                node = next;
+            }
+        }
+        key.length = static_cast<uint32_t>(text.size());
+        trie[node].keys.push_back(key);
+    };
+
+    for (size_t id = 0; id < patterns_.size(); ++id) {
+        const auto& pattern = patterns_[id];
+        if (!pattern.regex) {
+            if (!pattern.text.empty()) {
+                insert(pattern.text, {static_cast<uint32_t>(id), 0, pattern.whole_word, false});
+            }
+            continue;
+        }
+
+        uint32_t slot = static_cast<uint32_t>(automaton->regexes.size());
+        automaton->regexes.push_back({static_cast<uint32_t>(id), pattern.regex});
+
+        std::string literal = required_literal(pattern.text);
+        if (literal.empty()) {
+            automaton->unfiltered_regexes.push_back(slot);
+        } else {
+            insert(literal, {slot, 0, false, true});
+        }
+    }
+
+    auto& states = automaton->states;
+    states.resize(trie.size());
+    for (size_t node = 0; node < trie.size(); ++node) {
+        auto& children = trie[node].children;
+        std::sort(children.begin(), children.end());
+
+        states[node].edges_begin = static_cast<uint32_t>(automaton->edges.size());
+        for (const auto& [byte, target] : children) {
+            automaton->edges.push_back({byte, target});
+        }
+        states[node].edges_end = static_cast<uint32_t>(automaton->edges.size());
+
+        states[node].keys_begin = static_cast<uint32_t>(automaton->keys.size());
+        automaton->keys.insert(automaton->keys.end(), trie[node].keys.begin(), trie[node].keys.end());
+        states[node].keys_end = static_cast<uint32_t>(automaton->keys.size());
+    }
+
+    for (const auto& [byte, target] : trie[0].children) {
+        automaton->root_next[byte] = target;
+    }
+    for (size_t b = 0; b < 256; ++b) {
+        automaton->starts[b] = automaton->root_next[automaton->fold[b]] != 0;
+    }
+
+    // Failure and output links, breadth first so shorter suffixes are done first
+    std::vector<uint32_t> order;
+    std::deque<uint32_t> queue;
+    for (const auto& child : trie[0].children) {
+        queue.push_back(child.second);
+    }
+    while (!queue.empty()) {
+        uint32_t node = queue.front();
+        queue.pop_front();
+        order.push_back(node);
+
+        for (const auto& [byte, target] : trie[node].children) {
+            uint32_t fail = automaton->step(states[node].fail, byte);
+            states[target].fail = fail;
+            states[target].dict_link = states[fail].keys_begin != states[fail].keys_end ? fail : states[fail].dict_link;
+            queue.push_back(target);
+        }
+    }
+
+    // Bytes that appear in no key behave alike and share column 0
+    std::array<uint16_t, 256> folded_class{};
+    std::vector<uint8_t> class_byte(1, 0);
+    for (const auto& edge : automaton->edges) {
+        if (folded_class[edge.byte] == 0) {
+            folded_class[edge.byte] = static_cast<uint16_t>(class_byte.size());
+            class_byte.push_back(edge.byte);
+        }
+    }
+    for (size_t b = 0; b < 256; ++b) {
+        automaton->byte_class[b] = folded_class[automaton->fold[b]];
+    }
+    automaton->class_count = static_cast<uint32_t>(class_byte.size());
+
+    // A dense table removes failure-link walks from the scan when it fits the budget
+    if (states.size() * automaton->class_count <= MAX_DENSE_CELLS) {
+        size_t width = automaton->class_count;
+        auto& dense = automaton->dense;
+        dense.assign(states.size() * width, 0);
+        auto entry = [&automaton](uint32_t target) {
+            return automaton->has_output(target) ? target | HAS_OUTPUT : target;
+        };
+        for (size_t c = 1; c < width; ++c) {
+            dense[c] = entry(automaton->root_next[class_byte[c]]);
+        }
+        // Parents and failure targets come earlier in breadth-first order
+        for (uint32_t node : order) {
+            uint32_t fail = states[node].fail;
+            for (size_t c = 1; c < width; ++c) {
+                uint32_t target = automaton->find_edge(node, class_byte[c]);
+                dense[node * width + c] = target != NONE ? entry(target) : dense[fail * width + c];
+            }
+        }
+    }
+
+    return ContentMatcher(std::move(automaton));
+}
+
+// ContentMatcher implementation
+
+ContentMatcher::ContentMatcher(std::shared_ptr<const Automaton> automaton)
+    : automaton_(std::move(automaton)) {}
+
+bool ContentMatcher::matches(std::string_view content) const {
+    if (!automaton_) {
+        return false;
+    }
+
+    const Automaton& automaton = *automaton_;
+    auto run_regex = [&automaton, content](uint32_t slot) {
+        return std::regex_search(content.begin(), content.end(), *automaton.regexes[slot].regex);
+    };
+
+    bool found = false;
+    std::vector<uint32_t> tried;
+    automaton.scan(content, [&](const Automaton::Key& key, size_t end) {
+        if (!key.is_regex) {
+            found = !key.whole_word || automaton.word_bounded(content, key, end);
+        } else if (std::find(tried.begin(), tried.end(), key.pattern) == tried.end()) {
+            tried.push_back(key.pattern);
+            found = run_regex(key.pattern);
+        }
+        return found;
+    });
+
+    if (!found) {
+        found = std::any_of(automaton.unfiltered_regexes.begin(), automaton.unfiltered_regexes.end(), run_regex);
+    }
+    return found;
+}
+
+std::vector<size_t> ContentMatcher::find_all(std::string_view content) const {
+    std::vector<size_t> matched;
+    if (!automaton_) {
+        return matched;
+    }
+
+    const Automaton& automaton = *automaton_;
+    std::vector<uint32_t> candidates = automaton.unfiltered_regexes;
+    automaton.scan(content, [&](const Automaton::Key& key, size_t end) {
+        if (key.is_regex) {
+            candidates.push_back(key.pattern);
+        } else if (!key.whole_word || automaton.word_bounded(content, key, end)) {
+            matched.push_back(key.pattern);
+        }
+        return false;
+    });
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    for (uint32_t slot : candidates) {
+        if (std::regex_search(content.begin(), content.end(), *automaton.regexes[slot].regex)) {
+            matched.push_back(automaton.regexes[slot].pattern);
+        }
+    }
+
+    std::sort(matched.begin(), matched.end());
+    matched.erase(std::unique(matched.begin(), matched.end()), matched.end());
+    return matched;
+}
+
+size_t ContentMatcher::pattern_count() const {
+    return automaton_ ? automaton_->pattern_count : 0;
+}
+
+size_t ContentMatcher::state_count() const {
+    return automaton_ ? automaton_->states.size() : 0;
+}
+
+} // namespace discord
@@ -1,135 +1,57 @@
 #include <discord/events/event_dispatcher.h>
 #include <discord/utils/logger.h>
+#include <discord/utils/types.h>
 #include <algorithm>
+#include <utility>
 #include <random>
-#include <regex>
 #include <condition_variable>
 
 namespace discord {
 
-// EventCollector template implementations
+// MiddlewareChain implementation
 
-template<typename T>
-std::string EventCollector<T>::start(EventDispatcher* dispatcher, const std::string& event_name) {
-    if (is_active_) {
-        return handler_id_;
-    }
-    
-    std::string collector_id = "collector_" + std::to_string(reinterpret_cast<uintptr_t>(this));
-    handler_id_ = collector_id;
-    is_active_ = true;
-    start_time_ = std::chrono::steady_clock::now();
-    
-    // Register collector callback with dispatcher
-    auto callback = [this](const nlohmann::json& event) {
-        if (!is_active_) {
-            return;
-        }
-        
-        try {
-            T typed_event = event; // This requires T to be constructible from json
-            if (!filter_ || filter_(typed_event)) {
-                std::unique_lock<std::shared_mutex> lock(mutex_);
-                collected_items_.push_back(std::move(typed_event));
-                
-                if (should_stop_collecting()) {
-                    lock.unlock();
-                    stop();
-                }
-            }
-        } catch (const std::exception& e) {
-            LOG_ERROR("Event collector error: " + std::string(e.what()));
-        }
-    };
-    
-    dispatcher->on(event_name, std::move(callback), 0, collector_id);
-    return collector_id;
-}
-
-template<typename T>
-void EventCollector<T>::stop() {
-    if (!is_active_) {
+void MiddlewareNext::operator()() const {
+    if (index_ >= chain_->size()) {
+        invoke_handler_(handler_);
         return;
     }
     
-    is_active_ = false;
+    auto& middleware = chain_->at(index_);
+    MiddlewareNext next(chain_, index_ + 1, *event_name_, *event_data_, handler_, invoke_handler_);
     
-    // TODO: Remove handler from dispatcher
-    // This requires dispatcher to provide removal by ID
-}
-
-template<typename T>
-bool EventCollector<T>::process_event(const nlohmann::json& event) {
-    if (!is_active_) {
-        return false;
-    }
-    
-    if (is_timed_out()) {
-        if (config_.dispose_on_timeout) {
-            stop();
-        }
-        return false;
-    }
-    
-    try {
-        T typed_event = event;
-        if (!filter_ || filter_(typed_event)) {
-            std::unique_lock<std::shared_mutex> lock(mutex_);
-            collected_items_.push_back(std::move(typed_event));
-            
-            return should_stop_collecting();
-        }
-    } catch (const std::exception& e) {
-        LOG_ERROR("Event collector processing error: " + std::string(e.what()));
-    }
-    
-    return false;
-}
-
-template<typename T>
-std::optional<T> EventCollector<T>::wait_for_first(std::chrono::milliseconds timeout) {
-    auto deadline = std::chrono::steady_clock::now() + timeout;
-    
-    while (is_active_ && std::chrono::steady_clock::now() < deadline) {
-        {
-            std::shared_lock<std::shared_mutex> lock(mutex_);
-            if (!collected_items_.empty()) {
-                return collected_items_.front();
-            }
-        }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (!middleware.process(*event_name_, *event_data_, next)) {
+        LOG_DEBUG("Middleware " + middleware.get_name() + " blocked event: " + *event_name_);
     }
-    
-    return first();
 }
 
-template<typename T>
-std::vector<T> EventCollector<T>::wait_for_all(std::chrono::milliseconds timeout) {
-    auto deadline = std::chrono::steady_clock::now() + timeout;
-    
-    while (is_active_ && std::chrono::steady_clock::now() < deadline) {
-        {
-            std::shared_lock<std::shared_mutex> lock(mutex_);
-            if (should_stop_collecting()) {
-                return collected_items_;
-            }
-        }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
+MiddlewareChain::MiddlewareChain(MiddlewareList middleware)
+    : middleware_(std::move(middleware)) {
+    middleware_.erase(std::remove(middleware_.begin(), middleware_.end(), nullptr), middleware_.end());
     
-    return get_collected();
+    // Sort by priority (higher priority first); equal priorities keep insertion order
+    std::stable_sort(middleware_.begin(), middleware_.end(),
+        [](const auto& a, const auto& b) {
+            return a->get_priority() > b->get_priority();
+        });
 }
 
 // EventDispatcher implementation
 
 EventDispatcher::EventDispatcher() 
-    : start_time_(std::chrono::steady_clock::now()) {
+    : custom_handlers_(std::make_shared<const EventMap>())
+    , middleware_(std::make_shared<const MiddlewareChain>())
+    , start_time_(std::chrono::steady_clock::now()) {
     LOG_INFO("EventDispatcher initialized");
 }
 
 EventDispatcher::~EventDispatcher() {
+    // Queued events still refer to this dispatcher, so every one of them must finish first
+    if (auto previous = executor_.exchange(nullptr, std::memory_order_acq_rel)) {
+        while (!previous->wait_idle()) {
+            LOG_WARN("EventDispatcher still waiting for " + std::to_string(previous->get_pending_count()) +
+                     " queued events before destruction");
+        }
+    }
     clear();
     LOG_INFO("EventDispatcher destroyed");
 }
@@ -141,36 +63,66 @@ std::string EventDispatcher::on(const std::string& event_name,
                                bool once) {
     std::string final_handler_id = handler_id;
     if (final_handler_id.empty()) {
-        final_handler_id = "handler_" + std::to_string(reinterpret_cast<uintptr_t>(callback.target_type()));
+        final_handler_id = "handler_" + std::to_string(++next_handler_id_);
     }
     
-    std::unique_lock<std::shared_mutex> lock(handlers_mutex_);
+    EventType type = event_type_from_name(event_name);
     
-    EventHandlerInfo info(std::move(callback), priority, final_handler_id, once);
-    handlers_[event_name].push_back(std::move(info));
+    std::lock_guard<std::mutex> lock(handlers_mutex_);
     
-    // Sort handlers by priority (higher priority first)
-    sort_handlers(handlers_[event_name]);
+    update_handlers(type, event_name, [&](HandlerList& handlers) {
+        handlers.emplace_back(std::move(callback), priority, final_handler_id, once);
+        
+        // Sort handlers by priority (higher priority first)
+        sort_handlers(handlers);
+        return true;
+    });
     
     LOG_DEBUG("Registered handler for event: " + event_name + " with ID: " + final_handler_id);
     return final_handler_id;
 }
 
+std::string EventDispatcher::on(EventType type,
+                               EventCallback callback,
+                               int priority,
+                               const std::string& handler_id,
+                               bool once) {
+    return on(event_type_name(type), std::move(callback), priority, handler_id, once);
+}
+
+void ITypedHandlerList::report_error(EventType type, const std::exception& error) {
+    LOG_ERROR("Event handler error for " + event_type_name(type) + ": " + std::string(error.what()));
+}
+
 bool EventDispatcher::off(const std::string& event_name, const std::string& handler_id) {
-    std::unique_lock<std::shared_mutex> lock(handlers_mutex_);
+    auto remove_from = [&handler_id](HandlerList& handlers) {
+        auto handler_it = std::remove_if(handlers.begin(), handlers.end(),
+            [&handler_id](const EventHandlerInfo& info) {
+                return info.id == handler_id;
+            });
+        bool found = handler_it != handlers.end();
+        handlers.erase(handler_it, handlers.end());
+        return found;
+    };
     
-    auto it = handlers_.find(event_name);
-    if (it == handlers_.end()) {
-        return false;
-    }
+    std::lock_guard<std::mutex> lock(handlers_mutex_);
     
-    auto& handlers = it->second;
-    auto handler_it = std::remove_if(handlers.begin(), handlers.end(),
-        [&handler_id](const EventHandlerInfo& info) {
-            return info.id == handler_id;
-        });
+    bool removed = false;
+    if (event_name.empty()) {
+        for (size_t i = 0; i < EVENT_TYPE_COUNT; ++i) {
+            removed |= update_handlers(static_cast<EventType>(i), "", remove_from);
+            removed |= remove_typed_handlers(static_cast<EventType>(i), {handler_id});
+        }
+        auto custom = custom_handlers_.load(std::memory_order_acquire);
+        for (const auto& [name, handlers] : *custom) {
+            removed |= update_handlers(EventType::UNKNOWN, name, remove_from);
+        }
+    } else {
+        EventType type = event_type_from_name(event_name);
+        removed = update_handlers(type, event_name, remove_from);
+        removed |= remove_typed_handlers(type, {handler_id});
+    }
     
-    bool removed = handler_it != handlers.end();
     if (removed) {
         LOG_DEBUG("Removed handler for event: " + event_name + " with ID: " + handler_id);
     }
@@ -179,65 +131,31 @@ bool EventDispatcher::off(const std::string& event_name, const std::string& hand
 }
 
 size_t EventDispatcher::off_all(const std::string& event_name) {
-    std::unique_lock<std::shared_mutex> lock(handlers_mutex_);
+    EventType type = event_type_from_name(event_name);
     
-    auto it = handlers_.find(event_name);
-    if (it == handlers_.end()) {
-        return 0;
-    }
+    std::lock_guard<std::mutex> lock(handlers_mutex_);
     
-    size_t count = it->second.size();
-    handlers_.erase(it);
+    size_t count = 0;
+    update_handlers(type, event_name, [&count](HandlerList& handlers) {
+        count = handlers.size();
+        handlers.clear();
+        return count > 0;
+    });
+    if (type != EventType::UNKNOWN) {
+        auto typed = typed_handlers_[static_cast<size_t>(type)].exchange(nullptr, std::memory_order_acq_rel);
+        count += typed ? typed->size() : 0;
+    }
     
     LOG_DEBUG("Removed all " + std::to_string(count) + " handlers for event: " + event_name);
     return count;
 }
 
 void EventDispatcher::emit(const std::string& event_name, const nlohmann::json& event_data) {
-    update_stats();
-    
-    execute_middleware_chain(event_name, event_data, [this, &event_name, &event_data]() {
-        std::shared_lock<std::shared_mutex> lock(handlers_mutex_);
-        
-        auto it = handlers_.find(event_name);
-        if (it == handlers_.end()) {
-            return;
-        }
-        
-        // Copy handlers to avoid holding lock during execution
-        auto handlers = it->second;
-        lock.unlock();
-        
-        std::vector<EventHandlerInfo> to_remove;
-        
-        for (auto& handler_info : handlers) {
-            try {
-                handler_info.callback(event_data);
-                handlers_executed_++;
-                
-                if (handler_info.once) {
-                    to_remove.push_back(handler_info);
-                }
-            } catch (const std::exception& e) {
-                LOG_ERROR("Event handler error for " + event_name + ": " + std::string(e.what()));
-            }
-        }
-        
-        // Remove one-time handlers
-        if (!to_remove.empty()) {
-            std::unique_lock<std::shared_mutex> write_lock(handlers_mutex_);
-            auto& handler_list = handlers_[event_name];
-            
-            for (const auto& remove_info : to_remove) {
-                handler_list.erase(
-                    std::remove_if(handler_list.begin(), handler_list.end(),
-                        [&remove_info](const EventHandlerInfo& info) {
-                            return info.id == remove_info.id;
-                        })
-                );
-            }
-        }
-    });
+    dispatch(event_type_from_name(event_name), event_name, event_data);
+}
+
+void EventDispatcher::emit(EventType type, const nlohmann::json& event_data) {
+    dispatch(type, event_type_name(type), event_data);
 }
 
 void EventDispatcher::emit_filtered(const std::string& event_name,
@@ -255,69 +173,94 @@ void EventDispatcher::emit_filtered(const std::string& event_name,
 
 std::optional<nlohmann::json> EventDispatcher::wait_for(const std::string& event_name,
                                                     EventFilter filter,
-                                                    std::chrono::milliseconds timeout) {
-    std::optional<nlohmann::json> result;
-    std::condition_variable cv;
-    std::mutex cv_mutex;
-    bool event_received = false;
-    
-    auto handler_id = on(event_name, [&result, &event_received, &cv](const nlohmann::json& event) {
-        if (!filter || filter(event)) {
-            result = event;
-            event_received = true;
-            cv.notify_one();
+                                                    std::chrono::milliseconds timeout,
+                                                    WaitKey key,
+                                                    Snowflake key_id) {
+    // Filters run on the dispatching thread; the caller sleeps on its own condition variable
+    class OnceWaiter : public IEventWaiter {
+    public:
+        EventFilter filter;
+        std::optional<nlohmann::json> result;
+        bool done = false;
+        std::mutex mutex;
+        std::condition_variable cv;
+        
+        bool offer(const nlohmann::json& event_data) override {
+            if (filter && !filter(event_data)) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!done) {
+                result = event_data;
+            }
+            return true;
         }
-    }, 0, "", true); // Remove after first match
-    
-    std::unique_lock<std::mutex> lock(cv_mutex);
-    cv.wait_for(lock, timeout, [&event_received] { return event_received; });
+        
+        void finish() override {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+            cv.notify_all();
+        }
+    };
     
-    if (!event_received) {
-        off(event_name, handler_id);
-    }
+    auto waiter = std::make_shared<OnceWaiter>();
+    waiter->filter = std::move(filter);
     
-    return result;
-}
-
-template<typename T>
-std::shared_ptr<EventCollector<T>> EventDispatcher::create_collector(const std::string& event_name,
-                                                               typename EventCollector<T>::FilterFunction filter,
-                                                               const CollectorConfig& config) {
-    auto collector = std::make_shared<EventCollector<T>>(filter, config);
-    std::string handler_id = collector->start(this, event_name);
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto waiter_id = add_waiter(event_name, key, key_id, deadline, waiter);
     
-    // Track collector for cleanup
     {
-        std::unique_lock<std::shared_mutex> lock(collectors_mutex_);
-        active_collectors_[handler_id] = collector;
+        std::unique_lock<std::mutex> lock(waiter->mutex);
+        waiter->cv.wait_until(lock, deadline, [&waiter] { return waiter->done; });
     }
     
-    return collector;
+    // Still registered if the deadline passed without an event to sweep it
+    waiters_.remove(waiter_id);
+    
+    std::lock_guard<std::mutex> lock(waiter->mutex);
+    return std::move(waiter->result);
+}
+
+WaiterIndex::WaiterId EventDispatcher::add_waiter(const std::string& event_name, WaitKey key, Snowflake key_id,
+                                                  std::chrono::steady_clock::time_point deadline,
+                                                  std::weak_ptr<IEventWaiter> waiter) {
+    return waiters_.add(event_type_from_name(event_name), event_name, key, key_id, deadline, std::move(waiter));
+}
+
+bool EventDispatcher::remove_waiter(WaiterIndex::WaiterId waiter_id) {
+    return waiters_.remove(waiter_id);
 }
 
 void EventDispatcher::add_middleware(std::shared_ptr<IEventMiddleware> middleware) {
-    std::unique_lock<std::shared_mutex> lock(middleware_mutex_);
-    middleware_.push_back(std::move(middleware));
+    if (!middleware) {
+        return;
+    }
     
-    // Sort by priority (higher priority first)
-    std::sort(middleware_.begin(), middleware_.end(),
-        [](const auto& a, const auto& b) {
-            return a->get_priority() > b->get_priority();
-        });
+    std::string name = middleware->get_name();
+    
+    std::lock_guard<std::mutex> lock(middleware_mutex_);
     
-    LOG_DEBUG("Added middleware: " + middleware->get_name());
+    // Compile a new chain; events already running keep the old one
+    auto list = middleware_.load(std::memory_order_acquire)->get_middleware();
+    list.push_back(std::move(middleware));
+    middleware_.store(std::make_shared<const MiddlewareChain>(std::move(list)), std::memory_order_release);
+    
+    LOG_DEBUG("Added middleware: " + name);
 }
 
 bool EventDispatcher::remove_middleware(const std::string& middleware_name) {
-    std::unique_lock<std::shared_mutex> lock(middleware_mutex_);
+    std::lock_guard<std::mutex> lock(middleware_mutex_);
     
-    auto it = std::remove_if(middleware_.begin(), middleware_.end(),
+    auto list = middleware_.load(std::memory_order_acquire)->get_middleware();
+    auto it = std::remove_if(list.begin(), list.end(),
         [&middleware_name](const auto& middleware) {
             return middleware->get_name() == middleware_name;
         });
     
-    bool removed = it != middleware_.end();
+    bool removed = it != list.end();
     if (removed) {
+        list.erase(it, list.end());
+        middleware_.store(std::make_shared<const MiddlewareChain>(std::move(list)), std::memory_order_release);
         LOG_DEBUG("Removed middleware: " + middleware_name);
     }
     
@@ -325,26 +268,33 @@ bool EventDispatcher::remove_middleware(const std::string& middleware_name) {
 }
 
 std::vector<EventHandlerInfo> EventDispatcher::get_handlers(const std::string& event_name) const {
-    std::shared_lock<std::shared_mutex> lock(handlers_mutex_);
-    
-    auto it = handlers_.find(event_name);
-    if (it == handlers_.end()) {
-        return {};
-    }
-    
-    return it->second;
+    auto handlers = load_handlers(event_type_from_name(event_name), event_name);
+    return handlers ? *handlers : std::vector<EventHandlerInfo>{};
 }
 
 nlohmann::json EventDispatcher::get_statistics() const {
     auto now = std::chrono::steady_clock::now();
     auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - start_time_);
     
-    std::shared_lock<std::shared_mutex> handlers_lock(handlers_mutex_);
-    std::shared_lock<std::shared_mutex> collectors_lock(collectors_mutex_);
-    
+    nlohmann::json event_types = nlohmann::json::object();
     size_t total_handlers = 0;
-    for (const auto& [event_name, handlers] : handlers_) {
-        total_handlers += handlers.size();
+    for (size_t i = 0; i < EVENT_TYPE_COUNT; ++i) {
+        size_t count = 0;
+        if (auto handlers = handlers_[i].load(std::memory_order_acquire)) {
+            count += handlers->size();
+        }
+        if (auto typed = typed_handlers_[i].load(std::memory_order_acquire)) {
+            count += typed->size();
+        }
+        if (count > 0) {
+            event_types[event_type_name(static_cast<EventType>(i))] = count;
+            total_handlers += count;
+        }
+    }
+    auto custom = custom_handlers_.load(std::memory_order_acquire);
+    for (const auto& [event_name, handlers] : *custom) {
+        event_types[event_name] = handlers->size();
+        total_handlers += handlers->size();
     }
     
     nlohmann::json stats;
@@ -352,12 +302,8 @@ nlohmann::json EventDispatcher::get_statistics() const {
     stats["events_dispatched"] = events_dispatched_.load();
     stats["handlers_executed"] = handlers_executed_.load();
     stats["total_handlers"] = total_handlers;
-    stats["active_collectors"] = active_collectors_.size();
-    stats["event_types"] = nlohmann::json::object();
-    
-    for (const auto& [event_name, handlers] : handlers_) {
-        stats["event_types"][event_name] = handlers.size();
-    }
+    stats["active_collectors"] = waiters_.size();
+    stats["event_types"] = std::move(event_types);
     
     return stats;
 }
@@ -371,50 +317,126 @@ void EventDispatcher::reset_statistics() {
 }
 
 void EventDispatcher::handle_dispatch(const nlohmann::json& payload) {
-    if (!payload.contains("t") || !payload.contains("d")) {
+    auto name = payload.find("t");
+    auto data = payload.find("d");
+    if (name == payload.end() || data == payload.end() || !name->is_string()) {
         return;
     }
     
-    std::string event_name = payload["t"];
-    nlohmann::json event_data = payload["d"];
+    // Dispatch straight from the payload: the name is interned, nothing is copied
+    const auto& event_name = name->get_ref<const std::string&>();
+    dispatch(event_type_from_name(event_name), event_name, *data);
+}
+
+void EventDispatcher::handle_frame(std::string_view frame) {
+    EventType type = peek_event_type(frame);
     
-    emit(event_name, event_data);
+    if (type != EventType::UNKNOWN && !executor_.load(std::memory_order_acquire) &&
+        middleware_.load(std::memory_order_acquire)->empty() &&
+        !handlers_[static_cast<size_t>(type)].load(std::memory_order_acquire) &&
+        !waiters_.has_waiters(type)) {
+        auto typed = typed_handlers_[static_cast<size_t>(type)].load(std::memory_order_acquire);
+        update_stats();
+        
+        // Nothing needs the JSON document: decode only what typed handlers read, if any
+        if (typed) {
+            std::vector<std::string> fired_once;
+            handlers_executed_ += typed->dispatch_frame(frame, fired_once);
+            if (!fired_once.empty()) {
+                std::lock_guard<std::mutex> lock(handlers_mutex_);
+                remove_typed_handlers(type, fired_once);
+            }
+        }
+        return;
+    }
+    
+    auto payload = nlohmann::json::parse(frame.data(), frame.data() + frame.size(), nullptr, false);
+    if (payload.is_discarded()) {
+        LOG_ERROR("Failed to parse gateway dispatch frame");
+        return;
+    }
+    
+    handle_dispatch(payload);
 }
 
-size_t EventDispatcher::get_handler_count() const {
-    std::shared_lock<std::shared_mutex> lock(handlers_mutex_);
+void EventDispatcher::enable_async_dispatch(std::shared_ptr<IThreadPool> pool, DispatchOrdering ordering) {
+    if (!pool) {
+        return;
+    }
+    
+    ordering_.store(ordering, std::memory_order_relaxed);
+    auto previous = executor_.exchange(std::make_shared<KeyedExecutor>(std::move(pool)), std::memory_order_acq_rel);
+    
+    // Events queued on the previous executor keep running there
+    if (previous) {
+        previous->wait_idle();
+    }
+    
+    LOG_INFO("EventDispatcher dispatching events asynchronously");
+}
+
+bool EventDispatcher::disable_async_dispatch(std::chrono::milliseconds timeout) {
+    auto previous = executor_.exchange(nullptr, std::memory_order_acq_rel);
+    if (!previous) {
+        return true;
+    }
     
+    bool idle = previous->wait_idle(timeout);
+    if (!idle) {
+        LOG_WARN("EventDispatcher stopped async dispatch with " +
+                 std::to_string(previous->get_pending_count()) + " events still queued");
+    }
+    return idle;
+}
+
+bool EventDispatcher::is_async_dispatch() const {
+    return executor_.load(std::memory_order_acquire) != nullptr;
+}
+
+size_t EventDispatcher::get_queued_event_count() const {
+    auto executor = executor_.load(std::memory_order_acquire);
+    return executor ? executor->get_pending_count() : 0;
+}
+
+size_t EventDispatcher::get_handler_count() const {
     size_t total = 0;
-    for (const auto& [event_name, handlers] : handlers_) {
-        total += handlers.size();
+    for (const auto& slot : handlers_) {
+        if (auto handlers = slot.load(std::memory_order_acquire)) {
+            total += handlers->size();
+        }
+    }
+    for (const auto& slot : typed_handlers_) {
+        if (auto typed = slot.load(std::memory_order_acquire)) {
+            total += typed->size();
+        }
+    }
+    auto custom = custom_handlers_.load(std::memory_order_acquire);
+    for (const auto& [event_name, handlers] : *custom) {
+        total += handlers->size();
     }
     
     return total;
 }
 
 size_t EventDispatcher::get_active_collector_count() const {
-    std::shared_lock<std::shared_mutex> lock(collectors_mutex_);
-    return active_collectors_.size();
+    return waiters_.size();
 }
 
 void EventDispatcher::clear() {
     {
-        std::unique_lock<std::shared_mutex> handlers_lock(handlers_mutex_);
-        handlers_.clear();
-    }
-    
-    {
-        std::unique_lock<std::shared_mutex> collectors_lock(collectors_mutex_);
-        
-        // Stop all active collectors
-        for (auto& [handler_id, collector_ptr] : active_collectors_) {
-            // TODO: Call stop on collectors when interface is available
-            // This requires collectors to be stored with proper type
+        std::lock_guard<std::mutex> handlers_lock(handlers_mutex_);
+        for (auto& slot : handlers_) {
+            slot.store(nullptr, std::memory_order_release);
         }
-        
-        active_collectors_.clear();
+        for (auto& slot : typed_handlers_) {
+            slot.store(nullptr, std::memory_order_release);
+        }
+        custom_handlers_.store(std::make_shared<const EventMap>(), std::memory_order_release);
     }
     
+    // Ends active collectors and wakes wait_for() callers
+    waiters_.clear();
+    
     LOG_INFO("EventDispatcher cleared all handlers and collectors");
 }
 
@@ -430,43 +452,162 @@ void EventDispatcher::sort_handlers(std::vector<EventHandlerInfo>& handlers) con
         });
 }
 
-void EventDispatcher::execute_middleware_chain(const std::string& event_name,
-                                         const nlohmann::json& event_data,
-                                         std::function<void()> final_handler) {
-    std::shared_lock<std::shared_mutex> lock(middleware_mutex_);
+EventDispatcher::HandlerSnapshot EventDispatcher::load_handlers(EventType type, const std::string& event_name) const {
+    if (type != EventType::UNKNOWN) {
+        return handlers_[static_cast<size_t>(type)].load(std::memory_order_acquire);
+    }
+    
+    auto custom = custom_handlers_.load(std::memory_order_acquire);
+    auto it = custom->find(event_name);
+    return it != custom->end() ? it->second : nullptr;
+}
+
+bool EventDispatcher::update_handlers(EventType type, const std::string& event_name,
+                                      const std::function<bool(HandlerList&)>& edit) {
+    auto current = load_handlers(type, event_name);
+    HandlerList handlers = current ? *current : HandlerList{};
+    if (!edit(handlers)) {
+        return false;
+    }
+    
+    // Readers still holding the old snapshot keep it alive until they finish
+    HandlerSnapshot snapshot;
+    if (!handlers.empty()) {
+        snapshot = std::make_shared<const HandlerList>(std::move(handlers));
+    }
+    
+    if (type != EventType::UNKNOWN) {
+        handlers_[static_cast<size_t>(type)].store(std::move(snapshot), std::memory_order_release);
+        return true;
+    }
+    
+    auto custom = std::make_shared<EventMap>(*custom_handlers_.load(std::memory_order_acquire));
+    if (snapshot) {
+        (*custom)[event_name] = std::move(snapshot);
+    } else {
+        custom->erase(event_name);
+    }
+    custom_handlers_.store(std::move(custom), std::memory_order_release);
+    return true;
+}
+
+bool EventDispatcher::remove_typed_handlers(EventType type, const std::vector<std::string>& handler_ids) {
+    if (type == EventType::UNKNOWN) {
+        return false;
+    }
     
-    if (middleware_.empty()) {
-        lock.unlock();
-        final_handler();
+    auto& slot = typed_handlers_[static_cast<size_t>(type)];
+    auto current = slot.load(std::memory_order_acquire);
+    if (!current || std::none_of(handler_ids.begin(), handler_ids.end(),
+            [&current](const std::string& id) { return current->contains(id); })) {
+        return false;
+    }
+    
+    slot.store(current->without(handler_ids), std::memory_order_release);
+    return true;
+}
+
+void EventDispatcher::dispatch(EventType type, const std::string& event_name, const nlohmann::json& event_data) {
+    auto executor = executor_.load(std::memory_order_acquire);
+    if (!executor) {
+        dispatch_now(type, event_name, event_data);
         return;
     }
     
-    // Create middleware chain
-    auto middleware_chain = middleware_;
-    lock.unlock();
+    uint64_t key = ordering_key(type, event_data, ordering_.load(std::memory_order_relaxed));
+    
+    // Known names are static, so only custom events carry their name along
+    std::string custom_name = type == EventType::UNKNOWN ? event_name : std::string();
+    executor->submit(key, [this, type, custom_name = std::move(custom_name), data = event_data]() {
+        dispatch_now(type, type == EventType::UNKNOWN ? custom_name : event_type_name(type), data);
+    });
+}
+
+void EventDispatcher::dispatch_now(EventType type, const std::string& event_name, const nlohmann::json& event_data) {
+    update_stats();
     
-    size_t index = 0;
-    std::function<void()> next_middleware = [&, final_handler]() {
-        if (index >= middleware_chain.size()) {
-            final_handler();
+    auto run_handlers = [this, type, &event_name, &event_data]() {
+        if (type != EventType::UNKNOWN) {
+            if (auto typed = typed_handlers_[static_cast<size_t>(type)].load(std::memory_order_acquire)) {
+                std::vector<std::string> fired_once;
+                handlers_executed_ += typed->dispatch(event_data, fired_once);
+                if (!fired_once.empty()) {
+                    std::lock_guard<std::mutex> lock(handlers_mutex_);
+                    remove_typed_handlers(type, fired_once);
+                }
+            }
+        }
+        
+        waiters_.offer(type, event_name, event_data);
+        
+        // The snapshot is immutable; handlers added or removed meanwhile publish a new one
+        auto handlers = load_handlers(type, event_name);
+        if (!handlers) {
             return;
         }
         
-        auto& middleware = middleware_chain[index];
-        index++;
+        std::vector<std::string> to_remove;
         
-        // Continue to next middleware in chain
-        auto next = [&, next_middleware]() {
-            next_middleware();
-        };
+        for (const auto& handler_info : *handlers) {
+            try {
+                handler_info.callback(event_data);
+                handlers_executed_++;
+                
+                if (handler_info.once) {
+                    to_remove.push_back(handler_info.id);
+                }
+            } catch (const std::exception& e) {
+                LOG_ERROR("Event handler error for " + event_name + ": " + std::string(e.what()));
+            }
+        }
         
-        if (!middleware->process(event_name, event_data, next)) {
-            LOG_DEBUG("Middleware " + middleware->get_name() + " blocked event: " + event_name);
+        // Remove one-time handlers
+        if (!to_remove.empty()) {
+            std::lock_guard<std::mutex> write_lock(handlers_mutex_);
+            update_handlers(type, event_name, [&to_remove](HandlerList& current) {
+                current.erase(
+                    std::remove_if(current.begin(), current.end(),
+                        [&to_remove](const EventHandlerInfo& info) {
+                            return std::find(to_remove.begin(), to_remove.end(), info.id) != to_remove.end();
+                        }),
+                    current.end());
+                return true;
+            });
+        }
+    };
+    
+    auto chain = middleware_.load(std::memory_order_acquire);
+    if (chain->empty()) {
+        run_handlers();
+    } else {
+        chain->run(event_name, event_data, run_handlers);
+    }
+}
+
+uint64_t EventDispatcher::ordering_key(EventType type, const nlohmann::json& event_data, DispatchOrdering ordering) {
+    if (!event_data.is_object()) {
+        return 0;
+    }
+    
+    auto snowflake_field = [&event_data](const char* field) -> uint64_t {
+        auto it = event_data.find(field);
+        if (it == event_data.end() || !it->is_string()) {
+            return 0;
         }
+        return parse_snowflake(it->get_ref<const std::string&>()).value_or(0);
     };
     
-    // Start middleware chain
-    next_middleware();
+    // Guild events carry the guild's own ID
+    const char* guild_field = type == EventType::GUILD_CREATE || type == EventType::GUILD_UPDATE ||
+                              type == EventType::GUILD_DELETE ? "id" : "guild_id";
+    
+    uint64_t guild_id = snowflake_field(guild_field);
+    if (ordering == DispatchOrdering::GUILD && guild_id != 0) {
+        return guild_id;
+    }
+    
+    uint64_t channel_id = snowflake_field("channel_id");
+    return channel_id != 0 ? channel_id : guild_id;
 }
 
 void EventDispatcher::update_stats() {
@@ -477,60 +618,36 @@ void EventDispatcher::update_stats() {
 
 namespace EventFilters {
 
+namespace {
+
+// IDs compare as integers; anything that is not a snowflake falls back to a string compare
+FilterExpression id_filter(std::string_view path, const std::string& id) {
+    if (auto snowflake = parse_snowflake(id)) {
+        return FilterExpression::snowflake(path, *snowflake);
+    }
+    return FilterExpression::equals(path, id);
+}
+
+} // namespace
+
 EventFilter by_user_id(const std::string& user_id) {
-    return [user_id](const nlohmann::json& event) {
-        if (event.contains("author") && event["author"].contains("id")) {
-            return event["author"]["id"] == user_id;
-        }
-        return false;
-    };
+    return id_filter("author.id", user_id).compile();
 }
 
 EventFilter by_channel_id(const std::string& channel_id) {
-    return [channel_id](const nlohmann::json& event) {
-        if (event.contains("channel_id")) {
-            return event["channel_id"] == channel_id;
-        }
-        return false;
-    };
+    return id_filter("channel_id", channel_id).compile();
 }
 
 EventFilter by_guild_id(const std::string& guild_id) {
-    return [guild_id](const nlohmann::json& event) {
-        if (event.contains("guild_id")) {
-            return event["guild_id"] == guild_id;
-        }
-        return false;
-    };
+    return id_filter("guild_id", guild_id).compile();
 }
 
 EventFilter by_content(const std::string& content) {
-    return [content](const nlohmann::json& event) {
-        if (!event.contains("content")) {
-            return false;
-        }
-        
-        // Support wildcards
-        if (content.find('*') != std::string::npos) {
-            try {
-                std::regex pattern(content.replace("*", ".*"));
-                return std::regex_match(event["content"], pattern);
-            } catch (const std::exception&) {
-                return event["content"] == content;
-            }
-        }
-        
-        return event["content"] == content;
-    };
+    return FilterExpression::glob("content", content).compile();
 }
 
 EventFilter by_bot(bool is_bot) {
-    return [is_bot](const nlohmann::json& event) {
-        if (event.contains("author") && event["author"].contains("bot")) {
-            return event["author"]["bot"] == is_bot;
-        }
-        return false;
-    };
+    return FilterExpression::flag("author.bot", is_bot).compile();
 }
 
 EventFilter and_filter(const std::vector<EventFilter>& filters) {
@@ -575,7 +692,7 @@ RateLimiter::RateLimiter(int max_events, std::chrono::milliseconds window)
 
 bool RateLimiter::process(const std::string& event_name,
                         const nlohmann::json& event_data,
-                        std::function<void()> next) {
+                        MiddlewareNext next) {
     std::unique_lock<std::shared_mutex> lock(mutex_);
     
     auto now = std::chrono::steady_clock::now();
@@ -605,7 +722,7 @@ Logger::Logger(bool log_all) : log_all_events_(log_all) {
 
 bool Logger::process(const std::string& event_name,
                     const nlohmann::json& event_data,
-                    std::function<void()> next) {
+                    MiddlewareNext next) {
     bool should_log = log_all_events_ || 
                      std::find(logged_events_.begin(), logged_events_.end(), event_name) != logged_events_.end();
     
@@ -624,7 +741,7 @@ void Validator::add_validator(const std::string& event_name, std::function<bool(
 
 bool Validator::process(const std::string& event_name,
                       const nlohmann::json& event_data,
-                      std::function<void()> next) {
+                      MiddlewareNext next) {
     auto it = validators_.find(event_name);
     if (it != validators_.end()) {
         try {
@@ -642,6 +759,37 @@ bool Validator::process(const std::string& event_name,
     return true;
 }
 
+ContentFilter::ContentFilter(ContentMatcher matcher, MatchCallback on_match)
+    : matcher_(std::move(matcher)), on_match_(std::move(on_match)) {
+    LOG_INFO("ContentFilter initialized with " + std::to_string(matcher_.pattern_count()) + " patterns");
+}
+
+bool ContentFilter::process(const std::string& event_name,
+                          const nlohmann::json& event_data,
+                          MiddlewareNext next) {
+    auto content = event_data.find("content");
+    if ((event_name != "MESSAGE_CREATE" && event_name != "MESSAGE_UPDATE") ||
+        content == event_data.end() || !content->is_string()) {
+        next();
+        return true;
+    }
+    
+    const auto& text = content->get_ref<const std::string&>();
+    if (on_match_) {
+        auto pattern_ids = matcher_.find_all(text);
+        if (!pattern_ids.empty()) {
+            on_match_(event_name, event_data, pattern_ids);
+            return false;
+        }
+    } else if (matcher_.matches(text)) {
+        LOG_DEBUG("Content filter stopped event: " + event_name);
+        return false;
+    }
+    
+    next();
+    return true;
+}
+
 } // namespace EventMiddleware
 
 } // namespace discord
\ No newline at end of file
@@ -0,0 +1,478 @@
+#include <discord/events/event_filter.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <regex>
+
+namespace discord {
+
+namespace {
+
+enum class Op : uint8_t {
+    SNOWFLAKE_EQ,
+    SNOWFLAKE_IN,
+    STRING_EQ,
+    BOOL_EQ,
+    GLOB,
+    REGEX,
+    CONTENT,
+    EXISTS
+};
+
+constexpr uint32_t ACCEPT = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t REJECT = ACCEPT - 1;
+constexpr size_t INLINE_FIELDS = 16; // Field slots kept on the stack during evaluation
+
+/**
+ * @brief Glob pattern split at its '*' wildcards
+ */
+struct GlobPattern {
+    std::vector<std::string> parts; // Literal runs; a '*' sits between each pair
+    size_t min_length = 0;
+
+    explicit GlobPattern(const std::string& pattern) {
+        size_t start = 0;
+        while (true) {
+            size_t star = pattern.find('*', start);
+            parts.push_back(pattern.substr(start, star - start));
+            min_length += parts.back().size();
+            if (star == std::string::npos) {
+                break;
+            }
+            start = star + 1;
+        }
+    }
+
+    bool matches(std::string_view text) const {
+        if (parts.size() == 1) {
+            return text == parts[0];
+        }
+        if (text.size() < min_length || !text.starts_with(parts.front()) || !text.ends_with(parts.back())) {
+            return false;
+        }
+
+        // Middle runs match leftmost-first between the fixed prefix and suffix
+        size_t position = parts.front().size();
+        size_t end = text.size() - parts.back().size();
+        for (size_t i = 1; i + 1 < parts.size(); ++i) {
+            size_t found = text.substr(0, end).find(parts[i], position);
+            if (found == std::string_view::npos) {
+                return false;
+            }
+            position = found + parts[i].size();
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Estimated evaluation cost and pass probability of a subexpression
+ */
+struct Estimate {
+    double cost;
+    double pass;
+};
+
+std::vector<std::string> split_path(std::string_view path) {
+    std::vector<std::string> keys;
+    size_t start = 0;
+    while (true) {
+        size_t dot = path.find('.', start);
+        keys.emplace_back(path.substr(start, dot - start));
+        if (dot == std::string_view::npos) {
+            return keys;
+        }
+        start = dot + 1;
+    }
+}
+
+const nlohmann::json* resolve(const nlohmann::json& root, const std::vector<std::string>& keys) {
+    const nlohmann::json* value = &root;
+    for (const auto& key : keys) {
+        if (!value->is_object()) {
+            return nullptr;
+        }
+        auto it = value->find(key);
+        if (it == value->end()) {
+            return nullptr;
+        }
+        value = &*it;
+    }
+    return value->is_null() ? nullptr : value;
+}
+
+bool read_snowflake(const nlohmann::json& value, Snowflake& id) {
+    if (value.is_string()) {
+        auto parsed = parse_snowflake(value.get_ref<const std::string&>());
+        id = parsed.value_or(0);
+        return parsed.has_value();
+    }
+    if (value.is_number_unsigned()) {
+        id = value.get<Snowflake>();
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+struct FilterExpression::Node {
+    enum class Kind { LEAF, AND, OR, NOT };
+
+    Kind kind = Kind::LEAF;
+
+    // Leaf test
+    Op op = Op::EXISTS;
+    std::string path;
+    Snowflake id = 0;
+    std::vector<Snowflake> ids;
+    std::string text;
+    bool flag = false;
+    std::shared_ptr<const std::regex> regex;
+    ContentMatcher matcher;
+
+    // AND, OR and NOT operands
+    std::vector<std::shared_ptr<const Node>> children;
+};
+
+struct CompiledFilter::Program {
+    struct Instruction {
+        Op op;
+        bool flag;
+        uint16_t field;
+        uint32_t operand; // Index into the table of the op, if any
+        uint32_t on_true;
+        uint32_t on_false;
+        Snowflake id;
+    };
+
+    std::vector<std::vector<std::string>> fields;
+    std::vector<Instruction> code;
+    std::vector<std::string> strings;
+    std::vector<GlobPattern> globs;
+    std::vector<std::shared_ptr<const std::regex>> regexes;
+    std::vector<ContentMatcher> matchers;
+    std::vector<std::vector<Snowflake>> id_sets;
+    uint32_t entry = ACCEPT;
+};
+
+namespace {
+
+using Node = FilterExpression::Node;
+using Program = CompiledFilter::Program;
+
+Estimate estimate(const Node& node) {
+    switch (node.kind) {
+        case Node::Kind::LEAF:
+            switch (node.op) {
+                case Op::SNOWFLAKE_EQ: return {1.0, 0.05};
+                case Op::SNOWFLAKE_IN: return {2.0, 0.2};
+                case Op::STRING_EQ:    return {2.0, 0.05};
+                case Op::BOOL_EQ:      return {1.0, 0.5};
+                case Op::EXISTS:       return {1.0, 0.5};
+                case Op::GLOB:         return {4.0, 0.1};
+                case Op::REGEX:        return {20.0, 0.1};
+                case Op::CONTENT:      return {8.0, 0.05};
+            }
+            break;
+        case Node::Kind::NOT: {
+            Estimate inner = estimate(*node.children[0]);
+            return {inner.cost, 1.0 - inner.pass};
+        }
+        case Node::Kind::AND:
+        case Node::Kind::OR: {
+            // Children run in compiled order; each later one only runs if earlier ones did not decide
+            bool is_and = node.kind == Node::Kind::AND;
+            double cost = 0.0;
+            double reach = 1.0;
+            for (const auto& child : node.children) {
+                Estimate e = estimate(*child);
+                cost += reach * e.cost;
+                reach *= is_and ? e.pass : 1.0 - e.pass;
+            }
+            return {cost, is_and ? reach : 1.0 - reach};
+        }
+    }
+    return {1.0, 0.5};
+}
+
+/**
+ * @brief Emits a node tree as a branching program, last instructions first
+ */
+class ProgramBuilder {
+private:
+    Program& program_;
+
+    uint16_t field_index(const std::string& path) {
+        auto keys = split_path(path);
+        auto it = std::find(program_.fields.begin(), program_.fields.end(), keys);
+        if (it != program_.fields.end()) {
+            return static_cast<uint16_t>(it - program_.fields.begin());
+        }
+        program_.fields.push_back(std::move(keys));
+        return static_cast<uint16_t>(program_.fields.size() - 1);
+    }
+
+    uint32_t emit_leaf(const Node& node, uint32_t on_true, uint32_t on_false) {
+        Program::Instruction instruction{node.op, node.flag, field_index(node.path), 0, on_true, on_false, node.id};
+
+        switch (node.op) {
+            case Op::SNOWFLAKE_IN:
+                instruction.operand = static_cast<uint32_t>(program_.id_sets.size());
+                program_.id_sets.push_back(node.ids);
+                break;
+            case Op::STRING_EQ:
+                instruction.operand = static_cast<uint32_t>(program_.strings.size());
+                program_.strings.push_back(node.text);
+                break;
+            case Op::GLOB:
+                instruction.operand = static_cast<uint32_t>(program_.globs.size());
+                program_.globs.emplace_back(node.text);
+                break;
+            case Op::REGEX:
+                instruction.operand = static_cast<uint32_t>(program_.regexes.size());
+                program_.regexes.push_back(node.regex);
+                break;
+            case Op::CONTENT:
+                instruction.operand = static_cast<uint32_t>(program_.matchers.size());
+                program_.matchers.push_back(node.matcher);
+                break;
+            default:
+                break;
+        }
+
+        program_.code.push_back(instruction);
+        return static_cast<uint32_t>(program_.code.size() - 1);
+    }
+
+public:
+    explicit ProgramBuilder(Program& program) : program_(program) {}
+
+    // Returns the entry instruction of the node given where success and failure continue
+    uint32_t emit(const Node& node, uint32_t on_true, uint32_t on_false) {
+        switch (node.kind) {
+            case Node::Kind::LEAF:
+                return emit_leaf(node, on_true, on_false);
+            case Node::Kind::NOT:
+                return emit(*node.children[0], on_false, on_true);
+            case Node::Kind::AND:
+            case Node::Kind::OR:
+                break;
+        }
+
+        bool is_and = node.kind == Node::Kind::AND;
+
+        // Run first whatever decides the result most cheaply: likely failures for AND, likely passes for OR
+        std::vector<std::pair<double, const Node*>> ordered;
+        ordered.reserve(node.children.size());
+        for (const auto& child : node.children) {
+            Estimate e = estimate(*child);
+            double decides = is_and ? 1.0 - e.pass : e.pass;
+            ordered.emplace_back(e.cost / std::max(decides, 1e-6), child.get());
+        }
+        std::stable_sort(ordered.begin(), ordered.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        uint32_t next = is_and ? on_true : on_false;
+        for (auto it = ordered.rbegin(); it != ordered.rend(); ++it) {
+            next = is_and ? emit(*it->second, next, on_false) : emit(*it->second, on_true, next);
+        }
+        return next;
+    }
+};
+
+FilterExpression::Node make_leaf(Op op, std::string_view path) {
+    FilterExpression::Node node;
+    node.op = op;
+    node.path = std::string(path);
+    return node;
+}
+
+} // namespace
+
+// FilterExpression implementation
+
+FilterExpression::FilterExpression(std::shared_ptr<const Node> node)
+    : node_(std::move(node)) {}
+
+FilterExpression FilterExpression::snowflake(std::string_view path, Snowflake id) {
+    Node node = make_leaf(Op::SNOWFLAKE_EQ, path);
+    node.id = id;
+    return FilterExpression(std::make_shared<const Node>(std::move(node)));
+}
+
+FilterExpression FilterExpression::snowflake_in(std::string_view path, std::vector<Snowflake> ids) {
+    Node node = make_leaf(Op::SNOWFLAKE_IN, path);
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    node.ids = std::move(ids);
+    return FilterExpression(std::make_shared<const Node>(std::move(node)));
+}
+
+FilterExpression FilterExpression::equals(std::string_view path, std::string value) {
+    Node node = make_leaf(Op::STRING_EQ, path);
+    node.text = std::move(value);
+    return FilterExpression(std::make_shared<const Node>(std::move(node)));
+}
+
+FilterExpression FilterExpression::flag(std::string_view path, bool value) {
+    Node node = make_leaf(Op::BOOL_EQ, path);
+    node.flag = value;
+    return FilterExpression(std::make_shared<const Node>(std::move(node)));
+}
+
+FilterExpression FilterExpression::glob(std::string_view path, const std::string& pattern) {
+    Node node = make_leaf(pattern.find('*') == std::string::npos ? Op::STRING_EQ : Op::GLOB, path);
+    node.text = pattern;
+    return FilterExpression(std::make_shared<const Node>(std::move(node)));
+}
+
+FilterExpression FilterExpression::regex(std::string_view path, const std::string& pattern) {
+    Node node = make_leaf(Op::REGEX, path);
+    node.regex = std::make_shared<const std::regex>(pattern, std::regex::ECMAScript | std::regex::optimize);
+    return FilterExpression(std::make_shared<const Node>(std::move(node)));
+}
+
+FilterExpression FilterExpression::contains_any(std::string_view path, ContentMatcher matcher) {
+    Node node = make_leaf(Op::CONTENT, path);
+    node.matcher = std::move(matcher);
+    return FilterExpression(std::make_shared<const Node>(std::move(node)));
+}
+
+FilterExpression FilterExpression::exists(std::string_view path) {
+    return FilterExpression(std::make_shared<const Node>(make_leaf(Op::EXISTS, path)));
+}
+
+FilterExpression FilterExpression::all_of(std::vector<FilterExpression> expressions) {
+    Node node;
+    node.kind = Node::Kind::AND;
+    for (auto& expression : expressions) {
+        // Flatten nested ANDs so ordering sees every operand
+        if (expression.node_->kind == Node::Kind::AND) {
+            node.children.insert(node.children.end(), expression.node_->children.begin(), expression.node_->children.end());
+        } else {
+            node.children.push_back(std::move(expression.node_));
+        }
+    }
+    return FilterExpression(std::make_shared<const Node>(std::move(node)));
+}
+
+FilterExpression FilterExpression::any_of(std::vector<FilterExpression> expressions) {
+    Node node;
+    node.kind = Node::Kind::OR;
+    for (auto& expression : expressions) {
+        if (expression.node_->kind == Node::Kind::OR) {
+            node.children.insert(node.children.end(), expression.node_->children.begin(), expression.node_->children.end());
+        } else {
+            node.children.push_back(std::move(expression.node_));
+        }
+    }
+    return FilterExpression(std::make_shared<const Node>(std::move(node)));
+}
+
+FilterExpression FilterExpression::operator&&(const FilterExpression& other) const {
+    return all_of({*this, other});
+}
+
+FilterExpression FilterExpression::operator||(const FilterExpression& other) const {
+    return any_of({*this, other});
+}
+
+FilterExpression FilterExpression::operator!() const {
+    if (node_->kind == Node::Kind::NOT) {
+        return FilterExpression(node_->children[0]);
+    }
+    Node node;
+    node.kind = Node::Kind::NOT;
+    node.children.push_back(node_);
+    return FilterExpression(std::make_shared<const Node>(std::move(node)));
+}
+
+CompiledFilter FilterExpression::compile() const {
+    auto program = std::make_shared<Program>();
+    ProgramBuilder builder(*program);
+    program->entry = builder.emit(*node_, ACCEPT, REJECT);
+    return CompiledFilter(std::move(program));
+}
+
+// CompiledFilter implementation
+
+CompiledFilter::CompiledFilter(std::shared_ptr<const Program> program)
+    : program_(std::move(program)) {}
+
+bool CompiledFilter::matches(const nlohmann::json& event_data) const {
+    if (!program_) {
+        return true;
+    }
+
+    const Program& program = *program_;
+
+    // Slots start unresolved; a resolved missing field is nullptr
+    static const nlohmann::json unresolved;
+    std::array<const nlohmann::json*, INLINE_FIELDS> inline_slots;
+    std::vector<const nlohmann::json*> heap_slots;
+    const nlohmann::json** slots = inline_slots.data();
+    if (program.fields.size() > INLINE_FIELDS) {
+        heap_slots.resize(program.fields.size());
+        slots = heap_slots.data();
+    }
+    std::fill_n(slots, program.fields.size(), &unresolved);
+
+    uint32_t pc = program.entry;
+    while (pc != ACCEPT && pc != REJECT) {
+        const auto& instruction = program.code[pc];
+
+        const nlohmann::json*& value = slots[instruction.field];
+        if (value == &unresolved) {
+            value = resolve(event_data, program.fields[instruction.field]);
+        }
+
+        bool result = false;
+        if (value) {
+            Snowflake id = 0;
+            switch (instruction.op) {
+                case Op::SNOWFLAKE_EQ:
+                    result = read_snowflake(*value, id) && id == instruction.id;
+                    break;
+                case Op::SNOWFLAKE_IN: {
+                    const auto& ids = program.id_sets[instruction.operand];
+                    result = read_snowflake(*value, id) && std::binary_search(ids.begin(), ids.end(), id);
+                    break;
+                }
+                case Op::STRING_EQ:
+                    result = value->is_string() &&
+                             value->get_ref<const std::string&>() == program.strings[instruction.operand];
+                    break;
+                case Op::BOOL_EQ:
+                    result = value->is_boolean() && value->get<bool>() == instruction.flag;
+                    break;
+                case Op::GLOB:
+                    result = value->is_string() &&
+                             program.globs[instruction.operand].matches(value->get_ref<const std::string&>());
+                    break;
+                case Op::REGEX:
+                    result = value->is_string() &&
+                             std::regex_search(value->get_ref<const std::string&>(), *program.regexes[instruction.operand]);
+                    break;
+                case Op::CONTENT:
+                    result = value->is_string() &&
+                             program.matchers[instruction.operand].matches(value->get_ref<const std::string&>());
+                    break;
+                case Op::EXISTS:
+                    result = true;
+                    break;
+            }
+        }
+
+        pc = result ? instruction.on_true : instruction.on_false;
+    }
+
+    return pc == ACCEPT;
+}
+
+size_t CompiledFilter::instruction_count() const {
+    return program_ ? program_->code.size() : 0;
+}
+
+} // namespace discord
@@ -0,0 +1,343 @@
+#include <discord/events/event_ingest_queue.h>
+#include <discord/events/event_dispatcher.h>
+#include <discord/utils/logger.h>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+namespace discord {
+
+namespace {
+
+constexpr int DISPATCH_OPCODE = 0; // GatewayOpcode::DISPATCH
+
+// Consumers also wake this often on their own, in case a wakeup raced a push
+constexpr std::chrono::milliseconds CONSUMER_IDLE_WAIT{100};
+
+size_t type_index(EventType type) {
+    return std::min(static_cast<size_t>(type), EVENT_TYPE_COUNT);
+}
+
+/**
+ * @brief Get the event type of a dispatch payload
+ * @param payload Gateway payload
+ * @param type Receives the event type
+ * @return False if the payload is not a dispatch
+ */
+bool dispatch_type(const nlohmann::json& payload, EventType& type) {
+    auto op = payload.find("op");
+    auto name = payload.find("t");
+    if (op == payload.end() || !op->is_number_integer() || op->get<int>() != DISPATCH_OPCODE ||
+        name == payload.end() || !name->is_string()) {
+        return false;
+    }
+    type = event_type_from_name(name->get_ref<const std::string&>());
+    return true;
+}
+
+} // namespace
+
+EventIngestQueue::EventIngestQueue(const IngestQueueConfig& config)
+    : consumer_count_(std::max<size_t>(config.consumers, 1)) {
+    size_t capacity = std::bit_ceil(std::max<size_t>(config.capacity, 2));
+    mask_ = capacity - 1;
+    slots_ = std::make_unique<Slot[]>(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    size_t reserved = config.reserved_slots > 0 ? config.reserved_slots : std::max<size_t>(capacity / 16, 1);
+    full_depth_ = capacity - std::min(reserved, capacity - 1);
+    shed_depth_ = std::min(config.shed_depth > 0 ? config.shed_depth : capacity / 2, full_depth_);
+
+    for (auto& policy : policies_) {
+        policy.store(ShedPolicy::SHED_WHEN_FULL, std::memory_order_relaxed);
+    }
+    set_policy(EventType::TYPING_START, ShedPolicy::SHED_EARLY);
+    set_policy(EventType::PRESENCE_UPDATE, ShedPolicy::SHED_EARLY);
+    set_policy(EventType::INTERACTION_CREATE, ShedPolicy::NEVER_SHED);
+    set_policy(EventType::READY, ShedPolicy::NEVER_SHED);
+    set_policy(EventType::RESUMED, ShedPolicy::NEVER_SHED);
+}
+
+EventIngestQueue::~EventIngestQueue() {
+    stop();
+}
+
+bool EventIngestQueue::push(const nlohmann::json& payload) {
+    EventType type;
+    if (!dispatch_type(payload, type) || !admit(type)) {
+        return false;
+    }
+
+    // Copy only once the event is known to be kept
+    Entry entry{type, payload};
+    return enqueue(entry);
+}
+
+bool EventIngestQueue::push(nlohmann::json&& payload) {
+    EventType type;
+    if (!dispatch_type(payload, type) || !admit(type)) {
+        return false;
+    }
+
+    Entry entry{type, std::move(payload)};
+    return enqueue(entry);
+}
+
+void EventIngestQueue::set_policy(EventType type, ShedPolicy policy) {
+    policies_[type_index(type)].store(policy, std::memory_order_relaxed);
+}
+
+ShedPolicy EventIngestQueue::get_policy(EventType type) const {
+    return policies_[type_index(type)].load(std::memory_order_relaxed);
+}
+
+bool EventIngestQueue::start(EventDispatcher& dispatcher) {
+    std::lock_guard<std::mutex> lock(wait_mutex_);
+    if (running_.load(std::memory_order_acquire) || !consumers_.empty()) {
+        return false;
+    }
+
+    dispatcher_ = &dispatcher;
+    running_.store(true, std::memory_order_release);
+    consumers_.reserve(consumer_count_);
+    for (size_t i = 0; i < consumer_count_; ++i) {
+        consumers_.emplace_back(&EventIngestQueue::consumer_loop, this);
+    }
+
+    LOG_INFO("EventIngestQueue started with " + std::to_string(consumer_count_) + " consumer(s)");
+    return true;
+}
+
+void EventIngestQueue::stop() {
+    std::vector<std::thread> consumers;
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        running_.store(false, std::memory_order_release);
+        consumers = std::move(consumers_);
+        consumers_.clear();
+    }
+    not_empty_.notify_all();
+
+    for (auto& consumer : consumers) {
+        if (consumer.joinable()) {
+            consumer.join();
+        }
+    }
+
+    if (!consumers.empty()) {
+        LOG_INFO("EventIngestQueue stopped");
+    }
+}
+
+bool EventIngestQueue::is_running() const {
+    return running_.load(std::memory_order_acquire);
+}
+
+size_t EventIngestQueue::depth() const {
+    // seq_cst so a consumer going to sleep cannot miss a push (see notify_consumer())
+    size_t dequeued = dequeue_pos_.load(std::memory_order_seq_cst);
+    size_t enqueued = enqueue_pos_.load(std::memory_order_seq_cst);
+    size_t ring = enqueued > dequeued ? enqueued - dequeued : 0;
+    return ring + overflow_size_.load(std::memory_order_seq_cst);
+}
+
+bool EventIngestQueue::is_under_pressure() const {
+    return depth() >= shed_depth_;
+}
+
+uint64_t EventIngestQueue::get_dropped_count(EventType type) const {
+    return dropped_[type_index(type)].load(std::memory_order_relaxed);
+}
+
+uint64_t EventIngestQueue::get_dropped_count() const {
+    uint64_t total = 0;
+    for (const auto& count : dropped_) {
+        total += count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+nlohmann::json EventIngestQueue::get_statistics() const {
+    nlohmann::json dropped_by_event = nlohmann::json::object();
+    for (size_t i = 0; i <= EVENT_TYPE_COUNT; ++i) {
+        if (uint64_t count = dropped_[i].load(std::memory_order_relaxed)) {
+            dropped_by_event[i < EVENT_TYPE_COUNT ? event_type_name(static_cast<EventType>(i)) : "UNKNOWN"] = count;
+        }
+    }
+
+    nlohmann::json stats;
+    stats["capacity"] = capacity();
+    stats["depth"] = depth();
+    stats["peak_depth"] = peak_depth_.load(std::memory_order_relaxed);
+    stats["shed_depth"] = shed_depth_;
+    stats["under_pressure"] = is_under_pressure();
+    stats["events_enqueued"] = enqueued_.load(std::memory_order_relaxed);
+    stats["events_dispatched"] = dispatched_.load(std::memory_order_relaxed);
+    stats["events_overflowed"] = overflowed_.load(std::memory_order_relaxed);
+    stats["events_dropped"] = get_dropped_count();
+    stats["dropped_by_event"] = std::move(dropped_by_event);
+    stats["consumers"] = consumer_count_;
+
+    return stats;
+}
+
+void EventIngestQueue::reset_statistics() {
+    enqueued_.store(0, std::memory_order_relaxed);
+    dispatched_.store(0, std::memory_order_relaxed);
+    overflowed_.store(0, std::memory_order_relaxed);
+    peak_depth_.store(depth(), std::memory_order_relaxed);
+    for (auto& count : dropped_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+// Private methods
+
+bool EventIngestQueue::admit(EventType type) const {
+    ShedPolicy policy = get_policy(type);
+    if (policy == ShedPolicy::NEVER_SHED) {
+        return true;
+    }
+
+    size_t limit = policy == ShedPolicy::SHED_EARLY ? shed_depth_ : full_depth_;
+    if (depth() < limit) {
+        return true;
+    }
+    dropped_[type_index(type)].fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool EventIngestQueue::enqueue(Entry& entry) {
+    bool never_shed = get_policy(entry.type) == ShedPolicy::NEVER_SHED;
+    size_t limit = never_shed ? capacity() : full_depth_;
+    entry.ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true) {
+        size_t dequeued = dequeue_pos_.load(std::memory_order_relaxed);
+        if (pos >= dequeued && pos - dequeued >= limit) {
+            break;
+        }
+
+        slot = &slots_[pos & mask_];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence - pos);
+        if (difference == 0) {
+            // seq_cst pairs with the sleeper count in notify_consumer()
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            break; // Full
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+        slot = nullptr;
+    }
+
+    if (slot) {
+        slot->ticket.store(entry.ticket, std::memory_order_relaxed);
+        slot->entry = std::move(entry);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+    } else if (never_shed) {
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        overflow_.push_back(std::move(entry));
+        overflow_size_.fetch_add(1, std::memory_order_seq_cst);
+        overflowed_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        // Another producer took the last slots since admit()
+        dropped_[type_index(entry.type)].fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    enqueued_.fetch_add(1, std::memory_order_relaxed);
+    size_t current = depth();
+    size_t peak = peak_depth_.load(std::memory_order_relaxed);
+    while (current > peak && !peak_depth_.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+
+    notify_consumer();
+    return true;
+}
+
+bool EventIngestQueue::try_pop(Entry& out) {
+    if (overflow_size_.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        if (!overflow_.empty()) {
+            // Ring events that arrived before the side queue head go first
+            size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+            const Slot& slot = slots_[head & mask_];
+            bool ring_first = slot.sequence.load(std::memory_order_acquire) == head + 1 &&
+                              slot.ticket.load(std::memory_order_relaxed) < overflow_.front().ticket;
+            if (!ring_first) {
+                out = std::move(overflow_.front());
+                overflow_.pop_front();
+                overflow_size_.fetch_sub(1, std::memory_order_release);
+                return true;
+            }
+        }
+    }
+
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+        Slot& slot = slots_[pos & mask_];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+        if (difference == 0) {
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                out = std::move(slot.entry);
+                slot.entry.payload = nullptr;
+                slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false; // Empty, or the producer of this slot has not finished
+        } else {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void EventIngestQueue::notify_consumer() {
+    if (sleepers_.load(std::memory_order_seq_cst) == 0) {
+        return;
+    }
+
+    // Taking the lock orders this wakeup after the sleeper's last check
+    { std::lock_guard<std::mutex> lock(wait_mutex_); }
+    not_empty_.notify_one();
+}
+
+void EventIngestQueue::consumer_loop() {
+    Entry entry;
+    while (true) {
+        if (try_pop(entry)) {
+            try {
+                dispatcher_->handle_dispatch(entry.payload);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Event ingestion dispatch error: " + std::string(e.what()));
+            }
+            dispatched_.fetch_add(1, std::memory_order_relaxed);
+            entry.payload = nullptr;
+            continue;
+        }
+
+        // Stopping: leave once everything queued has been dispatched
+        if (!running_.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        not_empty_.wait_for(lock, CONSUMER_IDLE_WAIT, [this] {
+            return depth() > 0 || !running_.load(std::memory_order_acquire);
+        });
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace discord
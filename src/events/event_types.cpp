@@ -0,0 +1,159 @@
+#include <discord/events/event_types.h>
+#include <array>
+
+namespace discord {
+
+namespace {
+
+// In EventType order
+constexpr std::array<std::string_view, EVENT_TYPE_COUNT> EVENT_NAMES = {
+    "READY",
+    "RESUMED",
+    "APPLICATION_COMMAND_PERMISSIONS_UPDATE",
+    "AUTO_MODERATION_RULE_CREATE",
+    "AUTO_MODERATION_RULE_UPDATE",
+    "AUTO_MODERATION_RULE_DELETE",
+    "AUTO_MODERATION_ACTION_EXECUTION",
+    "CHANNEL_CREATE",
+    "CHANNEL_UPDATE",
+    "CHANNEL_DELETE",
+    "CHANNEL_PINS_UPDATE",
+    "THREAD_CREATE",
+    "THREAD_UPDATE",
+    "THREAD_DELETE",
+    "THREAD_LIST_SYNC",
+    "THREAD_MEMBER_UPDATE",
+    "THREAD_MEMBERS_UPDATE",
+    "ENTITLEMENT_CREATE",
+    "ENTITLEMENT_UPDATE",
+    "ENTITLEMENT_DELETE",
+    "GUILD_CREATE",
+    "GUILD_UPDATE",
+    "GUILD_DELETE",
+    "GUILD_AUDIT_LOG_ENTRY_CREATE",
+    "GUILD_BAN_ADD",
+    "GUILD_BAN_REMOVE",
+    "GUILD_EMOJIS_UPDATE",
+    "GUILD_STICKERS_UPDATE",
+    "GUILD_INTEGRATIONS_UPDATE",
+    "GUILD_MEMBER_ADD",
+    "GUILD_MEMBER_REMOVE",
+    "GUILD_MEMBER_UPDATE",
+    "GUILD_MEMBERS_CHUNK",
+    "GUILD_ROLE_CREATE",
+    "GUILD_ROLE_UPDATE",
+    "GUILD_ROLE_DELETE",
+    "GUILD_SCHEDULED_EVENT_CREATE",
+    "GUILD_SCHEDULED_EVENT_UPDATE",
+    "GUILD_SCHEDULED_EVENT_DELETE",
+    "GUILD_SCHEDULED_EVENT_USER_ADD",
+    "GUILD_SCHEDULED_EVENT_USER_REMOVE",
+    "GUILD_SOUNDBOARD_SOUND_CREATE",
+    "GUILD_SOUNDBOARD_SOUND_UPDATE",
+    "GUILD_SOUNDBOARD_SOUND_DELETE",
+    "GUILD_SOUNDBOARD_SOUNDS_UPDATE",
+    "SOUNDBOARD_SOUNDS",
+    "INTEGRATION_CREATE",
+    "INTEGRATION_UPDATE",
+    "INTEGRATION_DELETE",
+    "INTERACTION_CREATE",
+    "INVITE_CREATE",
+    "INVITE_DELETE",
+    "MESSAGE_CREATE",
+    "MESSAGE_UPDATE",
+    "MESSAGE_DELETE",
+    "MESSAGE_DELETE_BULK",
+    "MESSAGE_REACTION_ADD",
+    "MESSAGE_REACTION_REMOVE",
+    "MESSAGE_REACTION_REMOVE_ALL",
+    "MESSAGE_REACTION_REMOVE_EMOJI",
+    "MESSAGE_POLL_VOTE_ADD",
+    "MESSAGE_POLL_VOTE_REMOVE",
+    "PRESENCE_UPDATE",
+    "STAGE_INSTANCE_CREATE",
+    "STAGE_INSTANCE_UPDATE",
+    "STAGE_INSTANCE_DELETE",
+    "SUBSCRIPTION_CREATE",
+    "SUBSCRIPTION_UPDATE",
+    "SUBSCRIPTION_DELETE",
+    "TYPING_START",
+    "USER_UPDATE",
+    "VOICE_CHANNEL_EFFECT_SEND",
+    "VOICE_STATE_UPDATE",
+    "VOICE_SERVER_UPDATE",
+    "WEBHOOKS_UPDATE",
+};
+
+static_assert(!EVENT_NAMES.back().empty(), "every event type needs a name");
+
+constexpr size_t TABLE_SIZE = 512; // Power of two, several times the name count
+constexpr uint8_t EMPTY_SLOT = 0xFF;
+
+static_assert(EVENT_TYPE_COUNT < EMPTY_SLOT, "event types must fit a table slot");
+
+constexpr uint32_t hash_name(std::string_view name, uint32_t seed) {
+    // FNV-1a with a seed folded into the offset basis
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+struct PerfectHashTable {
+    uint32_t seed = 0;
+    bool complete = false;
+    std::array<uint8_t, TABLE_SIZE> slots{};
+};
+
+// Searches for a seed under which every known name gets its own slot
+constexpr PerfectHashTable build_table() {
+    for (uint32_t seed = 0; seed < 100000; ++seed) {
+        PerfectHashTable table;
+        table.seed = seed;
+        table.slots.fill(EMPTY_SLOT);
+
+        bool collision = false;
+        for (size_t i = 0; i < EVENT_NAMES.size() && !collision; ++i) {
+            uint8_t& slot = table.slots[hash_name(EVENT_NAMES[i], seed) & (TABLE_SIZE - 1)];
+            collision = slot != EMPTY_SLOT;
+            slot = static_cast<uint8_t>(i);
+        }
+
+        if (!collision) {
+            table.complete = true;
+            return table;
+        }
+    }
+    return PerfectHashTable{};
+}
+
+constexpr PerfectHashTable EVENT_TABLE = build_table();
+
+static_assert(EVENT_TABLE.complete, "no collision-free seed for the event name table");
+
+} // namespace
+
+EventType event_type_from_name(std::string_view name) {
+    uint8_t index = EVENT_TABLE.slots[hash_name(name, EVENT_TABLE.seed) & (TABLE_SIZE - 1)];
+    if (index == EMPTY_SLOT || EVENT_NAMES[index] != name) {
+        return EventType::UNKNOWN;
+    }
+    return static_cast<EventType>(index);
+}
+
+const std::string& event_type_name(EventType type) {
+    static const std::array<std::string, EVENT_TYPE_COUNT + 1> names = [] {
+        std::array<std::string, EVENT_TYPE_COUNT + 1> result;
+        for (size_t i = 0; i < EVENT_TYPE_COUNT; ++i) {
+            result[i] = std::string(EVENT_NAMES[i]);
+        }
+        return result;
+    }();
+
+    size_t index = static_cast<size_t>(type);
+    return names[index < EVENT_TYPE_COUNT ? index : EVENT_TYPE_COUNT];
+}
+
+} // namespace discord
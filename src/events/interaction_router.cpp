@@ -0,0 +1,401 @@
+#include <discord/events/interaction_router.h>
+#include <discord/events/event_dispatcher.h>
+#include <discord/utils/logger.h>
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+namespace discord {
+
+namespace {
+
+// Discord interaction types
+constexpr int APPLICATION_COMMAND = 2;
+constexpr int MESSAGE_COMPONENT = 3;
+constexpr int APPLICATION_COMMAND_AUTOCOMPLETE = 4;
+constexpr int MODAL_SUBMIT = 5;
+
+// Command option types that nest a command path
+constexpr int SUB_COMMAND = 1;
+constexpr int SUB_COMMAND_GROUP = 2;
+
+/**
+ * @brief Piece of a custom_id pattern
+ */
+struct PatternToken {
+    enum class Kind { LITERAL, PARAM, WILDCARD };
+
+    Kind kind;
+    char literal = '\0';
+    std::string name;
+};
+
+std::vector<PatternToken> parse_pattern(const std::string& pattern) {
+    std::vector<PatternToken> tokens;
+    size_t params = 0;
+
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        char c = pattern[i];
+        if (c == '{') {
+            size_t close = pattern.find('}', i);
+            if (close == std::string::npos || close == i + 1) {
+                throw std::invalid_argument("Malformed parameter in custom_id pattern: " + pattern);
+            }
+            if (!tokens.empty() && tokens.back().kind == PatternToken::Kind::PARAM) {
+                throw std::invalid_argument("Adjacent parameters in custom_id pattern: " + pattern);
+            }
+            if (++params > RouteParams::MAX_PARAMS) {
+                throw std::invalid_argument("Too many parameters in custom_id pattern: " + pattern);
+            }
+            tokens.push_back({PatternToken::Kind::PARAM, '\0', pattern.substr(i + 1, close - i - 1)});
+            i = close;
+        } else if (c == '*') {
+            if (i + 1 != pattern.size() || (!tokens.empty() && tokens.back().kind == PatternToken::Kind::PARAM)) {
+                throw std::invalid_argument("'*' must end a custom_id pattern and follow literal text: " + pattern);
+            }
+            // The wildcard is captured like a parameter
+            if (++params > RouteParams::MAX_PARAMS) {
+                throw std::invalid_argument("Too many parameters in custom_id pattern: " + pattern);
+            }
+            tokens.push_back({PatternToken::Kind::WILDCARD, '\0', "*"});
+        } else {
+            tokens.push_back({PatternToken::Kind::LITERAL, c, ""});
+        }
+    }
+    return tokens;
+}
+
+bool is_plain(const std::vector<PatternToken>& tokens) {
+    return std::all_of(tokens.begin(), tokens.end(),
+        [](const PatternToken& token) { return token.kind == PatternToken::Kind::LITERAL; });
+}
+
+} // namespace
+
+// RouteParams implementation
+
+std::string_view RouteParams::get(std::string_view name) const {
+    for (size_t i = 0; i < count_; ++i) {
+        if (names_[i] == name) {
+            return values_[i];
+        }
+    }
+    return {};
+}
+
+std::optional<Snowflake> RouteParams::get_snowflake(std::string_view name) const {
+    return parse_snowflake(get(name));
+}
+
+void RouteParams::push(std::string_view name, std::string_view value) {
+    if (count_ < MAX_PARAMS) {
+        names_[count_] = name;
+        values_[count_] = value;
+        count_++;
+    }
+}
+
+// CustomIdRouter implementation
+
+void CustomIdRouter::add(const std::string& pattern, Handler handler) {
+    auto tokens = parse_pattern(pattern);
+
+    auto route = std::make_shared<Route>();
+    route->handler = std::move(handler);
+    for (const auto& token : tokens) {
+        if (token.kind != PatternToken::Kind::LITERAL) {
+            route->param_names.push_back(token.name);
+        }
+    }
+
+    if (is_plain(tokens)) {
+        exact_[pattern] = std::move(route);
+        return;
+    }
+
+    uint32_t node = 0;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const auto& token = tokens[i];
+        if (token.kind == PatternToken::Kind::LITERAL) {
+            node = literal_child(node, token.literal, true);
+        } else if (token.kind == PatternToken::Kind::PARAM) {
+            char terminator = i + 1 < tokens.size() ? tokens[i + 1].literal : '\0';
+            auto& params = nodes_[node].params;
+            auto it = std::find_if(params.begin(), params.end(),
+                [terminator](const ParamEdge& edge) { return edge.terminator == terminator; });
+            if (it != params.end()) {
+                node = it->child;
+            } else {
+                uint32_t child = static_cast<uint32_t>(nodes_.size());
+                params.push_back({terminator, child});
+                nodes_.emplace_back();
+                node = child;
+            }
+        }
+    }
+
+    RouteHandle& slot = tokens.back().kind == PatternToken::Kind::WILDCARD ? nodes_[node].wildcard : nodes_[node].route;
+    if (!slot) {
+        pattern_routes_++;
+    }
+    slot = std::move(route);
+}
+
+bool CustomIdRouter::remove(const std::string& pattern) {
+    std::vector<PatternToken> tokens;
+    try {
+        tokens = parse_pattern(pattern);
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+
+    if (is_plain(tokens)) {
+        return exact_.erase(pattern) > 0;
+    }
+
+    // Trie nodes stay; a pattern added again reuses them
+    uint32_t node = 0;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const auto& token = tokens[i];
+        if (token.kind == PatternToken::Kind::LITERAL) {
+            node = literal_child(node, token.literal, false);
+            if (node == 0) {
+                return false;
+            }
+        } else if (token.kind == PatternToken::Kind::PARAM) {
+            char terminator = i + 1 < tokens.size() ? tokens[i + 1].literal : '\0';
+            const auto& params = nodes_[node].params;
+            auto it = std::find_if(params.begin(), params.end(),
+                [terminator](const ParamEdge& edge) { return edge.terminator == terminator; });
+            if (it == params.end()) {
+                return false;
+            }
+            node = it->child;
+        }
+    }
+
+    RouteHandle& slot = tokens.back().kind == PatternToken::Kind::WILDCARD ? nodes_[node].wildcard : nodes_[node].route;
+    if (!slot) {
+        return false;
+    }
+    slot.reset();
+    pattern_routes_--;
+    return true;
+}
+
+CustomIdRouter::RouteHandle CustomIdRouter::find(std::string_view custom_id, RouteParams& params) const {
+    auto exact = exact_.find(custom_id);
+    if (exact != exact_.end()) {
+        return exact->second;
+    }
+
+    if (pattern_routes_ == 0) {
+        return nullptr;
+    }
+
+    std::array<std::string_view, RouteParams::MAX_PARAMS> values;
+    RouteHandle route;
+    if (!match(0, custom_id, 0, values, 0, route)) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < route->param_names.size(); ++i) {
+        params.push(route->param_names[i], values[i]);
+    }
+    return route;
+}
+
+size_t CustomIdRouter::size() const {
+    return exact_.size() + pattern_routes_;
+}
+
+// Private methods
+
+uint32_t CustomIdRouter::literal_child(uint32_t node, char c, bool create) {
+    auto& children = nodes_[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), c,
+        [](const std::pair<char, uint32_t>& child, char value) { return child.first < value; });
+    if (it != children.end() && it->first == c) {
+        return it->second;
+    }
+    if (!create) {
+        return 0;
+    }
+
+    uint32_t child = static_cast<uint32_t>(nodes_.size());
+    children.insert(it, {c, child});
+    nodes_.emplace_back();
+    return child;
+}
+
+bool CustomIdRouter::match(uint32_t node, std::string_view id, size_t position,
+                           std::array<std::string_view, RouteParams::MAX_PARAMS>& values, size_t depth,
+                           RouteHandle& route) const {
+    const Node& current = nodes_[node];
+
+    if (position == id.size()) {
+        if (current.route) {
+            route = current.route;
+            return true;
+        }
+    } else {
+        const auto& children = current.children;
+        auto it = std::lower_bound(children.begin(), children.end(), id[position],
+            [](const std::pair<char, uint32_t>& child, char value) { return child.first < value; });
+        if (it != children.end() && it->first == id[position] &&
+            match(it->second, id, position + 1, values, depth, route)) {
+            return true;
+        }
+
+        for (const auto& edge : current.params) {
+            size_t end = edge.terminator == '\0' ? id.size() : id.find(edge.terminator, position);
+            if (end == std::string_view::npos || end == position) {
+                continue;
+            }
+            values[depth] = id.substr(position, end - position);
+            if (match(edge.child, id, end, values, depth + 1, route)) {
+                return true;
+            }
+        }
+    }
+
+    if (current.wildcard) {
+        values[depth] = id.substr(position);
+        route = current.wildcard;
+        return true;
+    }
+    return false;
+}
+
+// InteractionRouter implementation
+
+void InteractionRouter::on_command(const std::string& name, Handler handler) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    commands_[name] = std::make_shared<const CustomIdRouter::Route>(CustomIdRouter::Route{std::move(handler), {}});
+}
+
+void InteractionRouter::on_autocomplete(const std::string& name, Handler handler) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    autocomplete_[name] = std::make_shared<const CustomIdRouter::Route>(CustomIdRouter::Route{std::move(handler), {}});
+}
+
+void InteractionRouter::on_component(const std::string& pattern, Handler handler) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    components_.add(pattern, std::move(handler));
+}
+
+void InteractionRouter::on_modal(const std::string& pattern, Handler handler) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    modals_.add(pattern, std::move(handler));
+}
+
+bool InteractionRouter::remove_command(const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    bool removed = commands_.erase(name) > 0;
+    removed |= autocomplete_.erase(name) > 0;
+    return removed;
+}
+
+bool InteractionRouter::remove_component(const std::string& pattern) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    return components_.remove(pattern);
+}
+
+bool InteractionRouter::remove_modal(const std::string& pattern) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    return modals_.remove(pattern);
+}
+
+bool InteractionRouter::route(const nlohmann::json& interaction) const {
+    auto data = interaction.find("data");
+    auto type = interaction.find("type");
+    if (data == interaction.end() || !data->is_object() || type == interaction.end() || !type->is_number_integer()) {
+        return false;
+    }
+
+    RouteParams params;
+    CustomIdRouter::RouteHandle route;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        switch (type->get<int>()) {
+            case APPLICATION_COMMAND:
+                route = find_command(commands_, *data);
+                break;
+            case APPLICATION_COMMAND_AUTOCOMPLETE:
+                route = find_command(autocomplete_, *data);
+                break;
+            case MESSAGE_COMPONENT:
+            case MODAL_SUBMIT: {
+                auto custom_id = data->find("custom_id");
+                if (custom_id != data->end() && custom_id->is_string()) {
+                    const auto& router = type->get<int>() == MODAL_SUBMIT ? modals_ : components_;
+                    route = router.find(custom_id->get_ref<const std::string&>(), params);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // The route handle keeps parameter names alive if the route is removed meanwhile
+    if (!route) {
+        return false;
+    }
+
+    try {
+        route->handler(interaction, params);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Interaction handler error: " + std::string(e.what()));
+    }
+    return true;
+}
+
+std::string InteractionRouter::attach(EventDispatcher& dispatcher, int priority) {
+    return dispatcher.on(EventType::INTERACTION_CREATE, [this](const nlohmann::json& interaction) {
+        route(interaction);
+    }, priority);
+}
+
+size_t InteractionRouter::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return commands_.size() + autocomplete_.size() + components_.size() + modals_.size();
+}
+
+// Private methods
+
+CustomIdRouter::RouteHandle InteractionRouter::find_command(
+        const std::unordered_map<std::string, CustomIdRouter::RouteHandle>& routes,
+        const nlohmann::json& data) {
+    auto name = data.find("name");
+    if (name == data.end() || !name->is_string()) {
+        return nullptr;
+    }
+
+    // "command", "command sub" or "command group sub", most specific first
+    std::vector<std::string> paths{name->get<std::string>()};
+    const nlohmann::json* options = &data;
+    for (int level = 0; level < 2; ++level) {
+        auto list = options->find("options");
+        if (list == options->end() || !list->is_array() || list->empty()) {
+            break;
+        }
+        const auto& option = list->front();
+        int option_type = option.value("type", 0);
+        if (option_type != SUB_COMMAND && option_type != SUB_COMMAND_GROUP) {
+            break;
+        }
+        paths.push_back(paths.back() + " " + option.value("name", ""));
+        options = &option;
+    }
+
+    for (auto path = paths.rbegin(); path != paths.rend(); ++path) {
+        auto it = routes.find(*path);
+        if (it != routes.end()) {
+            return it->second;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace discord
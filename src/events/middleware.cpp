@@ -7,7 +7,8 @@ namespace discord {
 
 // EventMiddleware implementation
 
-EventMiddleware::EventMiddleware() {
+EventMiddleware::EventMiddleware()
+    : chain_(std::make_shared<const MiddlewareChain>()) {
     LOG_INFO("EventMiddleware initialized");
 }
 
@@ -21,23 +22,29 @@ void EventMiddleware::add_middleware(std::shared_ptr<IEventMiddleware> middlewar
         return;
     }
     
-    std::unique_lock<std::shared_mutex> lock(mutex_);
-    middleware_.push_back(std::move(middleware));
-    sort_middleware();
+    std::string name = middleware->get_name();
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto list = chain_.load(std::memory_order_acquire)->get_middleware();
+    list.push_back(std::move(middleware));
+    chain_.store(std::make_shared<const MiddlewareChain>(std::move(list)), std::memory_order_release);
     
-    LOG_DEBUG("Added middleware: " + middleware->get_name());
+    LOG_DEBUG("Added middleware: " + name);
 }
 
 bool EventMiddleware::remove_middleware(const std::string& middleware_name) {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = std::remove_if(middleware_.begin(), middleware_.end(),
+    auto list = chain_.load(std::memory_order_acquire)->get_middleware();
+    auto it = std::remove_if(list.begin(), list.end(),
         [&middleware_name](const auto& middleware) {
             return middleware->get_name() == middleware_name;
         });
     
-    bool removed = it != middleware_.end();
+    bool removed = it != list.end();
     if (removed) {
+        list.erase(it, list.end());
+        chain_.store(std::make_shared<const MiddlewareChain>(std::move(list)), std::memory_order_release);
         LOG_DEBUG("Removed middleware: " + middleware_name);
     }
     
@@ -46,55 +53,26 @@ bool EventMiddleware::remove_middleware(const std::string& middleware_name) {
 
 void EventMiddleware::process_event(const std::string& event_name,
                                  const nlohmann::json& event_data,
-                                 std::function<void()> final_handler) {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    
-    // Process middleware chain
-    size_t index = 0;
-    auto next_middleware = [&, final_handler, &index, &event_name, &event_data]() {
-        if (index >= middleware_.size()) {
-            final_handler();
-            return;
-        }
-        
-        auto& middleware = middleware_[index];
-        index++;
-        
-        auto next = [&, final_handler, &index, &event_name, &event_data]() {
-            next_middleware();
-        };
-        
-        if (!middleware->process(event_name, event_data, next)) {
-            LOG_DEBUG("Middleware " + middleware->get_name() + " blocked event: " + event_name);
-        }
-    };
-    
-    // Start middleware chain
-    if (middleware_.empty()) {
+                                 const std::function<void()>& final_handler) {
+    auto chain = chain_.load(std::memory_order_acquire);
+    if (chain->empty()) {
         final_handler();
-    } else {
-        next_middleware();
+        return;
     }
+    
+    chain->run(event_name, event_data, final_handler);
 }
 
 std::vector<std::shared_ptr<IEventMiddleware>> EventMiddleware::get_middleware() const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    return middleware_;
+    return chain_.load(std::memory_order_acquire)->get_middleware();
 }
 
 void EventMiddleware::clear() {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
-    middleware_.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    chain_.store(std::make_shared<const MiddlewareChain>(), std::memory_order_release);
     LOG_INFO("Cleared all middleware");
 }
 
-void EventMiddleware::sort_middleware() {
-    std::sort(middleware_.begin(), middleware_.end(),
-        [](const auto& a, const auto& b) {
-            return a->get_priority() > b->get_priority();
-        });
-}
-
 // BuiltInMiddleware implementations
 
 namespace BuiltInMiddleware {
@@ -108,7 +86,7 @@ Authentication::Authentication(const std::string& token, bool require_user_id)
 
 bool Authentication::process(const std::string& event_name,
                               const nlohmann::json& event_data,
-                              std::function<void()> next) {
+                              MiddlewareNext next) {
     // TODO: Implement actual authentication logic
     // This would validate tokens, check user permissions, etc.
     LOG_DEBUG("Authentication middleware processing event: " + event_name);
@@ -125,7 +103,7 @@ PermissionChecker::PermissionChecker(const std::unordered_map<std::string, uint6
 
 bool PermissionChecker::process(const std::string& event_name,
                               const nlohmann::json& event_data,
-                              std::function<void()> next) {
+                              MiddlewareNext next) {
     // TODO: Implement actual permission checking logic
     // This would check if the event has required permissions
     LOG_DEBUG("PermissionChecker middleware processing event: " + event_name);
@@ -143,7 +121,7 @@ Transformer::Transformer(const std::unordered_map<std::string,
 
 bool Transformer::process(const std::string& event_name,
                         const nlohmann::json& event_data,
-                        std::function<void()> next) {
+                        MiddlewareNext next) {
     auto it = transformers_.find(event_name);
     if (it != transformers_.end()) {
         try {
@@ -169,7 +147,7 @@ Filter::Filter(const std::vector<EventFilter>& filters, const std::string& mode)
 
 bool Filter::process(const std::string& event_name,
                     const nlohmann::json& event_data,
-                    std::function<void()> next) {
+                    MiddlewareNext next) {
     bool should_pass = true;
     
     if (filter_mode_ == "all") {
@@ -204,7 +182,7 @@ Cache::Cache(size_t max_size, std::chrono::milliseconds ttl)
 
 bool Cache::process(const std::string& event_name,
                   const nlohmann::json& event_data,
-                  std::function<void()> next) {
+                  MiddlewareNext next) {
     std::unique_lock<std::shared_mutex> lock(mutex_);
     
     cleanup_cache();
@@ -287,7 +265,7 @@ Metrics::Metrics() = default;
 
 bool Metrics::process(const std::string& event_name,
                     const nlohmann::json& event_data,
-                    std::function<void()> next) {
+                    MiddlewareNext next) {
     std::unique_lock<std::shared_mutex> lock(mutex_);
     
     auto now = std::chrono::steady_clock::now();
@@ -339,7 +317,7 @@ Debugger::Debugger(const std::vector<std::string>& events, bool log_all, bool in
 
 bool Debugger::process(const std::string& event_name,
                     const nlohmann::json& event_data,
-                    std::function<void()> next) {
+                    MiddlewareNext next) {
     bool should_log = log_all_events_ || 
                      std::find(debug_events_.begin(), debug_events_.end(), event_name) != debug_events_.end();
     
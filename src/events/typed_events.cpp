@@ -0,0 +1,391 @@
+#include <discord/events/typed_events.h>
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <span>
+
+namespace discord {
+
+namespace {
+
+constexpr size_t MAX_DEPTH = 8;
+constexpr std::string_view ARRAY_ELEMENT = "[]";
+
+/**
+ * @brief Scalar seen while walking an event
+ */
+struct FieldValue {
+    enum class Kind { STRING, INTEGER, BOOLEAN, OTHER };
+
+    Kind kind = Kind::OTHER;
+    std::string_view text;
+    uint64_t integer = 0;
+    bool boolean = false;
+};
+
+// Keys from the "d" object down to the value; array elements appear as "[]"
+using FieldPath = std::span<const std::string_view>;
+
+bool path_is(FieldPath path, std::initializer_list<std::string_view> expected) {
+    return path.size() == expected.size() && std::equal(path.begin(), path.end(), expected.begin());
+}
+
+Snowflake snowflake_of(const FieldValue& value) {
+    if (value.kind == FieldValue::Kind::STRING) {
+        return parse_snowflake(value.text).value_or(0);
+    }
+    return value.kind == FieldValue::Kind::INTEGER ? value.integer : 0;
+}
+
+int int_of(const FieldValue& value) {
+    return value.kind == FieldValue::Kind::INTEGER ? static_cast<int>(value.integer) : 0;
+}
+
+bool bool_of(const FieldValue& value) {
+    return value.kind == FieldValue::Kind::BOOLEAN && value.boolean;
+}
+
+void assign_string(std::string& target, const FieldValue& value) {
+    if (value.kind == FieldValue::Kind::STRING) {
+        target.assign(value.text);
+    }
+}
+
+// Field setters, one per event struct
+
+void assign(MessageCreateEvent& event, FieldPath path, const FieldValue& value) {
+    if (path.size() == 1) {
+        std::string_view key = path[0];
+        if (key == "id") event.id = snowflake_of(value);
+        else if (key == "channel_id") event.channel_id = snowflake_of(value);
+        else if (key == "guild_id") event.guild_id = snowflake_of(value);
+        else if (key == "webhook_id") event.webhook_id = snowflake_of(value);
+        else if (key == "content") assign_string(event.content, value);
+        else if (key == "timestamp") assign_string(event.timestamp, value);
+        else if (key == "type") event.type = int_of(value);
+        else if (key == "mention_everyone") event.mention_everyone = bool_of(value);
+    } else if (path.size() == 2 && path[0] == "author") {
+        if (path[1] == "id") event.author_id = snowflake_of(value);
+        else if (path[1] == "username") assign_string(event.author_username, value);
+        else if (path[1] == "bot") event.author_bot = bool_of(value);
+    } else if (path_is(path, {"mentions", ARRAY_ELEMENT, "id"})) {
+        event.mention_ids.push_back(snowflake_of(value));
+    } else if (path_is(path, {"mention_roles", ARRAY_ELEMENT})) {
+        event.mention_role_ids.push_back(snowflake_of(value));
+    } else if (path_is(path, {"message_reference", "message_id"})) {
+        event.referenced_message_id = snowflake_of(value);
+    }
+}
+
+void assign(MessageDeleteEvent& event, FieldPath path, const FieldValue& value) {
+    if (path.size() != 1) {
+        return;
+    }
+
+    if (path[0] == "id") event.id = snowflake_of(value);
+    else if (path[0] == "channel_id") event.channel_id = snowflake_of(value);
+    else if (path[0] == "guild_id") event.guild_id = snowflake_of(value);
+}
+
+void assign(MessageReactionAddEvent& event, FieldPath path, const FieldValue& value) {
+    if (path.size() == 1) {
+        std::string_view key = path[0];
+        if (key == "user_id") event.user_id = snowflake_of(value);
+        else if (key == "channel_id") event.channel_id = snowflake_of(value);
+        else if (key == "message_id") event.message_id = snowflake_of(value);
+        else if (key == "guild_id") event.guild_id = snowflake_of(value);
+        else if (key == "message_author_id") event.message_author_id = snowflake_of(value);
+        else if (key == "burst") event.burst = bool_of(value);
+    } else if (path.size() == 2 && path[0] == "emoji") {
+        if (path[1] == "id") event.emoji_id = snowflake_of(value);
+        else if (path[1] == "name") assign_string(event.emoji_name, value);
+    }
+}
+
+void assign(InteractionCreateEvent& event, FieldPath path, const FieldValue& value) {
+    if (path.size() == 1) {
+        std::string_view key = path[0];
+        if (key == "id") event.id = snowflake_of(value);
+        else if (key == "application_id") event.application_id = snowflake_of(value);
+        else if (key == "guild_id") event.guild_id = snowflake_of(value);
+        else if (key == "channel_id") event.channel_id = snowflake_of(value);
+        else if (key == "type") event.type = int_of(value);
+        else if (key == "token") assign_string(event.token, value);
+        else if (key == "locale") assign_string(event.locale, value);
+    } else if (path.size() == 2 && path[0] == "data") {
+        if (path[1] == "name") assign_string(event.command_name, value);
+        else if (path[1] == "custom_id") assign_string(event.custom_id, value);
+        else if (path[1] == "component_type") event.component_type = int_of(value);
+    } else if (path_is(path, {"member", "user", "id"}) || path_is(path, {"user", "id"})) {
+        event.user_id = snowflake_of(value);
+    }
+}
+
+void assign(GuildMemberAddEvent& event, FieldPath path, const FieldValue& value) {
+    if (path.size() == 1) {
+        std::string_view key = path[0];
+        if (key == "guild_id") event.guild_id = snowflake_of(value);
+        else if (key == "nick") assign_string(event.nick, value);
+        else if (key == "joined_at") assign_string(event.joined_at, value);
+        else if (key == "pending") event.pending = bool_of(value);
+    } else if (path.size() == 2 && path[0] == "user") {
+        if (path[1] == "id") event.user_id = snowflake_of(value);
+        else if (path[1] == "username") assign_string(event.username, value);
+        else if (path[1] == "global_name") assign_string(event.global_name, value);
+        else if (path[1] == "bot") event.bot = bool_of(value);
+    } else if (path_is(path, {"roles", ARRAY_ELEMENT})) {
+        event.role_ids.push_back(snowflake_of(value));
+    }
+}
+
+/**
+ * @brief SAX handler that feeds the scalars under "d" to an event's setter
+ *
+ * Only the current key of each open container is kept; values outside
+ * the struct's fields are skipped without being materialized.
+ */
+template<typename Event>
+class FrameDecoder {
+private:
+    Event& event_;
+    std::array<std::string, MAX_DEPTH> keys_; // keys_[i] is the current key of the container at depth i
+    size_t depth_ = 0;
+    std::string type_name_;
+    bool has_data_ = false;
+
+    bool value(const FieldValue& field) {
+        if (depth_ == 1 && keys_[0] == "t" && field.kind == FieldValue::Kind::STRING) {
+            type_name_.assign(field.text);
+        }
+        if (depth_ < 2 || depth_ > MAX_DEPTH || keys_[0] != "d") {
+            return true;
+        }
+
+        std::array<std::string_view, MAX_DEPTH> path;
+        for (size_t i = 1; i < depth_; ++i) {
+            path[i - 1] = keys_[i];
+        }
+        assign(event_, FieldPath(path.data(), depth_ - 1), field);
+        return true;
+    }
+
+    bool push(bool is_array) {
+        if (depth_ == 1 && keys_[0] == "d") {
+            has_data_ = true;
+        }
+        if (depth_ < MAX_DEPTH) {
+            keys_[depth_].assign(is_array ? ARRAY_ELEMENT : std::string_view());
+        }
+        depth_++;
+        return true;
+    }
+
+public:
+    explicit FrameDecoder(Event& event) : event_(event) {}
+
+    const std::string& type_name() const { return type_name_; }
+    bool has_data() const { return has_data_; }
+
+    bool null() { return value(FieldValue{}); }
+    bool boolean(bool val) { return value(FieldValue{FieldValue::Kind::BOOLEAN, {}, 0, val}); }
+    bool number_integer(int64_t val) { return value(FieldValue{FieldValue::Kind::INTEGER, {}, static_cast<uint64_t>(val), false}); }
+    bool number_unsigned(uint64_t val) { return value(FieldValue{FieldValue::Kind::INTEGER, {}, val, false}); }
+    bool number_float(double, const std::string&) { return value(FieldValue{}); }
+    bool string(std::string& val) { return value(FieldValue{FieldValue::Kind::STRING, val, 0, false}); }
+    bool binary(nlohmann::json::binary_t&) { return value(FieldValue{}); }
+    bool start_object(size_t) { return push(false); }
+    bool end_object() { depth_--; return true; }
+    bool start_array(size_t) { return push(true); }
+    bool end_array() { depth_--; return true; }
+
+    bool key(std::string& val) {
+        if (depth_ - 1 < MAX_DEPTH) {
+            keys_[depth_ - 1] = val;
+        }
+        return true;
+    }
+
+    bool parse_error(size_t, const std::string&, const nlohmann::detail::exception&) {
+        return false;
+    }
+};
+
+/**
+ * @brief SAX handler that stops at the top-level "t" value
+ */
+class TypePeeker {
+private:
+    size_t depth_ = 0;
+    bool at_type_ = false;
+
+public:
+    EventType type = EventType::UNKNOWN;
+
+    bool null() { at_type_ = false; return true; }
+    bool boolean(bool) { at_type_ = false; return true; }
+    bool number_integer(int64_t) { at_type_ = false; return true; }
+    bool number_unsigned(uint64_t) { at_type_ = false; return true; }
+    bool number_float(double, const std::string&) { at_type_ = false; return true; }
+    bool binary(nlohmann::json::binary_t&) { at_type_ = false; return true; }
+    bool start_object(size_t) { at_type_ = false; depth_++; return true; }
+    bool end_object() { depth_--; return true; }
+    bool start_array(size_t) { at_type_ = false; depth_++; return true; }
+    bool end_array() { depth_--; return true; }
+
+    bool string(std::string& val) {
+        if (at_type_) {
+            type = event_type_from_name(val);
+            return false; // Found; abort the parse
+        }
+        return true;
+    }
+
+    bool key(std::string& val) {
+        at_type_ = depth_ == 1 && val == "t";
+        return true;
+    }
+
+    bool parse_error(size_t, const std::string&, const nlohmann::detail::exception&) {
+        return false;
+    }
+};
+
+template<typename Event>
+bool decode_frame(std::string_view frame, Event& event) {
+    FrameDecoder<Event> decoder(event);
+    bool parsed = nlohmann::json::sax_parse(frame.data(), frame.data() + frame.size(), &decoder);
+    return parsed && decoder.has_data() && event_type_from_name(decoder.type_name()) == Event::TYPE;
+}
+
+template<typename Event>
+void walk(const nlohmann::json& node, Event& event, std::array<std::string_view, MAX_DEPTH>& path, size_t depth) {
+    if (node.is_object() || node.is_array()) {
+        if (depth >= MAX_DEPTH) {
+            return;
+        }
+        for (auto it = node.begin(); it != node.end(); ++it) {
+            path[depth] = node.is_object() ? std::string_view(it.key()) : ARRAY_ELEMENT;
+            walk(*it, event, path, depth + 1);
+        }
+        return;
+    }
+
+    FieldValue field;
+    if (node.is_string()) {
+        field.kind = FieldValue::Kind::STRING;
+        field.text = node.get_ref<const std::string&>();
+    } else if (node.is_number_integer()) {
+        field.kind = FieldValue::Kind::INTEGER;
+        field.integer = node.get<uint64_t>();
+    } else if (node.is_boolean()) {
+        field.kind = FieldValue::Kind::BOOLEAN;
+        field.boolean = node.get<bool>();
+    }
+    assign(event, FieldPath(path.data(), depth), field);
+}
+
+template<typename Event>
+bool decode_data(const nlohmann::json& data, Event& event) {
+    if (!data.is_object()) {
+        return false;
+    }
+
+    std::array<std::string_view, MAX_DEPTH> path;
+    walk(data, event, path, 0);
+    return true;
+}
+
+/**
+ * @brief SAX handler that stops once the top-level "op", "s" and "t" values are read
+ */
+class HeaderPeeker {
+private:
+    enum class Field { NONE, OPCODE, SEQUENCE, TYPE };
+
+    size_t depth_ = 0;
+    Field field_ = Field::NONE;
+    int remaining_ = 3;
+
+    // Returns false, aborting the parse, once every field has been read
+    bool take() {
+        bool was_field = field_ != Field::NONE;
+        field_ = Field::NONE;
+        return !was_field || --remaining_ > 0;
+    }
+
+public:
+    FrameHeader header;
+
+    bool null() { return take(); }
+    bool boolean(bool) { return take(); }
+    bool number_integer(int64_t val) { return number(val); }
+    bool number_unsigned(uint64_t val) { return number(static_cast<int64_t>(val)); }
+    bool number_float(double, const std::string&) { return take(); }
+    bool binary(nlohmann::json::binary_t&) { return take(); }
+    bool start_object(size_t) { field_ = Field::NONE; depth_++; return true; }
+    bool end_object() { depth_--; return true; }
+    bool start_array(size_t) { field_ = Field::NONE; depth_++; return true; }
+    bool end_array() { depth_--; return true; }
+
+    bool number(int64_t val) {
+        if (field_ == Field::OPCODE) {
+            header.opcode = static_cast<int>(val);
+        } else if (field_ == Field::SEQUENCE) {
+            header.sequence = val;
+        }
+        return take();
+    }
+
+    bool string(std::string& val) {
+        if (field_ == Field::TYPE) {
+            header.type = event_type_from_name(val);
+        }
+        return take();
+    }
+
+    bool key(std::string& val) {
+        field_ = Field::NONE;
+        if (depth_ == 1) {
+            if (val == "op") {
+                field_ = Field::OPCODE;
+            } else if (val == "s") {
+                field_ = Field::SEQUENCE;
+            } else if (val == "t") {
+                field_ = Field::TYPE;
+            }
+        }
+        return true;
+    }
+
+    bool parse_error(size_t, const std::string&, const nlohmann::detail::exception&) {
+        return false;
+    }
+};
+
+} // namespace
+
+bool decode_event(std::string_view frame, MessageCreateEvent& event) { return decode_frame(frame, event); }
+bool decode_event(std::string_view frame, MessageDeleteEvent& event) { return decode_frame(frame, event); }
+bool decode_event(std::string_view frame, MessageReactionAddEvent& event) { return decode_frame(frame, event); }
+bool decode_event(std::string_view frame, InteractionCreateEvent& event) { return decode_frame(frame, event); }
+bool decode_event(std::string_view frame, GuildMemberAddEvent& event) { return decode_frame(frame, event); }
+
+bool decode_event_data(const nlohmann::json& data, MessageCreateEvent& event) { return decode_data(data, event); }
+bool decode_event_data(const nlohmann::json& data, MessageDeleteEvent& event) { return decode_data(data, event); }
+bool decode_event_data(const nlohmann::json& data, MessageReactionAddEvent& event) { return decode_data(data, event); }
+bool decode_event_data(const nlohmann::json& data, InteractionCreateEvent& event) { return decode_data(data, event); }
+bool decode_event_data(const nlohmann::json& data, GuildMemberAddEvent& event) { return decode_data(data, event); }
+
+EventType peek_event_type(std::string_view frame) {
+    TypePeeker peeker;
+    nlohmann::json::sax_parse(frame.data(), frame.data() + frame.size(), &peeker);
+    return peeker.type;
+}
+
+FrameHeader peek_frame_header(std::string_view frame) {
+    HeaderPeeker peeker;
+    nlohmann::json::sax_parse(frame.data(), frame.data() + frame.size(), &peeker);
+    return peeker.header;
+}
+
+} // namespace discord
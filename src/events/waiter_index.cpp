@@ -0,0 +1,319 @@
+#include <discord/events/waiter_index.h>
+#include <discord/utils/logger.h>
+#include <algorithm>
+#include <functional>
+#include <optional>
+
+namespace discord {
+
+namespace {
+
+constexpr WaiterIndex::Clock::rep NO_DEADLINE = WaiterIndex::Clock::time_point::max().time_since_epoch().count();
+
+std::optional<Snowflake> read_id(const nlohmann::json& object, std::string_view key) {
+    if (!object.is_object()) {
+        return std::nullopt;
+    }
+    auto it = object.find(key);
+    if (it == object.end()) {
+        return std::nullopt;
+    }
+    if (it->is_string()) {
+        return parse_snowflake(it->get_ref<const std::string&>());
+    }
+    if (it->is_number_unsigned()) {
+        return it->get<Snowflake>();
+    }
+    return std::nullopt;
+}
+
+std::optional<Snowflake> read_nested_id(const nlohmann::json& data, std::string_view object, std::string_view key) {
+    auto it = data.find(object);
+    return it != data.end() ? read_id(*it, key) : std::nullopt;
+}
+
+// The ID an event carries for a key, looked up the way each gateway event spells it
+std::optional<Snowflake> event_key(EventType type, WaitKey key, const nlohmann::json& data) {
+    switch (key) {
+        case WaitKey::CHANNEL:
+            return read_id(data, "channel_id");
+        case WaitKey::GUILD:
+            return read_id(data, "guild_id");
+        case WaitKey::USER:
+            if (auto id = read_nested_id(data, "author", "id")) return id;
+            if (auto id = read_id(data, "user_id")) return id;
+            if (auto member = data.find("member"); member != data.end() && member->is_object()) {
+                if (auto id = read_nested_id(*member, "user", "id")) return id;
+            }
+            return read_nested_id(data, "user", "id");
+        case WaitKey::MESSAGE:
+            if (auto id = read_id(data, "message_id")) return id;
+            if (auto id = read_nested_id(data, "message", "id")) return id;
+            if (type == EventType::MESSAGE_UPDATE || type == EventType::MESSAGE_DELETE) {
+                return read_id(data, "id");
+            }
+            return std::nullopt;
+        case WaitKey::NONE:
+            break;
+    }
+    return std::nullopt;
+}
+
+size_t type_index(EventType type) {
+    return std::min(static_cast<size_t>(type), EVENT_TYPE_COUNT);
+}
+
+} // namespace
+
+size_t WaiterIndex::BucketKeyHash::operator()(const BucketKey& key) const {
+    size_t hash = std::hash<uint64_t>{}(key.id * 0x9E3779B97F4A7C15ull);
+    hash ^= (static_cast<size_t>(key.type) << 8 | static_cast<size_t>(key.key)) * 0xC2B2AE3D27D4EB4Full;
+    if (!key.name.empty()) {
+        hash ^= std::hash<std::string>{}(key.name);
+    }
+    return hash;
+}
+
+WaiterIndex::~WaiterIndex() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    timer_cv_.notify_all();
+
+    if (timer_.joinable()) {
+        timer_.join();
+    }
+}
+
+WaiterIndex::WaiterId WaiterIndex::add(EventType type, const std::string& event_name, WaitKey key, Snowflake key_id,
+                                       Clock::time_point deadline, std::weak_ptr<IEventWaiter> waiter) {
+    BucketKey bucket{type, key, key == WaitKey::NONE ? 0 : key_id,
+                     type == EventType::UNKNOWN ? event_name : std::string()};
+
+    std::vector<std::shared_ptr<IEventWaiter>> expired;
+    WaiterId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = ++next_id_;
+
+        buckets_[bucket].push_back(id);
+        key_counts_[type_index(type)][static_cast<size_t>(key)]++;
+        type_counts_[type_index(type)].fetch_add(1, std::memory_order_release);
+        entries_.emplace(id, Entry{std::move(waiter), std::move(bucket)});
+
+        if (deadline != Clock::time_point::max()) {
+            deadlines_.emplace(deadline, id);
+            if (!timer_.joinable()) {
+                timer_ = std::thread(&WaiterIndex::run_timer, this);
+            }
+        }
+        expired = take_expired(Clock::now());
+        update_next_deadline();
+    }
+
+    if (deadline != Clock::time_point::max()) {
+        timer_cv_.notify_all();
+    }
+
+    for (auto& waiter_ptr : expired) {
+        waiter_ptr->finish();
+    }
+    return id;
+}
+
+bool WaiterIndex::remove(WaiterId id) {
+    std::shared_ptr<IEventWaiter> waiter;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(id);
+        if (it == entries_.end()) {
+            return false;
+        }
+        waiter = it->second.waiter.lock();
+        unlink(it->second, id);
+        entries_.erase(it);
+    }
+
+    // Finish outside the lock so the waiter may call back into the index
+    if (waiter) {
+        waiter->finish();
+    }
+    return true;
+}
+
+void WaiterIndex::offer(EventType type, const std::string& event_name, const nlohmann::json& event_data) {
+    size_t index = type_index(type);
+    Clock::rep next_deadline = next_deadline_.load(std::memory_order_acquire);
+    bool expiry_due = next_deadline != NO_DEADLINE && next_deadline <= Clock::now().time_since_epoch().count();
+    if (!expiry_due && type_counts_[index].load(std::memory_order_acquire) == 0) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<IEventWaiter>> expired;
+    std::vector<std::pair<WaiterId, std::shared_ptr<IEventWaiter>>> candidates;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (expiry_due) {
+            expired = take_expired(Clock::now());
+            update_next_deadline();
+        }
+
+        std::vector<WaiterId> released;
+        BucketKey bucket{type, WaitKey::NONE, 0, type == EventType::UNKNOWN ? event_name : std::string()};
+        auto visit = [this, &bucket, &candidates, &released]() {
+            auto it = buckets_.find(bucket);
+            if (it == buckets_.end()) {
+                return;
+            }
+            for (WaiterId id : it->second) {
+                if (auto waiter = entries_.at(id).waiter.lock()) {
+                    candidates.emplace_back(id, std::move(waiter));
+                } else {
+                    released.push_back(id);
+                }
+            }
+        };
+
+        if (key_counts_[index][static_cast<size_t>(WaitKey::NONE)] > 0) {
+            visit();
+        }
+        for (size_t key = 1; key < WAIT_KEY_COUNT; ++key) {
+            if (key_counts_[index][key] == 0) {
+                continue;
+            }
+            if (auto id = event_key(type, static_cast<WaitKey>(key), event_data)) {
+                bucket.key = static_cast<WaitKey>(key);
+                bucket.id = *id;
+                visit();
+            }
+        }
+
+        // Owners let go of these; there is nobody to finish
+        for (WaiterId id : released) {
+            auto it = entries_.find(id);
+            unlink(it->second, id);
+            entries_.erase(it);
+        }
+    }
+
+    for (auto& waiter : expired) {
+        waiter->finish();
+    }
+
+    for (auto& [id, waiter] : candidates) {
+        bool done = true;
+        try {
+            done = waiter->offer(event_data);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Event waiter error for " + event_name + ": " + std::string(e.what()));
+        }
+        if (done) {
+            remove(id);
+        }
+    }
+}
+
+bool WaiterIndex::has_waiters(EventType type) const {
+    return type_counts_[type_index(type)].load(std::memory_order_acquire) > 0;
+}
+
+void WaiterIndex::clear() {
+    std::vector<std::shared_ptr<IEventWaiter>> waiters;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [id, entry] : entries_) {
+            if (auto waiter = entry.waiter.lock()) {
+                waiters.push_back(std::move(waiter));
+            }
+        }
+        entries_.clear();
+        buckets_.clear();
+        deadlines_ = {};
+        key_counts_ = {};
+        for (auto& count : type_counts_) {
+            count.store(0, std::memory_order_release);
+        }
+        update_next_deadline();
+    }
+
+    for (auto& waiter : waiters) {
+        waiter->finish();
+    }
+}
+
+size_t WaiterIndex::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+// Private methods
+
+void WaiterIndex::unlink(const Entry& entry, WaiterId id) {
+    auto bucket = buckets_.find(entry.bucket);
+    auto& ids = bucket->second;
+    ids.erase(std::find(ids.begin(), ids.end(), id));
+    if (ids.empty()) {
+        buckets_.erase(bucket);
+    }
+
+    size_t index = type_index(entry.bucket.type);
+    key_counts_[index][static_cast<size_t>(entry.bucket.key)]--;
+    type_counts_[index].fetch_sub(1, std::memory_order_release);
+}
+
+std::vector<std::shared_ptr<IEventWaiter>> WaiterIndex::take_expired(Clock::time_point now) {
+    std::vector<std::shared_ptr<IEventWaiter>> expired;
+
+    // Removed waiters leave their heap entry behind; those are skipped here
+    while (!deadlines_.empty() && deadlines_.top().first <= now) {
+        WaiterId id = deadlines_.top().second;
+        deadlines_.pop();
+
+        auto it = entries_.find(id);
+        if (it == entries_.end()) {
+            continue;
+        }
+        if (auto waiter = it->second.waiter.lock()) {
+            expired.push_back(std::move(waiter));
+        }
+        unlink(it->second, id);
+        entries_.erase(it);
+    }
+    return expired;
+}
+
+void WaiterIndex::update_next_deadline() {
+    Clock::time_point next = deadlines_.empty() ? Clock::time_point::max() : deadlines_.top().first;
+    next_deadline_.store(next.time_since_epoch().count(), std::memory_order_release);
+}
+
+void WaiterIndex::run_timer() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (deadlines_.empty()) {
+            timer_cv_.wait(lock);
+        } else {
+            timer_cv_.wait_until(lock, deadlines_.top().first);
+        }
+        if (stopping_) {
+            break;
+        }
+
+        auto expired = take_expired(Clock::now());
+        update_next_deadline();
+        if (expired.empty()) {
+            continue;
+        }
+
+        // Finish outside the lock so the waiters may call back into the index
+        lock.unlock();
+        for (auto& waiter : expired) {
+            waiter->finish();
+        }
+        expired.clear();
+        lock.lock();
+    }
+}
+
+} // namespace discord
@@ -0,0 +1,285 @@
+#include <discord/gateway/cluster_coordinator.h>
+#include <discord/config.h>
+#include <discord/utils/logger.h>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#ifdef DISCORD_CPP_PLATFORM_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace discord {
+
+namespace {
+
+// Lock files are file descriptors, or HANDLEs on Windows
+constexpr intptr_t NO_FILE = -1;
+
+int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+#ifdef DISCORD_CPP_PLATFORM_WINDOWS
+
+HANDLE as_handle(intptr_t file) {
+    return reinterpret_cast<HANDLE>(file);
+}
+
+intptr_t open_lock_file(const std::string& path) {
+    HANDLE handle = ::CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                  nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    return handle == INVALID_HANDLE_VALUE ? NO_FILE : reinterpret_cast<intptr_t>(handle);
+}
+
+void close_lock_file(intptr_t file) {
+    ::CloseHandle(as_handle(file));
+}
+
+bool lock_file(intptr_t file, bool wait) {
+    OVERLAPPED overlapped = {};
+    DWORD flags = LOCKFILE_EXCLUSIVE_LOCK | (wait ? 0 : LOCKFILE_FAIL_IMMEDIATELY);
+    return ::LockFileEx(as_handle(file), flags, 0, MAXDWORD, MAXDWORD, &overlapped) != 0;
+}
+
+void unlock_file(intptr_t file) {
+    OVERLAPPED overlapped = {};
+    ::UnlockFileEx(as_handle(file), 0, MAXDWORD, MAXDWORD, &overlapped);
+}
+
+int64_t read_stamp(intptr_t file) {
+    char buffer[32] = {};
+    DWORD read_bytes = 0;
+    OVERLAPPED at_start = {};
+    if (!::ReadFile(as_handle(file), buffer, sizeof(buffer) - 1, &read_bytes, &at_start) || read_bytes == 0) {
+        return 0;
+    }
+    return std::strtoll(buffer, nullptr, 10);
+}
+
+bool write_stamp(intptr_t file, const std::string& stamp) {
+    HANDLE handle = as_handle(file);
+    DWORD written = 0;
+    return ::SetFilePointer(handle, 0, nullptr, FILE_BEGIN) != INVALID_SET_FILE_POINTER &&
+           ::SetEndOfFile(handle) &&
+           ::WriteFile(handle, stamp.data(), static_cast<DWORD>(stamp.size()), &written, nullptr);
+}
+
+int64_t process_id() {
+    return static_cast<int64_t>(::GetCurrentProcessId());
+}
+
+#else
+
+intptr_t open_lock_file(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    return fd < 0 ? NO_FILE : fd;
+}
+
+void close_lock_file(intptr_t file) {
+    ::close(static_cast<int>(file));
+}
+
+bool lock_file(intptr_t file, bool wait) {
+    return ::flock(static_cast<int>(file), LOCK_EX | (wait ? 0 : LOCK_NB)) == 0;
+}
+
+void unlock_file(intptr_t file) {
+    ::flock(static_cast<int>(file), LOCK_UN);
+}
+
+int64_t read_stamp(intptr_t file) {
+    char buffer[32] = {};
+    ssize_t read_bytes = ::pread(static_cast<int>(file), buffer, sizeof(buffer) - 1, 0);
+    return read_bytes > 0 ? std::strtoll(buffer, nullptr, 10) : 0;
+}
+
+bool write_stamp(intptr_t file, const std::string& stamp) {
+    int fd = static_cast<int>(file);
+    return ::ftruncate(fd, 0) == 0 && ::pwrite(fd, stamp.data(), stamp.size(), 0) >= 0;
+}
+
+int64_t process_id() {
+    return static_cast<int64_t>(::getpid());
+}
+
+#endif
+
+} // namespace
+
+ClusterCoordinator::ClusterCoordinator(const ClusterConfig& config) : config_(config) {
+    config_.cluster_count = std::max(1, config_.cluster_count);
+    config_.cluster_id = std::clamp(config_.cluster_id, 0, config_.cluster_count - 1);
+
+    if (config_.lock_directory.empty()) {
+        config_.lock_directory = (std::filesystem::temp_directory_path() / "discord_cpp_cluster").string();
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(config_.lock_directory, ec);
+    if (ec) {
+        LOG_ERROR("Cannot create cluster lock directory " + config_.lock_directory + ": " + ec.message());
+    }
+}
+
+ClusterCoordinator::~ClusterCoordinator() {
+    end_restart();
+}
+
+ShardRange ClusterCoordinator::assign_range(int cluster_id, int cluster_count, int shard_count) {
+    cluster_count = std::max(1, cluster_count);
+
+    // Spread the remainder over the first clusters so sizes differ by at most one
+    int base = shard_count / cluster_count;
+    int extra = shard_count % cluster_count;
+
+    ShardRange range;
+    range.first = cluster_id * base + std::min(cluster_id, extra);
+    range.last = range.first + base + (cluster_id < extra ? 1 : 0) - 1;
+    return range;
+}
+
+ShardRange ClusterCoordinator::get_range(int shard_count) const {
+    return assign_range(config_.cluster_id, config_.cluster_count, shard_count);
+}
+
+std::chrono::milliseconds ClusterCoordinator::try_acquire_identify(int bucket) {
+    std::string path = lock_path("identify-bucket-" + std::to_string(bucket) + ".lock");
+
+    intptr_t file = open_lock_file(path);
+    if (file == NO_FILE) {
+        LOG_ERROR("Cannot open identify lock " + path + ", identifying without cluster coordination");
+        return std::chrono::milliseconds(0);
+    }
+
+    // The lock is only held to read and update the bucket's last IDENTIFY time
+    if (!lock_file(file, true)) {
+        close_lock_file(file);
+        return std::chrono::milliseconds(0);
+    }
+
+    int64_t last_identify = read_stamp(file);
+    int64_t now = now_ms();
+    int64_t elapsed = now - last_identify;
+    std::chrono::milliseconds wait(0);
+
+    if (elapsed >= 0 && elapsed < config_.identify_interval.count()) {
+        wait = std::chrono::milliseconds(config_.identify_interval.count() - elapsed);
+    } else if (!write_stamp(file, std::to_string(now))) {
+        LOG_WARN("Cannot record IDENTIFY time in " + path);
+    }
+
+    unlock_file(file);
+    close_lock_file(file);
+    return wait;
+}
+
+bool ClusterCoordinator::begin_restart(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (restart_file_ != NO_FILE) {
+        return true;
+    }
+
+    std::string path = lock_path("restart.lock");
+    intptr_t file = open_lock_file(path);
+    if (file == NO_FILE) {
+        LOG_ERROR("Cannot open restart lock " + path);
+        return false;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!lock_file(file, false)) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            LOG_WARN("Another cluster is restarting, giving up after " + std::to_string(timeout.count()) + "ms");
+            close_lock_file(file);
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    restart_file_ = file;
+    return true;
+}
+
+void ClusterCoordinator::end_restart() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (restart_file_ != NO_FILE) {
+        unlock_file(restart_file_);
+        close_lock_file(restart_file_);
+        restart_file_ = NO_FILE;
+    }
+}
+
+void ClusterCoordinator::publish_state(const std::string& state, const ShardRange& range) const {
+    nlohmann::json status;
+    status["cluster_id"] = config_.cluster_id;
+    status["cluster_count"] = config_.cluster_count;
+    status["first_shard"] = range.first;
+    status["last_shard"] = range.last;
+    status["pid"] = process_id();
+    status["state"] = state;
+    status["updated_at_ms"] = now_ms();
+
+    std::string path = lock_path("cluster-" + std::to_string(config_.cluster_id) + ".json");
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file) {
+            LOG_WARN("Cannot publish cluster state to " + temp_path);
+            return;
+        }
+        file << status.dump();
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+}
+
+std::vector<nlohmann::json> ClusterCoordinator::get_cluster_states() const {
+    std::vector<nlohmann::json> states;
+
+    for (int id = 0; id < config_.cluster_count; ++id) {
+        std::ifstream file(lock_path("cluster-" + std::to_string(id) + ".json"));
+        if (!file) {
+            continue;
+        }
+
+        try {
+            states.push_back(nlohmann::json::parse(file));
+        } catch (const std::exception&) {
+            // Torn or foreign file; skip it
+        }
+    }
+
+    return states;
+}
+
+int ClusterCoordinator::get_cluster_id() const {
+    return config_.cluster_id;
+}
+
+int ClusterCoordinator::get_cluster_count() const {
+    return config_.cluster_count;
+}
+
+// Private methods
+
+std::string ClusterCoordinator::lock_path(const std::string& name) const {
+    return (std::filesystem::path(config_.lock_directory) / name).string();
+}
+
+} // namespace discord
@@ -0,0 +1,200 @@
+#include <discord/gateway/heartbeat_scheduler.h>
+#include <discord/utils/logger.h>
+#include <algorithm>
+#include <random>
+
+namespace discord {
+
+HeartbeatScheduler::HeartbeatScheduler(int max_missed_acks)
+    : max_missed_acks_(std::max(1, max_missed_acks)) {}
+
+HeartbeatScheduler::~HeartbeatScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+HeartbeatScheduler& HeartbeatScheduler::instance() {
+    static HeartbeatScheduler scheduler;
+    return scheduler;
+}
+
+HeartbeatScheduler::HeartbeatId HeartbeatScheduler::add(std::chrono::milliseconds interval,
+                                                       HeartbeatCallback send,
+                                                       ZombieCallback on_zombie) {
+    // Discord requires the first heartbeat after interval * jitter, jitter in [0, 1)
+    static thread_local std::mt19937 gen(std::random_device{}());
+    std::uniform_real_distribution<> jitter(0.0, 1.0);
+    auto first_beat = std::chrono::milliseconds(
+        static_cast<long long>(interval.count() * jitter(gen)));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    HeartbeatId id = next_id_++;
+    Entry entry;
+    entry.interval = interval;
+    entry.send = std::move(send);
+    entry.on_zombie = std::move(on_zombie);
+    entry.stats.interval = interval;
+    entries_.emplace(id, std::move(entry));
+    deadlines_.push(Deadline{Clock::now() + first_beat, id});
+
+    if (!worker_.joinable()) {
+        worker_ = std::thread(&HeartbeatScheduler::run, this);
+    }
+
+    cv_.notify_one();
+    return id;
+}
+
+void HeartbeatScheduler::remove(HeartbeatId id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // A callback may stop its own heartbeat; only foreign threads wait for it
+    if (std::this_thread::get_id() != worker_.get_id()) {
+        firing_cv_.wait(lock, [this, id] { return firing_id_ != id; });
+    }
+
+    // Stale deadlines are skipped by the timer thread
+    entries_.erase(id);
+}
+
+void HeartbeatScheduler::acknowledge(HeartbeatId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return;
+    }
+
+    auto& entry = it->second;
+    auto now = Clock::now();
+    entry.awaiting_ack = false;
+    entry.stats.missed_acks = 0;
+    entry.stats.acks_received++;
+    entry.stats.last_ack = now;
+    entry.stats.latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - entry.stats.last_sent);
+}
+
+void HeartbeatScheduler::beat_now(HeartbeatId id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return;
+    }
+
+    auto& entry = it->second;
+    entry.awaiting_ack = true;
+    entry.stats.last_sent = Clock::now();
+    entry.stats.heartbeats_sent++;
+
+    auto send = entry.send;
+    lock.unlock();
+    send();
+}
+
+std::optional<HeartbeatStats> HeartbeatScheduler::get_stats(HeartbeatId id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+
+    return it->second.stats;
+}
+
+size_t HeartbeatScheduler::get_connection_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void HeartbeatScheduler::set_max_missed_acks(int max_missed_acks) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_missed_acks_ = std::max(1, max_missed_acks);
+}
+
+// Private methods
+
+void HeartbeatScheduler::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stopping_) {
+        if (deadlines_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+
+        auto next = deadlines_.top();
+        auto now = Clock::now();
+        if (now < next.when) {
+            cv_.wait_until(lock, next.when);
+            continue;
+        }
+
+        deadlines_.pop();
+
+        auto it = entries_.find(next.id);
+        if (it == entries_.end()) {
+            continue;
+        }
+
+        auto& entry = it->second;
+
+        // A beat_now() heartbeat since this deadline was set restarts the interval
+        if (now - entry.stats.last_sent < entry.interval) {
+            deadlines_.push(Deadline{entry.stats.last_sent + entry.interval, next.id});
+            continue;
+        }
+
+        if (entry.awaiting_ack) {
+            entry.stats.missed_acks++;
+
+            if (entry.stats.missed_acks >= max_missed_acks_) {
+                LOG_WARN("Gateway connection missed " + std::to_string(entry.stats.missed_acks) +
+                         " heartbeat ACK(s), treating it as zombied");
+
+                auto on_zombie = std::move(entry.on_zombie);
+                entries_.erase(it);
+
+                if (on_zombie) {
+                    fire(lock, next.id, std::move(on_zombie));
+                }
+                continue;
+            }
+        }
+
+        entry.awaiting_ack = true;
+        entry.stats.last_sent = now;
+        entry.stats.heartbeats_sent++;
+        deadlines_.push(Deadline{now + entry.interval, next.id});
+
+        fire(lock, next.id, entry.send);
+    }
+}
+
+void HeartbeatScheduler::fire(std::unique_lock<std::mutex>& lock, HeartbeatId id,
+                              std::function<void()> callback) {
+    firing_id_ = id;
+    lock.unlock();
+
+    try {
+        callback();
+    } catch (const std::exception& e) {
+        LOG_ERROR("Heartbeat callback error: " + std::string(e.what()));
+    }
+
+    lock.lock();
+    firing_id_ = 0;
+    firing_cv_.notify_all();
+}
+
+} // namespace discord
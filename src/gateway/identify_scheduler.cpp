@@ -0,0 +1,255 @@
+#include <discord/gateway/identify_scheduler.h>
+#include <discord/utils/logger.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace discord {
+
+IdentifyScheduler::IdentifyScheduler(int max_concurrency, std::chrono::milliseconds bucket_interval)
+    : max_concurrency_(std::max(1, max_concurrency)), bucket_interval_(bucket_interval),
+      buckets_(static_cast<size_t>(max_concurrency_)),
+      session_start_reset_at_(std::chrono::system_clock::now() + std::chrono::hours(24)) {
+    worker_ = std::thread(&IdentifyScheduler::run, this);
+}
+
+IdentifyScheduler::~IdentifyScheduler() {
+    stop();
+}
+
+void IdentifyScheduler::schedule(int shard_id, IdentifyCallback identify, uint64_t shard_set) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (stopping_) {
+        return;
+    }
+
+    // A shard only ever needs its latest IDENTIFY
+    auto& queue = buckets_[get_bucket(shard_id)].queue;
+    queue.erase(std::remove_if(queue.begin(), queue.end(),
+                               [shard_id, shard_set](const Request& request) {
+                                   return request.shard_id == shard_id && request.shard_set == shard_set;
+                               }),
+                queue.end());
+    queue.push_back(Request{shard_id, shard_set, std::move(identify)});
+
+    cv_.notify_one();
+}
+
+void IdentifyScheduler::cancel(int shard_id, uint64_t shard_set) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto& queue = buckets_[get_bucket(shard_id)].queue;
+    queue.erase(std::remove_if(queue.begin(), queue.end(),
+                               [shard_id, shard_set](const Request& request) {
+                                   return request.shard_id == shard_id && request.shard_set == shard_set;
+                               }),
+                queue.end());
+}
+
+void IdentifyScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto& bucket : buckets_) {
+            bucket.queue.clear();
+        }
+    }
+    cv_.notify_all();
+
+    if (worker_.joinable() && worker_.get_id() != std::this_thread::get_id()) {
+        worker_.join();
+    }
+}
+
+void IdentifyScheduler::set_session_start_limit(int total, int remaining, std::chrono::milliseconds reset_after) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    session_start_total_ = total;
+    session_start_remaining_ = remaining;
+    session_start_reset_at_ = std::chrono::system_clock::now() + reset_after;
+
+    // Another run of this bot may have used starts since /gateway/bot was queried
+    load();
+    persist();
+
+    cv_.notify_one();
+}
+
+void IdentifyScheduler::set_persistence_path(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    persistence_path_ = path;
+    load();
+}
+
+void IdentifyScheduler::set_bucket_gate(BucketGate gate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bucket_gate_ = std::move(gate);
+}
+
+int IdentifyScheduler::get_remaining_session_starts() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return session_start_remaining_;
+}
+
+size_t IdentifyScheduler::get_pending_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t pending = 0;
+    for (const auto& bucket : buckets_) {
+        pending += bucket.queue.size();
+    }
+    return pending;
+}
+
+int IdentifyScheduler::get_max_concurrency() const {
+    return max_concurrency_;
+}
+
+int IdentifyScheduler::get_bucket(int shard_id) const {
+    return shard_id % max_concurrency_;
+}
+
+// Private methods
+
+void IdentifyScheduler::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stopping_) {
+        roll_session_limit();
+
+        auto now = Clock::now();
+        auto wake = Clock::time_point::max();
+        Bucket* ready = nullptr;
+
+        for (auto& bucket : buckets_) {
+            if (bucket.queue.empty()) {
+                continue;
+            }
+
+            if (now >= bucket.next_allowed) {
+                ready = &bucket;
+                break;
+            }
+
+            wake = std::min(wake, bucket.next_allowed);
+        }
+
+        if (ready && session_start_remaining_ <= 0) {
+            // Out of session starts: nothing may identify until the window resets
+            LOG_WARN("Session start limit exhausted, delaying IDENTIFY until reset");
+            auto until_reset = session_start_reset_at_ - std::chrono::system_clock::now();
+            wake = now + std::chrono::duration_cast<Clock::duration>(until_reset);
+            ready = nullptr;
+        }
+
+        if (ready && bucket_gate_) {
+            int bucket_index = static_cast<int>(ready - buckets_.data());
+            auto wait = bucket_gate_(bucket_index);
+            if (wait.count() > 0) {
+                // Another process identified on this bucket recently
+                ready->next_allowed = now + wait;
+                continue;
+            }
+        }
+
+        if (!ready) {
+            if (wake == Clock::time_point::max()) {
+                cv_.wait(lock);
+            } else {
+                cv_.wait_until(lock, wake);
+            }
+            continue;
+        }
+
+        Request request = std::move(ready->queue.front());
+        ready->queue.pop_front();
+        ready->next_allowed = now + bucket_interval_;
+        session_start_remaining_--;
+        persist();
+
+        lock.unlock();
+
+        LOG_DEBUG("Releasing IDENTIFY for shard " + std::to_string(request.shard_id) +
+                  " (bucket " + std::to_string(get_bucket(request.shard_id)) + ")");
+
+        try {
+            request.identify();
+        } catch (const std::exception& e) {
+            LOG_ERROR("IDENTIFY callback error: " + std::string(e.what()));
+        }
+
+        lock.lock();
+    }
+}
+
+void IdentifyScheduler::roll_session_limit() {
+    auto now = std::chrono::system_clock::now();
+    if (now >= session_start_reset_at_) {
+        session_start_remaining_ = session_start_total_;
+        session_start_reset_at_ = now + std::chrono::hours(24);
+        persist();
+    }
+}
+
+void IdentifyScheduler::persist() const {
+    if (persistence_path_.empty()) {
+        return;
+    }
+
+    nlohmann::json state;
+    state["total"] = session_start_total_;
+    state["remaining"] = session_start_remaining_;
+    state["reset_at_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        session_start_reset_at_.time_since_epoch()).count();
+
+    // Write then rename so a crash never leaves a torn file behind
+    std::string temp_path = persistence_path_ + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file) {
+            LOG_WARN("Cannot write session start limit to " + temp_path);
+            return;
+        }
+        file << state.dump();
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, persistence_path_, ec);
+    if (ec) {
+        LOG_WARN("Cannot persist session start limit: " + ec.message());
+    }
+}
+
+void IdentifyScheduler::load() {
+    if (persistence_path_.empty()) {
+        return;
+    }
+
+    std::ifstream file(persistence_path_);
+    if (!file) {
+        return;
+    }
+
+    try {
+        auto state = nlohmann::json::parse(file);
+        std::chrono::system_clock::time_point reset_at(
+            std::chrono::milliseconds(state.value("reset_at_ms", int64_t{0})));
+
+        // A stale file describes a window that has already reset
+        if (reset_at <= std::chrono::system_clock::now()) {
+            return;
+        }
+
+        int remaining = state.value("remaining", session_start_remaining_);
+        if (remaining < session_start_remaining_) {
+            session_start_remaining_ = remaining;
+            session_start_reset_at_ = reset_at;
+        }
+    } catch (const std::exception& e) {
+        LOG_WARN("Ignoring unreadable session start limit file: " + std::string(e.what()));
+    }
+}
+
+} // namespace discord
@@ -0,0 +1,144 @@
+#include <discord/gateway/io_context_pool.h>
+#include <discord/config.h>
+#include <discord/utils/logger.h>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <algorithm>
+#include <optional>
+#ifdef DISCORD_CPP_PLATFORM_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace discord {
+
+class IoContextPool::Impl {
+public:
+    explicit Impl(size_t threads)
+        : thread_count_(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    ~Impl() {
+        stop();
+    }
+
+    void start() {
+        if (is_running_.exchange(true)) {
+            return;
+        }
+
+        io_context_.restart();
+        work_guard_.emplace(boost::asio::make_work_guard(io_context_));
+
+        workers_.reserve(thread_count_);
+        for (size_t i = 0; i < thread_count_; ++i) {
+            workers_.emplace_back([this]() {
+                run_worker();
+            });
+        }
+
+        LOG_INFO("IoContextPool started with " + std::to_string(thread_count_) + " threads");
+    }
+
+    void stop() {
+        if (!is_running_.exchange(false)) {
+            return;
+        }
+
+        work_guard_.reset();
+        io_context_.stop();
+
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+
+        workers_.clear();
+        LOG_INFO("IoContextPool stopped");
+    }
+
+    void set_cpu_affinity(int cpu) {
+        cpu_ = cpu;
+    }
+    
+    bool is_running() const {
+        return is_running_.load();
+    }
+
+    size_t get_thread_count() const {
+        return thread_count_;
+    }
+
+    boost::asio::io_context& get_io_context() {
+        return io_context_;
+    }
+
+private:
+    void run_worker() {
+        apply_cpu_affinity();
+        
+        while (is_running_.load()) {
+            try {
+                io_context_.run();
+                return;
+            } catch (const std::exception& e) {
+                // A throwing handler must not take the whole pool down
+                LOG_ERROR("IoContextPool handler error: " + std::string(e.what()));
+            }
+        }
+    }
+
+    void apply_cpu_affinity() {
+        if (cpu_ < 0) {
+            return;
+        }
+        
+#ifdef DISCORD_CPP_PLATFORM_LINUX
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu_, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+            LOG_WARN("Failed to pin IoContextPool thread to CPU " + std::to_string(cpu_));
+        }
+#else
+        LOG_WARN("CPU affinity is only supported on Linux");
+#endif
+    }
+    
+    boost::asio::io_context io_context_;
+    std::optional<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> work_guard_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> is_running_{false};
+    size_t thread_count_;
+    int cpu_ = -1;
+};
+
+IoContextPool::IoContextPool(size_t threads) : pImpl(std::make_unique<Impl>(threads)) {}
+
+IoContextPool::~IoContextPool() = default;
+
+void IoContextPool::set_cpu_affinity(int cpu) {
+    pImpl->set_cpu_affinity(cpu);
+}
+
+void IoContextPool::start() {
+    pImpl->start();
+}
+
+void IoContextPool::stop() {
+    pImpl->stop();
+}
+
+bool IoContextPool::is_running() const {
+    return pImpl->is_running();
+}
+
+size_t IoContextPool::get_thread_count() const {
+    return pImpl->get_thread_count();
+}
+
+boost::asio::io_context& IoContextPool::get_io_context() {
+    return pImpl->get_io_context();
+}
+
+} // namespace discord
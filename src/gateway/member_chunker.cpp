@@ -0,0 +1,296 @@
+#include <discord/gateway/member_chunker.h>
+#include <discord/gateway/websocket_client.h>
+#include <discord/core/exceptions.h>
+#include <discord/utils/logger.h>
+#include <algorithm>
+
+namespace discord {
+
+namespace {
+
+Snowflake json_snowflake(const nlohmann::json& value) {
+    if (value.is_string()) {
+        return parse_snowflake(value.get_ref<const std::string&>()).value_or(0);
+    }
+    return value.is_number_unsigned() ? value.get<Snowflake>() : 0;
+}
+
+std::exception_ptr chunk_error(ErrorCode code, const std::string& message) {
+    return std::make_exception_ptr(DiscordException(static_cast<int>(code), message));
+}
+
+} // namespace
+
+MemberChunker::MemberChunker(SendFunction send, ShardFunction shard_of,
+                             size_t max_in_flight, std::chrono::milliseconds timeout)
+    : send_(std::move(send)), shard_of_(std::move(shard_of)),
+      max_in_flight_(std::max<size_t>(1, max_in_flight)), timeout_(timeout) {}
+
+MemberChunker::~MemberChunker() {
+    cancel_all();
+}
+
+std::future<MemberChunkResult> MemberChunker::request(Snowflake guild_id, const MemberChunkOptions& options) {
+    expire();
+
+    auto request = std::make_shared<Request>();
+    request->guild_id = guild_id;
+    request->shard_id = shard_of_(guild_id);
+    request->result.guild_id = guild_id;
+
+    nlohmann::json data;
+    data["guild_id"] = std::to_string(guild_id);
+    if (!options.user_ids.empty()) {
+        nlohmann::json user_ids = nlohmann::json::array();
+        for (Snowflake user_id : options.user_ids) {
+            user_ids.push_back(std::to_string(user_id));
+        }
+        data["user_ids"] = std::move(user_ids);
+    } else {
+        data["query"] = options.query;
+        data["limit"] = options.limit;
+    }
+    data["presences"] = options.presences;
+
+    auto future = request->promise.get_future();
+    RequestPtr ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Nonces are at most 32 characters
+        request->nonce = "m" + std::to_string(++next_nonce_);
+        data["nonce"] = request->nonce;
+        request->payload["op"] = static_cast<int>(GatewayOpcode::REQUEST_GUILD_MEMBERS);
+        request->payload["d"] = std::move(data);
+
+        queued_[request->shard_id].push_back(request);
+        ready = take_next(request->shard_id);
+    }
+
+    dispatch(std::move(ready));
+    return future;
+}
+
+std::vector<std::future<MemberChunkResult>> MemberChunker::request_many(const std::vector<Snowflake>& guild_ids,
+                                                                        const MemberChunkOptions& options) {
+    std::vector<std::future<MemberChunkResult>> futures;
+    futures.reserve(guild_ids.size());
+
+    for (Snowflake guild_id : guild_ids) {
+        futures.push_back(request(guild_id, options));
+    }
+
+    return futures;
+}
+
+bool MemberChunker::handle_event(const nlohmann::json& event) {
+    auto data = event.find("d");
+    if (data == event.end() || !data->is_object()) {
+        return false;
+    }
+
+    auto nonce = data->find("nonce");
+    if (nonce == data->end() || !nonce->is_string()) {
+        return false;
+    }
+
+    RequestPtr request;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = in_flight_.find(nonce->get_ref<const std::string&>());
+        if (it == in_flight_.end()) {
+            return false;
+        }
+        request = it->second;
+    }
+
+    // Chunks of one nonce arrive in order on one shard, so the result needs no lock
+    Snowflake guild_id = request->guild_id;
+    std::string key_prefix = "member:" + std::to_string(guild_id) + ":";
+
+    auto members = data->find("members");
+    if (members != data->end() && members->is_array()) {
+        for (const auto& member : *members) {
+            if (member_cache_) {
+                auto user = member.find("user");
+                if (user != member.end() && user->contains("id")) {
+                    member_cache_->set(key_prefix + (*user)["id"].get<std::string>(), member);
+                }
+            }
+            if (member_callback_) {
+                member_callback_(guild_id, member);
+            }
+        }
+        request->result.member_count += members->size();
+    }
+
+    auto presences = data->find("presences");
+    if (presences != data->end() && presences->is_array()) {
+        if (presence_callback_) {
+            for (const auto& presence : *presences) {
+                presence_callback_(guild_id, presence);
+            }
+        }
+        request->result.presence_count += presences->size();
+    }
+
+    auto not_found = data->find("not_found");
+    if (not_found != data->end() && not_found->is_array()) {
+        for (const auto& user_id : *not_found) {
+            request->result.not_found.push_back(json_snowflake(user_id));
+        }
+    }
+
+    request->result.chunk_count++;
+
+    int chunk_index = data->value("chunk_index", 0);
+    int chunk_count = data->value("chunk_count", 1);
+    if (chunk_index + 1 < chunk_count) {
+        return true;
+    }
+
+    RequestPtr next;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (in_flight_.find(request->nonce) == in_flight_.end()) {
+            return true; // Timed out or cancelled meanwhile
+        }
+        next = finish(request);
+    }
+
+    request->promise.set_value(std::move(request->result));
+    dispatch(std::move(next));
+    return true;
+}
+
+void MemberChunker::set_member_cache(std::shared_ptr<ICache> cache) {
+    member_cache_ = std::move(cache);
+}
+
+void MemberChunker::set_member_callback(MemberCallback callback) {
+    member_callback_ = std::move(callback);
+}
+
+void MemberChunker::set_presence_callback(MemberCallback callback) {
+    presence_callback_ = std::move(callback);
+}
+
+void MemberChunker::cancel_all() {
+    std::vector<RequestPtr> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [nonce, request] : in_flight_) {
+            cancelled.push_back(request);
+        }
+        for (auto& [shard_id, queue] : queued_) {
+            cancelled.insert(cancelled.end(), queue.begin(), queue.end());
+        }
+        in_flight_.clear();
+        queued_.clear();
+        in_flight_per_shard_.clear();
+    }
+
+    for (auto& request : cancelled) {
+        request->promise.set_exception(chunk_error(ErrorCode::UNKNOWN_ERROR, "Member request cancelled"));
+    }
+}
+
+size_t MemberChunker::get_pending_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t pending = in_flight_.size();
+    for (const auto& [shard_id, queue] : queued_) {
+        pending += queue.size();
+    }
+    return pending;
+}
+
+void MemberChunker::expire() {
+    auto now = Clock::now();
+    std::vector<RequestPtr> expired;
+    std::vector<RequestPtr> next;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (now < next_expiry_check_) {
+            return;
+        }
+        next_expiry_check_ = now + std::chrono::seconds(1);
+
+        for (const auto& [nonce, request] : in_flight_) {
+            if (now - request->sent_at > timeout_) {
+                expired.push_back(request);
+            }
+        }
+        for (const auto& request : expired) {
+            next.push_back(finish(request));
+        }
+    }
+
+    for (auto& request : expired) {
+        LOG_WARN("Member request for guild " + std::to_string(request->guild_id) + " timed out");
+        request->promise.set_exception(chunk_error(ErrorCode::UNKNOWN_ERROR, "Member request timed out"));
+    }
+    for (auto& request : next) {
+        dispatch(std::move(request));
+    }
+}
+
+// Private methods
+
+MemberChunker::RequestPtr MemberChunker::take_next(int shard_id) {
+    auto queue = queued_.find(shard_id);
+    if (queue == queued_.end() || queue->second.empty()) {
+        return nullptr;
+    }
+
+    size_t& in_flight = in_flight_per_shard_[shard_id];
+    if (in_flight >= max_in_flight_) {
+        return nullptr;
+    }
+
+    RequestPtr request = std::move(queue->second.front());
+    queue->second.pop_front();
+    in_flight++;
+
+    request->sent_at = Clock::now();
+    in_flight_.emplace(request->nonce, request);
+    return request;
+}
+
+void MemberChunker::dispatch(RequestPtr request) {
+    while (request) {
+        // Sending takes the shard manager's lock, so never under mutex_
+        if (send_(request->guild_id, request->payload)) {
+            return;
+        }
+
+        LOG_WARN("No shard to request members of guild " + std::to_string(request->guild_id));
+
+        RequestPtr failed = std::move(request);
+        bool owned;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            owned = in_flight_.find(failed->nonce) != in_flight_.end();
+            request = owned ? finish(failed) : nullptr;
+        }
+        if (owned) {
+            failed->promise.set_exception(chunk_error(ErrorCode::UNKNOWN_GUILD, "Guild is not handled by this process"));
+        }
+    }
+}
+
+MemberChunker::RequestPtr MemberChunker::finish(const RequestPtr& request) {
+    if (in_flight_.erase(request->nonce) == 0) {
+        return nullptr;
+    }
+
+    size_t& in_flight = in_flight_per_shard_[request->shard_id];
+    if (in_flight > 0) {
+        in_flight--;
+    }
+
+    return take_next(request->shard_id);
+}
+
+} // namespace discord
@@ -20,18 +20,21 @@ void ReconnectionManager::handle_disconnect(int close_code, const std::string& r
         return;
     }
     
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    bool can_resume = is_resumable_close_code(close_code) && session_info_.can_resume;
-    
-    if (can_resume) {
-        session_info_.can_resume = true;
-    } else {
-        session_info_.can_resume = false;
-        session_info_.session_id.clear();
-        session_info_.sequence_number = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        bool can_resume = is_resumable_close_code(close_code) && session_info_.can_resume;
+        
+        if (can_resume) {
+            session_info_.can_resume = true;
+        } else {
+            session_info_.can_resume = false;
+            session_info_.session_id.clear();
+            session_info_.sequence_number = 0;
+        }
     }
     
+    // Not under mutex_: the previous reconnect thread may need it to exit
     start_reconnect_sequence();
 }
 
@@ -57,9 +60,8 @@ void ReconnectionManager::handle_connection_restored() {
         cv_.notify_all();
     }
     
-    if (reconnect_thread_.joinable()) {
-        reconnect_thread_.join();
-    }
+    // Called from the I/O thread, so the reconnect thread is joined later
+    // (next reconnect sequence or shutdown) instead of blocking here
 }
 
 void ReconnectionManager::enable_auto_reconnect(bool enabled) {
@@ -103,6 +105,12 @@ void ReconnectionManager::reset_session() {
     session_info_.can_resume = false;
 }
 
+void ReconnectionManager::update_session(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    session_info_.session_id = session_id;
+    session_info_.can_resume = !session_id.empty();
+}
+
 void ReconnectionManager::attempt_reconnection() {
     bool should_resume = this->should_resume();
     
@@ -145,8 +153,6 @@ void ReconnectionManager::exponential_backoff_reconnect() {
         
         attempt_reconnection();
         current_retry_count_++;
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     }
     
     is_reconnecting_ = false;
@@ -184,18 +190,18 @@ bool ReconnectionManager::is_resumable_close_code(int close_code) const {
 }
 
 void ReconnectionManager::start_reconnect_sequence() {
-    if (is_reconnecting_.load()) {
+    if (is_reconnecting_.exchange(true)) {
         return;
     }
     
-    is_reconnecting_ = true;
-    current_retry_count_ = 0;
-    should_stop_ = false;
-    
+    // Join the previous sequence before clearing should_stop_, or it would keep running
     if (reconnect_thread_.joinable()) {
         reconnect_thread_.join();
     }
     
+    current_retry_count_ = 0;
+    should_stop_ = false;
+    
     reconnect_thread_ = std::thread(&ReconnectionManager::exponential_backoff_reconnect, this);
 }
 
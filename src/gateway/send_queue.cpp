@@ -0,0 +1,67 @@
+#include <discord/gateway/send_queue.h>
+#include <algorithm>
+
+namespace discord {
+
+GatewaySendLimiter::GatewaySendLimiter(int limit, std::chrono::milliseconds window, int reserved)
+    : limit_(std::max(1, limit)), reserved_(std::clamp(reserved, 0, limit_ - 1)), window_(window),
+      window_start_(std::chrono::steady_clock::now()) {}
+
+bool GatewaySendLimiter::try_acquire(bool priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    roll_window(std::chrono::steady_clock::now());
+
+    int available = priority ? limit_ : limit_ - reserved_;
+    if (used_ >= available) {
+        return false;
+    }
+
+    used_++;
+    return true;
+}
+
+std::chrono::milliseconds GatewaySendLimiter::time_until_available(bool priority) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto now = std::chrono::steady_clock::now();
+    auto window_end = window_start_ + window_;
+    if (now >= window_end) {
+        return std::chrono::milliseconds(0);
+    }
+
+    int available = priority ? limit_ : limit_ - reserved_;
+    if (used_ < available) {
+        return std::chrono::milliseconds(0);
+    }
+
+    // Round up so a timer never fires just before the window rolls over
+    return std::chrono::ceil<std::chrono::milliseconds>(window_end - now);
+}
+
+int GatewaySendLimiter::get_remaining() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (std::chrono::steady_clock::now() >= window_start_ + window_) {
+        return limit_ - reserved_;
+    }
+
+    return std::max(0, limit_ - reserved_ - used_);
+}
+
+void GatewaySendLimiter::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    used_ = 0;
+    window_start_ = std::chrono::steady_clock::now();
+}
+
+// Private methods
+
+void GatewaySendLimiter::roll_window(std::chrono::steady_clock::time_point now) {
+    if (now - window_start_ >= window_) {
+        used_ = 0;
+        window_start_ = now;
+    }
+}
+
+} // namespace discord
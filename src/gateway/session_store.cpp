@@ -0,0 +1,300 @@
+#include <discord/gateway/session_store.h>
+#include <discord/utils/logger.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <discord/config.h>
+#ifdef DISCORD_CPP_PLATFORM_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace discord {
+
+struct SessionStore::Header {
+    char magic[4];
+    uint32_t version;
+    int32_t shard_count;
+    int32_t first_shard;
+    int32_t size;
+    uint8_t reserved[44];
+};
+
+struct SessionStore::Record {
+    uint32_t write_count; // Odd while the record is being written
+    int32_t shard_id;
+    int64_t sequence_number;
+    int64_t saved_at_ms;
+    uint16_t session_id_length;
+    uint16_t resume_url_length;
+    char session_id[MAX_SESSION_ID];
+    char resume_url[MAX_RESUME_URL];
+    uint8_t reserved[4];
+};
+
+namespace {
+
+constexpr char STORE_MAGIC[4] = {'D', 'S', 'E', 'S'};
+constexpr uint32_t STORE_VERSION = 1;
+
+constexpr intptr_t NO_FILE = -1;
+
+int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+#ifdef DISCORD_CPP_PLATFORM_WINDOWS
+
+intptr_t open_file(const std::string& path) {
+    HANDLE handle = ::CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                  nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    return handle == INVALID_HANDLE_VALUE ? NO_FILE : reinterpret_cast<intptr_t>(handle);
+}
+
+void close_file(intptr_t file) {
+    ::CloseHandle(reinterpret_cast<HANDLE>(file));
+}
+
+bool resize_file(intptr_t file, size_t size) {
+    LARGE_INTEGER length;
+    length.QuadPart = static_cast<LONGLONG>(size);
+    HANDLE handle = reinterpret_cast<HANDLE>(file);
+    return ::SetFilePointerEx(handle, length, nullptr, FILE_BEGIN) && ::SetEndOfFile(handle);
+}
+
+void* map_file(intptr_t file, size_t size) {
+    // The view keeps the mapping object alive, so its handle can be closed at once
+    HANDLE mapping = ::CreateFileMappingA(reinterpret_cast<HANDLE>(file), nullptr, PAGE_READWRITE, 0, 0, nullptr);
+    if (!mapping) {
+        return nullptr;
+    }
+    void* view = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    ::CloseHandle(mapping);
+    return view;
+}
+
+void sync_mapping(void* mapping, size_t size, intptr_t file, bool wait) {
+    ::FlushViewOfFile(mapping, size);
+    if (wait) {
+        ::FlushFileBuffers(reinterpret_cast<HANDLE>(file));
+    }
+}
+
+void unmap_file(void* mapping, size_t) {
+    ::UnmapViewOfFile(mapping);
+}
+
+#else
+
+intptr_t open_file(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+    return fd < 0 ? NO_FILE : fd;
+}
+
+void close_file(intptr_t file) {
+    ::close(static_cast<int>(file));
+}
+
+bool resize_file(intptr_t file, size_t size) {
+    return ::ftruncate(static_cast<int>(file), static_cast<off_t>(size)) == 0;
+}
+
+void* map_file(intptr_t file, size_t size) {
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, static_cast<int>(file), 0);
+    return mapping == MAP_FAILED ? nullptr : mapping;
+}
+
+void sync_mapping(void* mapping, size_t size, intptr_t, bool wait) {
+    ::msync(mapping, size, wait ? MS_SYNC : MS_ASYNC);
+}
+
+void unmap_file(void* mapping, size_t size) {
+    ::munmap(mapping, size);
+}
+
+#endif
+
+} // namespace
+
+SessionStore::SessionStore(const std::string& path, std::chrono::milliseconds max_age)
+    : path_(path), max_age_(max_age) {
+    // The file layout is shared with earlier runs of the process
+    static_assert(sizeof(Header) == 64, "session store header must stay 64 bytes");
+    static_assert(sizeof(Record) == 256, "session store records must stay 256 bytes");
+}
+
+SessionStore::~SessionStore() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    unmap();
+}
+
+bool SessionStore::open(int first_shard, int size, int shard_count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    unmap();
+
+    file_ = open_file(path_);
+    if (file_ == NO_FILE) {
+        LOG_ERROR("Cannot open session store " + path_);
+        return false;
+    }
+
+    size_t mapping_size = sizeof(Header) + static_cast<size_t>(std::max(0, size)) * sizeof(Record);
+    if (!resize_file(file_, mapping_size)) {
+        LOG_ERROR("Cannot size session store " + path_);
+        unmap();
+        return false;
+    }
+
+    void* mapping = map_file(file_, mapping_size);
+    if (!mapping) {
+        LOG_ERROR("Cannot map session store " + path_);
+        unmap();
+        return false;
+    }
+
+    mapping_ = mapping;
+    mapping_size_ = mapping_size;
+    first_shard_ = first_shard;
+    size_ = size;
+
+    // Sessions of another layout cannot be resumed by these shards
+    auto* header = static_cast<Header*>(mapping_);
+    if (std::memcmp(header->magic, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0 || header->version != STORE_VERSION ||
+        header->shard_count != shard_count || header->first_shard != first_shard || header->size != size) {
+        std::memset(mapping_, 0, mapping_size_);
+        std::memcpy(header->magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+        header->version = STORE_VERSION;
+        header->shard_count = shard_count;
+        header->first_shard = first_shard;
+        header->size = size;
+        sync_mapping(mapping_, mapping_size_, file_, false);
+    }
+
+    return true;
+}
+
+bool SessionStore::is_open() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mapping_ != nullptr;
+}
+
+void SessionStore::save(int shard_id, const std::string& session_id, int64_t sequence_number,
+                        const std::string& resume_gateway_url) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Record* slot = record(shard_id);
+    if (!slot) {
+        return;
+    }
+
+    if (session_id.size() > MAX_SESSION_ID || resume_gateway_url.size() > MAX_RESUME_URL) {
+        LOG_WARN("Session of shard " + std::to_string(shard_id) + " does not fit the session store");
+        return;
+    }
+
+    std::atomic_ref<uint32_t> write_count(slot->write_count);
+    write_count.fetch_add(1, std::memory_order_acq_rel);
+
+    slot->shard_id = shard_id;
+    slot->sequence_number = sequence_number;
+    slot->saved_at_ms = now_ms();
+    slot->session_id_length = static_cast<uint16_t>(session_id.size());
+    slot->resume_url_length = static_cast<uint16_t>(resume_gateway_url.size());
+    std::memcpy(slot->session_id, session_id.data(), session_id.size());
+    std::memcpy(slot->resume_url, resume_gateway_url.data(), resume_gateway_url.size());
+
+    write_count.fetch_add(1, std::memory_order_release);
+}
+
+void SessionStore::save_sequence(int shard_id, int64_t sequence_number) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Record* slot = record(shard_id);
+    if (!slot || slot->session_id_length == 0) {
+        return;
+    }
+
+    std::atomic_ref<uint32_t> write_count(slot->write_count);
+    write_count.fetch_add(1, std::memory_order_acq_rel);
+    slot->sequence_number = sequence_number;
+    slot->saved_at_ms = now_ms();
+    write_count.fetch_add(1, std::memory_order_release);
+}
+
+void SessionStore::clear(int shard_id) {
+    save(shard_id, "", -1, "");
+}
+
+std::optional<StoredSession> SessionStore::load(int shard_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const Record* slot = record(shard_id);
+    if (!slot) {
+        return std::nullopt;
+    }
+
+    // An odd count means the process died in the middle of writing this record
+    if (slot->write_count % 2 != 0 || slot->shard_id != shard_id || slot->session_id_length == 0 ||
+        slot->session_id_length > MAX_SESSION_ID || slot->resume_url_length > MAX_RESUME_URL) {
+        return std::nullopt;
+    }
+
+    int64_t age = now_ms() - slot->saved_at_ms;
+    if (age < 0 || age > max_age_.count()) {
+        return std::nullopt;
+    }
+
+    StoredSession session;
+    session.shard_id = shard_id;
+    session.session_id.assign(slot->session_id, slot->session_id_length);
+    session.resume_gateway_url.assign(slot->resume_url, slot->resume_url_length);
+    session.sequence_number = slot->sequence_number;
+    session.saved_at = std::chrono::system_clock::time_point(std::chrono::milliseconds(slot->saved_at_ms));
+    return session;
+}
+
+void SessionStore::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (mapping_) {
+        sync_mapping(mapping_, mapping_size_, file_, true);
+    }
+}
+
+// Private methods
+
+SessionStore::Record* SessionStore::record(int shard_id) const {
+    int index = shard_id - first_shard_;
+    if (!mapping_ || index < 0 || index >= size_) {
+        return nullptr;
+    }
+
+    auto* records = reinterpret_cast<Record*>(static_cast<char*>(mapping_) + sizeof(Header));
+    return &records[index];
+}
+
+void SessionStore::unmap() {
+    if (mapping_) {
+        sync_mapping(mapping_, mapping_size_, file_, true);
+        unmap_file(mapping_, mapping_size_);
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+    }
+
+    if (file_ != NO_FILE) {
+        close_file(file_);
+        file_ = NO_FILE;
+    }
+}
+
+} // namespace discord
@@ -23,6 +23,13 @@ ShardManager::ShardManager(const std::string& token, const ShardConfig& config)
         config_.shard_count = calculate_shard_count();
     }
     
+    update_shard_range();
+    shards_.store(create_shard_set(config_.shard_count));
+    
+    member_chunker_ = std::make_unique<MemberChunker>(
+        [this](Snowflake guild_id, const nlohmann::json& payload) { return send_to_guild(guild_id, payload); },
+        [this](Snowflake guild_id) { return get_shard_for_guild(guild_id); });
+    
     LOG_INFO("ShardManager initialized with " + std::to_string(config_.shard_count) + " shards");
 }
 
@@ -44,38 +51,35 @@ bool ShardManager::start() {
     is_running_ = true;
     is_shutting_down_ = false;
     
-    LOG_INFO("Starting " + std::to_string(config_.shard_count) + " shards");
-    
-    // Start connection threads with concurrency limits
-    for (int i = 0; i < config_.shard_count; ++i) {
-        if (!can_start_session()) {
-            wait_for_session_slot();
-        }
-        
-        connection_threads_.emplace_back([this, i]() {
-            if (is_shutting_down_.load()) return;
-            
-            try {
-                connect_shard(i);
-            } catch (const std::exception& e) {
-                LOG_ERROR("Failed to connect shard " + std::to_string(i) + ": " + e.what());
-            }
-        });
-        
-        // Add delay between connections to respect rate limits
-        if (i < config_.shard_count - 1) {
-            std::this_thread::sleep_for(config_.connection_delay);
-        }
+    update_shard_range();
+    auto set = active_set();
+    if (set->shard_count != config_.shard_count || set->range.first != shard_range_.first ||
+        set->range.last != shard_range_.last) {
+        // Same range keeps the sessions stop() kept, for resuming after stop()/start()
+        set = create_shard_set(config_.shard_count);
+        shards_.store(set);
     }
+    set->role = ShardSet::Role::ACTIVE;
+    open_session_store(*set);
     
-    // Wait for all connection threads to complete
-    for (auto& thread : connection_threads_) {
-        if (thread.joinable()) {
-            thread.join();
-        }
+    start_event_loops();
+    if (cluster_) {
+        cluster_->publish_state("starting", shard_range_);
     }
     
-    connection_threads_.clear();
+    // IDENTIFYs are released per rate limit bucket, max_concurrency every 5 seconds
+    create_identify_scheduler();
+    
+    LOG_INFO("Starting shards " + std::to_string(shard_range_.first) + "-" + std::to_string(shard_range_.last) +
+             " of " + std::to_string(config_.shard_count) + ", " +
+             std::to_string(identify_scheduler_->get_max_concurrency()) + " identifying in parallel");
+    
+    connect_set(*set);
+    start_health_monitor();
+    
+    if (cluster_) {
+        cluster_->publish_state("running", shard_range_);
+    }
     
     LOG_INFO("All shards started");
     return true;
@@ -91,106 +95,185 @@ void ShardManager::stop() {
     
     LOG_INFO("Stopping all shards");
     
-    // Disconnect all shards
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& [shard_id, client] : shards_) {
-        if (client) {
-            client->disconnect();
-        }
+    // Chunks of outstanding member requests will not arrive any more
+    member_chunker_->cancel_all();
+    stop_health_monitor();
+    
+    // No queued IDENTIFY may fire into a client that is being destroyed
+    if (identify_scheduler_) {
+        identify_scheduler_->stop();
     }
     
-    // Wait for connection threads
-    for (auto& thread : connection_threads_) {
+    // Reconnect jobs see is_shutting_down_ and finish; they briefly take mutex_
+    std::vector<std::thread> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs.swap(connection_threads_);
+    }
+    for (auto& thread : jobs) {
         if (thread.joinable()) {
             thread.join();
         }
     }
     
-    connection_threads_.clear();
-    shards_.clear();
-    shard_info_.clear();
+    // With a session store the sessions outlive this process, so they must stay valid
+    persist_sessions();
+    bool keep_sessions = session_store_ != nullptr;
+    if (session_store_) {
+        session_store_->flush();
+    }
+    
+    // Detach every client under mutex_, including a set still warming up for a reshard, and
+    // tear them down without it: running handlers may take mutex_ (send_to_shard(), member requests)
+    auto set = active_set();
+    std::vector<std::unique_ptr<WebSocketClient>> clients;
+    size_t kept_clients = 0; // Leading entries of clients whose session is kept
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (ShardSet* shard_set : {set.get(), pending_shards_.get()}) {
+            if (!shard_set) {
+                continue;
+            }
+            for (auto& client : shard_set->clients) {
+                if (client) {
+                    clients.push_back(std::move(client));
+                }
+            }
+            if (shard_set == set.get() && keep_sessions) {
+                kept_clients = clients.size();
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < clients.size(); ++i) {
+        clients[i]->disconnect(i < kept_clients);
+    }
+    
+    // Stop the event loops before destroying the clients they drive
+    stop_event_loops();
+    clients.clear();
+    
+    // start() reuses this set for the same range; only a kept session may carry over
+    for (int shard_id = set->range.first; shard_id <= set->range.last; ++shard_id) {
+        ShardState* state = set->states.get(shard_id);
+        state->is_connected.store(false, std::memory_order_relaxed);
+        if (!keep_sessions) {
+            state->clear_session();
+        }
+    }
+    identify_scheduler_.reset();
+    
+    if (cluster_) {
+        cluster_->publish_state("stopped", shard_range_);
+    }
     
     LOG_INFO("All shards stopped");
 }
 
 bool ShardManager::connect_shard_by_id(int shard_id) {
-    if (shard_id < 0 || shard_id >= config_.shard_count) {
+    if (!shard_range_.contains(shard_id)) {
         LOG_ERROR("Invalid shard ID: " + std::to_string(shard_id));
         return false;
     }
     
-    std::lock_guard<std::mutex> lock(mutex_);
-    connect_shard(shard_id);
+    connect_shard(*active_set(), shard_id);
     return true;
 }
 
 void ShardManager::disconnect_shard_by_id(int shard_id) {
     std::lock_guard<std::mutex> lock(mutex_);
-    disconnect_shard(shard_id);
+    disconnect_shard(*active_set(), shard_id);
 }
 
 void ShardManager::reconnect_shard(int shard_id, bool resume) {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = shards_.find(shard_id);
-    if (it != shards_.end()) {
-        disconnect_shard(shard_id);
-        
-        if (resume && shard_info_[shard_id].is_resumable) {
-            // Attempt resume after a short delay
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-            connect_shard(shard_id);
+    restart_shard(*active_set(), shard_id, resume);
+}
+
+std::future<void> ShardManager::reconnect_all(bool resume) {
+    auto set = active_set();
+    
+    std::vector<int> resumes;
+    std::vector<int> identifies;
+    for (int shard_id = set->range.first; shard_id <= set->range.last; ++shard_id) {
+        const ShardState* state = set->states.get(shard_id);
+        if (resume && state->is_resumable.load(std::memory_order_acquire)) {
+            resumes.push_back(shard_id);
         } else {
-            // Force identify
-            shard_info_[shard_id].session_id.clear();
-            shard_info_[shard_id].sequence_number = 0;
-            connect_shard(shard_id);
+            identifies.push_back(shard_id);
         }
     }
-}
-
-void ShardManager::reconnect_all(bool resume) {
-    std::lock_guard<std::mutex> lock(mutex_);
     
-    for (int i = 0; i < config_.shard_count; ++i) {
-        if (shards_.find(i) != shards_.end()) {
-            disconnect_shard(i);
+    // Only one job runs at a time; the previous one stops at its next shard
+    uint64_t job = ++reconnect_job_;
+    std::vector<std::thread> previous;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        previous.swap(connection_threads_);
+    }
+    for (auto& thread : previous) {
+        if (thread.joinable()) {
+            thread.join();
         }
     }
     
-    // Wait a bit before reconnecting
-    std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+    LOG_INFO("Reconnecting shards: " + std::to_string(resumes.size()) + " resuming, " +
+             std::to_string(identifies.size()) + " identifying");
     
-    for (int i = 0; i < config_.shard_count; ++i) {
-        if (!resume || !shard_info_[i].is_resumable) {
-            shard_info_[i].session_id.clear();
-            shard_info_[i].sequence_number = 0;
-        }
-        connect_shard(i);
-        
-        if (i < config_.shard_count - 1) {
-            std::this_thread::sleep_for(config_.connection_delay);
-        }
-    }
+    auto done = std::make_shared<std::promise<void>>();
+    std::future<void> result = done->get_future();
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    connection_threads_.emplace_back([this, set, job, done, resumes = std::move(resumes),
+                                      identifies = std::move(identifies)]() mutable {
+        run_reconnect_job(std::move(set), job, std::move(resumes), std::move(identifies));
+        done->set_value();
+    });
+    
+    return result;
 }
 
 bool ShardManager::send_to_shard(int shard_id, const nlohmann::json& event) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = shards_.find(shard_id);
-    if (it != shards_.end() && it->second) {
-        it->second->send(event);
+    WebSocketClient* client = active_set()->get_client(shard_id);
+    if (client) {
+        client->send(event);
+        return true;
+    }
+    
+    return false;
+}
+
+bool ShardManager::send_to_guild(Snowflake guild_id, const nlohmann::json& payload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto set = active_set();
+    
+    // Shard IDs index the client table directly; guilds of other clusters are not ours to send for
+    WebSocketClient* client = set->get_client(set->shard_for_guild(guild_id));
+    if (client) {
+        client->send(payload);
         return true;
     }
     
     return false;
 }
 
+std::future<MemberChunkResult> ShardManager::request_guild_members(Snowflake guild_id,
+                                                                   const MemberChunkOptions& options) {
+    return member_chunker_->request(guild_id, options);
+}
+
+MemberChunker& ShardManager::get_member_chunker() {
+    return *member_chunker_;
+}
+
 int ShardManager::send_to_all_shards(const nlohmann::json& event) {
     std::lock_guard<std::mutex> lock(mutex_);
+    auto set = active_set();
     
     int sent_count = 0;
-    for (auto& [shard_id, client] : shards_) {
+    for (auto& client : set->clients) {
         if (client) {
             client->send(event);
             sent_count++;
@@ -200,58 +283,287 @@ int ShardManager::send_to_all_shards(const nlohmann::json& event) {
     return sent_count;
 }
 
-const ShardInfo* ShardManager::get_shard_info(int shard_id) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = shard_info_.find(shard_id);
-    if (it != shard_info_.end()) {
-        return &it->second;
+std::optional<ShardInfo> ShardManager::get_shard_info(int shard_id) const {
+    auto set = active_set();
+    if (!set->states.get(shard_id)) {
+        return std::nullopt;
     }
     
-    return nullptr;
+    return set->states.snapshot(shard_id);
 }
 
 std::unordered_map<int, ShardInfo> ShardManager::get_all_shard_info() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return shard_info_;
+    auto set = active_set();
+    std::unordered_map<int, ShardInfo> all_info;
+    all_info.reserve(set->states.size());
+    
+    for (int shard_id = set->range.first; shard_id <= set->range.last; ++shard_id) {
+        all_info.emplace(shard_id, set->states.snapshot(shard_id));
+    }
+    
+    return all_info;
 }
 
 int ShardManager::get_connected_shard_count() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    return active_set()->states.count_connected();
+}
+
+int ShardManager::get_shard_for_guild(Snowflake guild_id) const {
+    return active_set()->shard_for_guild(guild_id);
+}
+
+int ShardManager::get_shard_for_guild(std::string_view guild_id) const {
+    auto id = parse_snowflake(guild_id);
+    return id ? active_set()->shard_for_guild(*id) : -1;
+}
+
+int ShardManager::get_total_shard_count() const {
+    return active_set()->shard_count;
+}
+
+ShardRange ShardManager::get_shard_range() const {
+    return active_set()->range;
+}
+
+int ShardManager::get_shard_group(int shard_id) const {
+    if (config_.shard_groups <= 0) {
+        return -1;
+    }
+    return shard_id % config_.shard_groups;
+}
+
+ClusterCoordinator* ShardManager::get_cluster_coordinator() const {
+    return cluster_.get();
+}
+
+bool ShardManager::rolling_restart(std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    
+    // Only one cluster per host restarts at a time, so capacity drops by one range at most
+    if (cluster_ && !cluster_->begin_restart(timeout)) {
+        return false;
+    }
+    
+    LOG_INFO("Rolling restart of shards " + std::to_string(shard_range_.first) + "-" +
+             std::to_string(shard_range_.last));
+    
+    if (cluster_) {
+        cluster_->publish_state("restarting", shard_range_);
+    }
+    
+    stop();
+    
+    // connect_shard() marks a shard connected before its handshake; wait for READY or RESUMED instead
+    auto previous_set = active_set();
+    std::vector<uint32_t> previous_handshakes;
+    for (int shard_id = previous_set->range.first; shard_id <= previous_set->range.last; ++shard_id) {
+        previous_handshakes.push_back(previous_set->states.get(shard_id)->handshakes.load(std::memory_order_acquire));
+    }
     
-    int count = 0;
-    for (const auto& [shard_id, info] : shard_info_) {
-        if (info.is_connected) {
-            count++;
+    bool ready = start();
+    
+    // Hold the restart lock until every owned shard sent READY or RESUMED on its new connection
+    while (ready) {
+        auto set = active_set();
+        int ready_count = 0;
+        for (int shard_id = set->range.first; shard_id <= set->range.last; ++shard_id) {
+            size_t index = static_cast<size_t>(shard_id - set->range.first);
+            uint32_t before = set == previous_set ? previous_handshakes[index] : 0;
+            if (set->states.get(shard_id)->handshakes.load(std::memory_order_acquire) != before) {
+                ready_count++;
+            }
+        }
+        
+        if (ready_count >= shard_range_.size()) {
+            break;
         }
+        
+        if (std::chrono::steady_clock::now() >= deadline) {
+            LOG_WARN("Rolling restart timed out with " + std::to_string(ready_count) + "/" +
+                     std::to_string(shard_range_.size()) + " shards ready");
+            ready = false;
+            break;
+        }
+        
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
     }
     
-    return count;
+    if (cluster_) {
+        cluster_->publish_state(ready ? "running" : "degraded", shard_range_);
+        cluster_->end_restart();
+    }
+    
+    return ready;
 }
 
-int ShardManager::get_total_shard_count() const {
-    return config_.shard_count;
+bool ShardManager::reshard(int new_shard_count, std::chrono::milliseconds timeout) {
+    if (!is_running_.load()) {
+        LOG_WARN("Cannot reshard while ShardManager is stopped");
+        return false;
+    }
+    
+    if (new_shard_count <= 0 || new_shard_count < config_.cluster_count) {
+        LOG_ERROR("Invalid shard count for reshard: " + std::to_string(new_shard_count));
+        return false;
+    }
+    
+    if (is_resharding_.exchange(true)) {
+        LOG_WARN("A reshard is already in progress");
+        return false;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto old_set = active_set();
+    auto new_set = create_shard_set(new_shard_count);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_shards_ = new_set;
+    }
+    
+    LOG_INFO("Resharding from " + std::to_string(old_set->shard_count) + " to " +
+             std::to_string(new_shard_count) + " shards");
+    if (cluster_) {
+        cluster_->publish_state("resharding", new_set->range);
+    }
+    
+    // The new set identifies through the same buckets; the old one keeps serving meanwhile
+    connect_set(*new_set);
+    
+    int size = new_set->range.size();
+    while (new_set->states.count_warm() < size &&
+           std::chrono::steady_clock::now() < deadline &&
+           !is_shutting_down_.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+    
+    // Guilds that stay unavailable never arrive; a set with every session is good enough
+    bool ready = new_set->states.count_resumable() >= size && !is_shutting_down_.load();
+    if (!ready) {
+        LOG_ERROR("Reshard aborted: " + std::to_string(new_set->states.count_resumable()) + "/" +
+                  std::to_string(size) + " new shards ready");
+        retire_set(*new_set);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_shards_.reset();
+        }
+        if (cluster_) {
+            cluster_->publish_state(is_running_.load() ? "running" : "stopped", shard_range_);
+        }
+        is_resharding_ = false;
+        return false;
+    }
+    
+    if (new_set->states.count_warm() < size) {
+        LOG_WARN("Switching shard sets before all guilds became available");
+    }
+    
+    // Remember what the old set delivers so the new set does not repeat it
+    deduplicator_.clear();
+    deduplicate_events_ = true;
+    std::this_thread::sleep_for(config_.reshard_overlap);
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        new_set->role = ShardSet::Role::ACTIVE;
+        old_set->role = ShardSet::Role::RETIRING;
+        shards_.store(new_set);
+        pending_shards_.reset();
+        config_.shard_count = new_shard_count;
+        shard_range_ = new_set->range;
+    }
+    
+    if (session_store_ && session_store_->open(new_set->range.first, new_set->range.size(), new_shard_count)) {
+        persist_sessions();
+    }
+    
+    LOG_INFO("Event delivery switched to " + std::to_string(new_shard_count) + " shards");
+    if (cluster_) {
+        cluster_->publish_state("running", shard_range_);
+    }
+    
+    // The old set still delivers whatever the new one has not caught up on
+    std::this_thread::sleep_for(config_.reshard_overlap);
+    retire_set(*old_set);
+    
+    deduplicate_events_ = false;
+    deduplicator_.clear();
+    is_resharding_ = false;
+    
+    LOG_INFO("Reshard to " + std::to_string(new_shard_count) + " shards complete");
+    return true;
 }
 
-bool ShardManager::is_running() const {
-    return is_running_.load();
+bool ShardManager::is_resharding() const {
+    return is_resharding_.load();
 }
 
-bool ShardManager::is_shard_connected(int shard_id) const {
+nlohmann::json ShardStatistics::to_json() const {
+    nlohmann::json stats;
+    stats["total_shards"] = total_shards;
+    stats["shard_groups"] = shard_groups;
+    stats["first_shard"] = first_shard;
+    stats["last_shard"] = last_shard;
+    stats["cluster_id"] = cluster_id;
+    stats["cluster_count"] = cluster_count;
+    stats["connected_shards"] = connected_shards;
+    stats["is_running"] = is_running;
+    stats["is_resharding"] = is_resharding;
+    stats["sessions_started_recently"] = sessions_started_recently;
+    stats["remaining_session_starts"] = remaining_session_starts;
+    stats["pending_identifies"] = pending_identifies;
+    
+    nlohmann::json shard_stats = nlohmann::json::object();
+    for (const auto& health : shards) {
+        nlohmann::json shard_info;
+        shard_info["is_connected"] = health.is_connected;
+        shard_info["is_resumable"] = health.is_resumable;
+        shard_info["reconnect_attempts"] = health.reconnect_attempts;
+        shard_info["sequence_number"] = health.sequence_number;
+        shard_info["sequence_gaps"] = health.sequence_gaps;
+        shard_info["events_received"] = health.events_received;
+        shard_info["events_per_second"] = health.events_per_second;
+        shard_info["latency_ms"] = health.heartbeat_latency.count();
+        shard_info["missed_heartbeat_acks"] = health.missed_acks;
+        shard_info["zombie_restarts"] = health.zombie_restarts;
+        shard_info["silence_ms"] = health.silence.count();
+        shard_info["uptime_seconds"] = health.uptime.count();
+        
+        shard_stats[std::to_string(health.shard_id)] = shard_info;
+    }
+    
+    stats["shards"] = shard_stats;
+    return stats;
+}
+
+std::chrono::milliseconds ShardManager::get_shard_latency(int shard_id) const {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = shard_info_.find(shard_id);
-    if (it != shard_info_.end()) {
-        return it->second.is_connected;
+    WebSocketClient* client = active_set()->get_client(shard_id);
+    if (client) {
+        return client->get_latency();
     }
     
-    return false;
+    return std::chrono::milliseconds(-1);
+}
+
+bool ShardManager::is_running() const {
+    return is_running_.load();
+}
+
+bool ShardManager::is_shard_connected(int shard_id) const {
+    auto set = active_set();
+    const ShardState* state = set->states.get(shard_id);
+    return state && state->is_connected.load(std::memory_order_relaxed);
 }
 
 void ShardManager::set_event_callback(EventCallback callback) {
     event_callback_ = std::move(callback);
 }
 
+void ShardManager::set_frame_callback(FrameCallback callback) {
+    frame_callback_ = std::move(callback);
+}
+
 void ShardManager::set_shard_state_callback(ShardStateCallback callback) {
     shard_state_callback_ = std::move(callback);
 }
@@ -260,6 +572,10 @@ void ShardManager::set_ready_callback(ReadyCallback callback) {
     ready_callback_ = std::move(callback);
 }
 
+void ShardManager::set_warmup_callback(EventCallback callback) {
+    warmup_callback_ = std::move(callback);
+}
+
 void ShardManager::set_config(const ShardConfig& config) {
     if (is_running_.load()) {
         LOG_WARN("Cannot update configuration while ShardManager is running");
@@ -277,54 +593,52 @@ const GatewaySession& ShardManager::get_session_info() const {
     return session_info_;
 }
 
-void ShardManager::identify_all() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    for (auto& [shard_id, info] : shard_info_) {
-        info.session_id.clear();
-        info.sequence_number = 0;
-        info.is_resumable = false;
+std::future<void> ShardManager::identify_all() {
+    auto set = active_set();
+    for (int shard_id = set->range.first; shard_id <= set->range.last; ++shard_id) {
+        set->states.get(shard_id)->clear_session();
     }
     
-    reconnect_all(false);
+    return reconnect_all(false);
 }
 
-void ShardManager::resume_all() {
-    reconnect_all(true);
+std::future<void> ShardManager::resume_all() {
+    return reconnect_all(true);
 }
 
-nlohmann::json ShardManager::get_statistics() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    nlohmann::json stats;
-    stats["total_shards"] = config_.shard_count;
-    stats["connected_shards"] = get_connected_shard_count();
-    stats["is_running"] = is_running_.load();
-    stats["sessions_started_recently"] = sessions_started_recently_.load();
+ShardStatistics ShardManager::get_statistics() const {
+    auto set = active_set();
+    
+    ShardStatistics stats;
+    stats.total_shards = set->shard_count;
+    stats.first_shard = set->range.first;
+    stats.last_shard = set->range.last;
+    stats.shard_groups = config_.shard_groups;
+    if (cluster_) {
+        stats.cluster_id = cluster_->get_cluster_id();
+        stats.cluster_count = cluster_->get_cluster_count();
+    }
+    stats.connected_shards = set->states.count_connected();
+    stats.is_running = is_running_.load();
+    stats.is_resharding = is_resharding_.load();
+    stats.sessions_started_recently = sessions_started_recently_.load();
+    if (identify_scheduler_) {
+        stats.remaining_session_starts = identify_scheduler_->get_remaining_session_starts();
+        stats.pending_identifies = identify_scheduler_->get_pending_count();
+    }
     
-    nlohmann::json shard_stats = nlohmann::json::object();
-    for (const auto& [shard_id, info] : shard_info_) {
-        nlohmann::json shard_info;
-        shard_info["is_connected"] = info.is_connected;
-        shard_info["is_resumable"] = info.is_resumable;
-        shard_info["reconnect_attempts"] = info.reconnect_attempts;
-        shard_info["sequence_number"] = info.sequence_number;
-        
-        auto now = std::chrono::steady_clock::now();
-        auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - info.connect_time);
-        shard_info["uptime_seconds"] = uptime.count();
-        
-        shard_stats[std::to_string(shard_id)] = shard_info;
+    stats.shards.reserve(static_cast<size_t>(set->range.size()));
+    for (int shard_id = set->range.first; shard_id <= set->range.last; ++shard_id) {
+        stats.shards.push_back(set->states.health(shard_id));
     }
     
-    stats["shards"] = shard_stats;
     return stats;
 }
 
 void ShardManager::set_auto_reconnect(bool enabled) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    for (auto& [shard_id, client] : shards_) {
+    for (auto& client : active_set()->clients) {
         if (client) {
             client->enable_auto_reconnect(enabled);
         }
@@ -336,7 +650,7 @@ void ShardManager::set_reconnection_config(int max_retries,
                                         std::chrono::milliseconds max_delay) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    for (auto& [shard_id, client] : shards_) {
+    for (auto& client : active_set()->clients) {
         if (client) {
             client->set_reconnection_config(max_retries, base_delay, max_delay);
         }
@@ -345,143 +659,336 @@ void ShardManager::set_reconnection_config(int max_retries,
 
 // Private methods
 
-bool ShardManager::initialize_shard(int shard_id) {
-    if (shard_id < 0 || shard_id >= config_.shard_count) {
-        return false;
+std::shared_ptr<ShardSet> ShardManager::active_set() const {
+    return shards_.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<ShardSet> ShardManager::create_shard_set(int shard_count) {
+    return std::make_shared<ShardSet>(next_generation_++, shard_count, get_range_for(shard_count));
+}
+
+void ShardManager::connect_set(ShardSet& set) {
+    int concurrency = identify_scheduler_ ? identify_scheduler_->get_max_concurrency() : 1;
+    int released_before = identifies_released_.load();
+    
+    // Connect in waves of max_concurrency shards; a wave may connect while the one
+    // before it is still waiting for its bucket, so sockets never idle for long
+    for (int offset = 0; offset < set.range.size() && !is_shutting_down_.load(); offset += concurrency) {
+        auto wave_deadline = std::chrono::steady_clock::now() + 2 * IdentifyScheduler::DEFAULT_BUCKET_INTERVAL;
+        while (identifies_released_.load() - released_before < offset - concurrency &&
+               std::chrono::steady_clock::now() < wave_deadline &&
+               !is_shutting_down_.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        
+        int wave_start = set.range.first + offset;
+        int wave_end = std::min(wave_start + concurrency, set.range.last + 1);
+        for (int i = wave_start; i < wave_end; ++i) {
+            try {
+                connect_shard(set, i);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Failed to connect shard " + std::to_string(i) + ": " + e.what());
+            }
+        }
+    }
+}
+
+void ShardManager::retire_set(ShardSet& set) {
+    set.role = ShardSet::Role::RETIRING;
+    
+    if (identify_scheduler_) {
+        for (int shard_id = set.range.first; shard_id <= set.range.last; ++shard_id) {
+            identify_scheduler_->cancel(shard_id, set.generation);
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& client : set.clients) {
+            if (client) {
+                client->disconnect();
+            }
+        }
     }
     
+    // Close handshakes complete on the event loops, which keep running
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (set.states.count_connected() > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    
+    // Destroy outside mutex_: a client waits for its running handlers, which may take it
+    std::vector<std::unique_ptr<WebSocketClient>> clients;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& client : set.clients) {
+            clients.push_back(std::move(client));
+        }
+    }
+    clients.clear();
+}
+
+WebSocketClient* ShardManager::initialize_shard(ShardSet& set, int shard_id) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    // Create shard info if it doesn't exist
-    if (shard_info_.find(shard_id) == shard_info_.end()) {
-        shard_info_.emplace(shard_id, ShardInfo(shard_id, config_.shard_count));
+    auto* slot = set.slot(shard_id);
+    if (!slot) {
+        return nullptr;
     }
     
     // Create WebSocket client if it doesn't exist
-    if (shards_.find(shard_id) == shards_.end()) {
-        auto client = std::make_unique<WebSocketClient>();
+    if (!*slot) {
+        ShardSet* shard_set = &set;
+        uint64_t generation = set.generation;
+        
+        auto client = std::make_unique<WebSocketClient>(get_event_loop(shard_id));
         client->set_token(bot_token_);
         client->set_intents(0); // Will be set by caller
+        client->set_shard(shard_id, set.shard_count);
+        client->set_identify_gate([this, shard_id, generation](std::function<void()> identify) {
+            if (!identify_scheduler_) {
+                identify();
+                return;
+            }
+            identify_scheduler_->schedule(shard_id, [this, identify = std::move(identify)]() {
+                identify();
+                identifies_released_++;
+            }, generation);
+        });
         
-        // Set up event handlers
-        client->on_event([this, shard_id](const nlohmann::json& event) {
-            handle_shard_event(shard_id, event);
+        // Set up event handlers; the set outlives its clients
+        client->on_event([this, shard_set, shard_id](const nlohmann::json& event) {
+            handle_shard_event(*shard_set, shard_id, event);
+        });
+        if (frame_callback_) {
+            client->on_frame([this, shard_set, shard_id](std::string_view frame, const FrameHeader& header) {
+                return handle_shard_frame(*shard_set, shard_id, frame, header);
+            });
+        }
+        client->on_close([this, shard_set, shard_id](int close_code, const std::string& reason) {
+            handle_shard_disconnect(*shard_set, shard_id, close_code, reason);
         });
         
-        shards_[shard_id] = std::move(client);
+        *slot = std::move(client);
     }
     
-    return true;
+    return slot->get();
 }
 
-void ShardManager::connect_shard(int shard_id) {
-    if (!initialize_shard(shard_id)) {
+void ShardManager::connect_shard(ShardSet& set, int shard_id) {
+    WebSocketClient* shard = initialize_shard(set, shard_id);
+    if (!shard) {
         return;
     }
     
-    auto& shard = shards_[shard_id];
-    auto& info = shard_info_[shard_id];
+    ShardState* state = set.states.get(shard_id);
+    
+    LOG_INFO("Connecting shard " + std::to_string(shard_id) + "/" + std::to_string(set.shard_count));
     
-    LOG_INFO("Connecting shard " + std::to_string(shard_id));
+    // Connect to gateway; a known session is resumed on its resume_gateway_url
+    std::string url = get_gateway_url();
+    ShardInfo info = set.states.snapshot(shard_id);
+    bool resume = info.is_resumable && !info.session_id.empty();
     
-    // Update session start limits
-    sessions_started_recently_++;
+    // Only IDENTIFYs use up the session start limit
     update_session_limits();
+    if (!resume) {
+        sessions_started_recently_++;
+    }
+    if (resume) {
+        shard->restore_session(info.session_id, info.sequence_number, info.resume_gateway_url);
+    }
     
-    // Connect to gateway
-    std::string url = get_gateway_url();
-    if (shard->connect(url)) {
-        info.is_connected = true;
-        info.connect_time = std::chrono::steady_clock::now();
-        info.reconnect_attempts = 0;
+    if (shard->connect(url, resume)) {
+        state->is_connected = true;
+        state->record_connect(true);
         
-        // Send identify or resume
-        if (info.is_resumable && !info.session_id.empty()) {
-            resume_shard(shard_id, nlohmann::json{});
+        // Send identify or resume (performed once HELLO arrives)
+        if (resume) {
+            resume_shard(*shard, shard_id);
         } else {
-            identify_shard(shard_id);
+            identify_shard(*shard, shard_id);
         }
         
-        if (shard_state_callback_) {
-            shard_state_callback_(shard_id, true);
-        }
+        notify_shard_state(set, shard_id, true);
         
         LOG_INFO("Shard " + std::to_string(shard_id) + " connected successfully");
     } else {
-        info.is_connected = false;
-        info.reconnect_attempts++;
+        state->record_connect(false);
         
         LOG_ERROR("Failed to connect shard " + std::to_string(shard_id));
         
-        if (shard_state_callback_) {
-            shard_state_callback_(shard_id, false);
-        }
+        notify_shard_state(set, shard_id, false);
     }
 }
 
-void ShardManager::disconnect_shard(int shard_id) {
-    auto it = shards_.find(shard_id);
-    if (it != shards_.end() && it->second) {
-        it->second->disconnect();
+void ShardManager::disconnect_shard(ShardSet& set, int shard_id) {
+    WebSocketClient* client = set.get_client(shard_id);
+    if (client) {
+        client->disconnect();
         
-        auto& info = shard_info_[shard_id];
-        info.is_connected = false;
+        set.states.get(shard_id)->is_connected = false;
         
-        if (shard_state_callback_) {
-            shard_state_callback_(shard_id, false);
-        }
+        notify_shard_state(set, shard_id, false);
         
         LOG_INFO("Shard " + std::to_string(shard_id) + " disconnected");
     }
 }
 
-void ShardManager::handle_shard_event(int shard_id, const nlohmann::json& event) {
-    auto& info = shard_info_[shard_id];
+void ShardManager::handle_shard_event(ShardSet& set, int shard_id, const nlohmann::json& event) {
+    // Hot path: only this shard's event thread writes its slot, no lock needed
+    ShardState* state = set.states.get(shard_id);
+    if (!state) {
+        return;
+    }
     
     // Update sequence number for dispatch events
-    if (event.contains("op") && event["op"] == 0 && event.contains("s")) {
-        info.sequence_number = event.value("s", 0);
-    }
+    auto seq = event.find("s");
+    bool has_sequence = seq != event.end() && seq->is_number_integer() && event.value("op", -1) == 0;
+    record_shard_event(*state, has_sequence ? seq->get<int64_t>() : -1);
     
     // Handle specific events
-    if (event.contains("t")) {
-        std::string event_type = event["t"];
+    auto type = event.find("t");
+    bool is_dispatch = type != event.end() && type->is_string();
+    bool is_guild_create = false;
+    bool is_member_chunk = false;
+    
+    if (is_dispatch) {
+        const auto& event_type = type->get_ref<const std::string&>();
         
         if (event_type == "READY") {
-            handle_shard_ready(shard_id, event["d"]);
+            handle_shard_ready(set, shard_id, event["d"]);
         } else if (event_type == "RESUMED") {
-            handle_shard_resume(shard_id, event["d"]);
+            handle_shard_resume(set, shard_id);
+        } else if (event_type == "GUILD_MEMBERS_CHUNK") {
+            is_member_chunk = true;
+        } else if (event_type == "GUILD_CREATE") {
+            is_guild_create = true;
+            int pending = state->guilds_pending.load(std::memory_order_relaxed);
+            if (pending > 0) {
+                state->guilds_pending.store(pending - 1, std::memory_order_relaxed);
+            }
         }
     }
     
+    // A set that is still warming up only feeds caches
+    if (set.role.load(std::memory_order_acquire) == ShardSet::Role::PENDING) {
+        if (is_guild_create && warmup_callback_) {
+            warmup_callback_(shard_id, event);
+        }
+        return;
+    }
+    
+    // Chunks answering our own requests stream into the member cache instead
+    if (is_member_chunk && member_chunker_->handle_event(event)) {
+        return;
+    }
+    
+    // While two sets overlap the first copy of each dispatch wins
+    if (is_dispatch && deduplicate_events_.load(std::memory_order_acquire) && !deduplicator_.check(event)) {
+        return;
+    }
+    
     // Forward to user callback
     if (event_callback_) {
         event_callback_(shard_id, event);
     }
 }
 
-void ShardManager::handle_shard_ready(int shard_id, const nlohmann::json& ready_data) {
-    auto& info = shard_info_[shard_id];
+bool ShardManager::handle_shard_frame(ShardSet& set, int shard_id, std::string_view frame, const FrameHeader& header) {
+    ShardState* state = set.states.get(shard_id);
+    
+    // Warmup, member requests and deduplication need the parsed event
+    if (!state || header.type == EventType::GUILD_CREATE || header.type == EventType::GUILD_MEMBERS_CHUNK ||
+        deduplicate_events_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    
+    // A set that is still warming up delivers nothing else anyway
+    if (set.role.load(std::memory_order_acquire) != ShardSet::Role::PENDING && !frame_callback_(shard_id, frame)) {
+        return false;
+    }
+    
+    record_shard_event(*state, header.sequence);
+    return true;
+}
+
+void ShardManager::record_shard_event(ShardState& state, int64_t sequence) {
+    state.events_received.fetch_add(1, std::memory_order_relaxed);
+    state.last_event.store(ShardState::Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    
+    if (sequence >= 0) {
+        int64_t previous = state.sequence_number.load(std::memory_order_relaxed);
+        if (previous >= 0 && sequence > previous + 1) {
+            state.sequence_gaps.fetch_add(static_cast<uint64_t>(sequence - previous - 1), std::memory_order_relaxed);
+        }
+        state.sequence_number.store(sequence, std::memory_order_relaxed);
+    }
+}
+
+void ShardManager::handle_shard_disconnect(ShardSet& set, int shard_id, int close_code, const std::string& reason) {
+    ShardState* state = set.states.get(shard_id);
+    if (!state) {
+        return;
+    }
+    
+    state->is_connected = false;
     
-    info.session_id = ready_data.value("session_id", "");
-    info.is_resumable = true;
-    info.sequence_number = 0;
+    // The client reconnects on its own; these codes end the session for good
+    if (close_code == static_cast<int>(GatewayCloseEvent::INVALID_SEQ) ||
+        close_code == static_cast<int>(GatewayCloseEvent::SESSION_TIMED_OUT)) {
+        state->clear_session();
+        if (session_store_ && set.role.load(std::memory_order_acquire) == ShardSet::Role::ACTIVE) {
+            session_store_->clear(shard_id);
+        }
+    }
     
-    LOG_INFO("Shard " + std::to_string(shard_id) + " is ready");
+    LOG_WARN("Shard " + std::to_string(shard_id) + " disconnected: " + std::to_string(close_code) + " " + reason);
     
-    if (ready_callback_) {
+    notify_shard_state(set, shard_id, false);
+}
+
+void ShardManager::handle_shard_ready(ShardSet& set, int shard_id, const nlohmann::json& ready_data) {
+    ShardState* state = set.states.get(shard_id);
+    
+    // READY itself carries the first sequence number; keep it
+    state->set_session(ready_data.value("session_id", ""), ready_data.value("resume_gateway_url", ""));
+    state->is_connected = true;
+    state->handshakes.fetch_add(1, std::memory_order_release);
+    
+    // Every guild listed here follows as a GUILD_CREATE
+    auto guilds = ready_data.find("guilds");
+    int guild_count = guilds != ready_data.end() && guilds->is_array() ? static_cast<int>(guilds->size()) : 0;
+    state->guilds_pending.store(guild_count, std::memory_order_relaxed);
+    
+    if (session_store_ && set.role.load(std::memory_order_acquire) == ShardSet::Role::ACTIVE) {
+        session_store_->save(shard_id, ready_data.value("session_id", ""),
+                             state->sequence_number.load(std::memory_order_relaxed),
+                             ready_data.value("resume_gateway_url", ""));
+    }
+    
+    LOG_INFO("Shard " + std::to_string(shard_id) + "/" + std::to_string(set.shard_count) + " is ready");
+    
+    if (ready_callback_ && set.role.load(std::memory_order_acquire) != ShardSet::Role::PENDING) {
         ready_callback_(shard_id, ready_data);
     }
 }
 
-void ShardManager::handle_shard_resume(int shard_id, const nlohmann::json& resume_data) {
-    auto& info = shard_info_[shard_id];
+void ShardManager::handle_shard_resume(ShardSet& set, int shard_id) {
+    ShardState* state = set.states.get(shard_id);
     
-    info.is_resumable = true;
+    state->is_resumable = true;
+    state->is_connected = true;
+    state->handshakes.fetch_add(1, std::memory_order_release);
     
     LOG_INFO("Shard " + std::to_string(shard_id) + " resumed successfully");
 }
 
+void ShardManager::notify_shard_state(const ShardSet& set, int shard_id, bool connected) {
+    if (shard_state_callback_ && set.role.load(std::memory_order_acquire) != ShardSet::Role::PENDING) {
+        shard_state_callback_(shard_id, connected);
+    }
+}
 GatewaySession ShardManager::get_gateway_info() {
     try {
         auto response = APIEndpoints::get_gateway_bot();
@@ -495,6 +1002,7 @@ GatewaySession ShardManager::get_gateway_info() {
             session.session_start_limit_total = limit.value("total", 1000);
             session.session_start_limit_remaining = limit.value("remaining", 1000);
             session.session_start_limit_reset_after = limit.value("reset_after", 0);
+            session.max_concurrency = limit.value("max_concurrency", 1);
             session.last_reset = std::chrono::steady_clock::now();
         }
         
@@ -524,19 +1032,9 @@ int ShardManager::calculate_shard_count() {
     return 1;
 }
 
-bool ShardManager::can_start_session() {
-    update_session_limits();
-    return session_info_.can_start_session();
-}
-
-void ShardManager::wait_for_session_slot() {
-    while (!can_start_session() && !is_shutting_down_.load()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-        update_session_limits();
-    }
-}
-
 void ShardManager::update_session_limits() {
+    // Connect threads of several sets and reconnect jobs get here concurrently
+    std::lock_guard<std::mutex> lock(mutex_);
     auto now = std::chrono::steady_clock::now();
     auto time_since_reset = std::chrono::duration_cast<std::chrono::milliseconds>(
         now - session_info_.last_reset);
@@ -546,26 +1044,15 @@ void ShardManager::update_session_limits() {
         session_info_.session_start_limit_remaining = session_info_.session_start_limit_total;
         session_info_.last_reset = now;
         sessions_started_recently_ = 0;
-        last_session_reset_ = now;
-    }
-}
-
-int ShardManager::get_shard_for_guild(const std::string& guild_id) {
-    if (config_.shard_count <= 1) {
-        return 0;
-    }
-    
-    try {
-        uint64_t guild_id_num = std::stoull(guild_id);
-        return static_cast<int>((guild_id_num >> 22) % config_.shard_count);
-    } catch (const std::exception&) {
-        return 0;
     }
 }
 
 bool ShardManager::validate_config() const {
     return config_.shard_count > 0 && 
            config_.max_concurrency > 0 &&
+           config_.cluster_count > 0 &&
+           config_.cluster_id >= 0 && config_.cluster_id < config_.cluster_count &&
+           config_.cluster_count <= config_.shard_count &&
            !bot_token_.empty();
 }
 
@@ -584,41 +1071,366 @@ std::string ShardManager::get_gateway_url() const {
     return url;
 }
 
-void ShardManager::identify_shard(int shard_id) {
-    auto& shard = shards_[shard_id];
-    auto& info = shard_info_[shard_id];
-    
-    nlohmann::json identify;
-    identify["op"] = 2;
-    identify["d"] = nlohmann::json{
-        {"token", bot_token_},
-        {"intents", 0}, // Will be set by caller
-        {"properties", nlohmann::json{
-            {"os", "linux"},
-            {"browser", "discord.cpp"},
-            {"device", "discord.cpp"}
-        }},
-        {"shard", nlohmann::json::array({shard_id, config_.shard_count})}
-    };
+void ShardManager::create_identify_scheduler() {
+    // Discord's max_concurrency is authoritative; the config value is the fallback
+    int concurrency = session_info_.max_concurrency > 1 ? session_info_.max_concurrency : config_.max_concurrency;
+    
+    identifies_released_ = 0;
+    identify_scheduler_ = std::make_unique<IdentifyScheduler>(concurrency);
+    identify_scheduler_->set_persistence_path(config_.session_limit_path);
+    if (cluster_) {
+        // Buckets are shared by every process of the bot
+        identify_scheduler_->set_bucket_gate([this](int bucket) {
+            return cluster_->try_acquire_identify(bucket);
+        });
+    }
+    identify_scheduler_->set_session_start_limit(
+        session_info_.session_start_limit_total,
+        session_info_.session_start_limit_remaining,
+        std::chrono::milliseconds(session_info_.session_start_limit_reset_after));
+}
+
+void ShardManager::update_shard_range() {
+    if (!config_.is_clustered()) {
+        cluster_.reset();
+        shard_range_ = ShardRange{0, config_.shard_count - 1};
+        return;
+    }
+    
+    if (!cluster_ || cluster_->get_cluster_id() != config_.cluster_id ||
+        cluster_->get_cluster_count() != config_.cluster_count) {
+        ClusterConfig cluster_config;
+        cluster_config.cluster_id = config_.cluster_id;
+        cluster_config.cluster_count = config_.cluster_count;
+        cluster_config.lock_directory = config_.cluster_lock_directory;
+        cluster_ = std::make_unique<ClusterCoordinator>(cluster_config);
+    }
+    
+    shard_range_ = cluster_->get_range(config_.shard_count);
+}
+
+ShardRange ShardManager::get_range_for(int shard_count) const {
+    if (!cluster_) {
+        return ShardRange{0, shard_count - 1};
+    }
+    return cluster_->get_range(shard_count);
+}
+
+void ShardManager::start_event_loops() {
+    if (config_.shard_groups <= 0) {
+        // All shards share one event loop driven by a small thread pool
+        io_pool_ = std::make_shared<IoContextPool>(config_.io_threads);
+        io_pool_->start();
+        return;
+    }
+    
+    // One single-threaded loop per group: no handler of a group ever runs elsewhere
+    int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    group_pools_.reserve(config_.shard_groups);
+    
+    for (int group = 0; group < config_.shard_groups; ++group) {
+        auto pool = std::make_shared<IoContextPool>(1);
+        if (config_.pin_shard_groups) {
+            pool->set_cpu_affinity(group % cores);
+        }
+        pool->start();
+        group_pools_.push_back(std::move(pool));
+    }
+    
+    LOG_INFO("Running shards on " + std::to_string(config_.shard_groups) + " shard group threads" +
+             (config_.pin_shard_groups ? " pinned to CPUs" : ""));
+}
+
+void ShardManager::stop_event_loops() {
+    // Stopping joins the loop threads, whose handlers may take mutex_
+    std::shared_ptr<IoContextPool> io_pool;
+    std::vector<std::shared_ptr<IoContextPool>> group_pools;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        io_pool = std::move(io_pool_);
+        group_pools.swap(group_pools_);
+    }
+    
+    if (io_pool) {
+        io_pool->stop();
+    }
     
-    shard->send(identify);
-    LOG_DEBUG("Sent IDENTIFY for shard " + std::to_string(shard_id));
+    for (auto& pool : group_pools) {
+        pool->stop();
+    }
+}
+
+std::shared_ptr<IoContextPool> ShardManager::get_event_loop(int shard_id) const {
+    if (group_pools_.empty()) {
+        return io_pool_;
+    }
+    return group_pools_[get_shard_group(shard_id)];
+}
+
+void ShardManager::identify_shard(WebSocketClient& client, int shard_id) {
+    // The client adds the [shard_id, shard_count] pair and waits for HELLO
+    client.identify();
+    LOG_DEBUG("Queued IDENTIFY for shard " + std::to_string(shard_id));
+}
+
+void ShardManager::resume_shard(WebSocketClient& client, int shard_id) {
+    client.resume();
+    LOG_DEBUG("Queued RESUME for shard " + std::to_string(shard_id));
+}
+
+bool ShardManager::restart_shard(ShardSet& set, int shard_id, bool resume) {
+    WebSocketClient* client = set.get_client(shard_id);
+    if (!client) {
+        return false;
+    }
+    
+    ShardState* state = set.states.get(shard_id);
+    bool can_resume = resume && state->is_resumable.load() && !client->get_session_id().empty();
+    
+    if (!can_resume) {
+        // Force identify
+        state->clear_session();
+    }
+    
+    // reconnect() closes with a non-1000 code, so Discord keeps the session
+    bool started = client->reconnect(can_resume);
+    state->record_connect(started);
+    if (!started) {
+        LOG_ERROR("Failed to reconnect shard " + std::to_string(shard_id));
+    }
+    
+    return can_resume;
 }
 
-void ShardManager::resume_shard(int shard_id, const nlohmann::json& resume_data) {
-    auto& shard = shards_[shard_id];
-    auto& info = shard_info_[shard_id];
+void ShardManager::run_reconnect_job(std::shared_ptr<ShardSet> set, uint64_t job,
+                                     std::vector<int> resumes, std::vector<int> identifies) {
+    // IDENTIFYs wait in their rate limit bucket inside the scheduler, not here
+    for (int shard_id : identifies) {
+        if (is_reconnect_cancelled(job)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        restart_shard(*set, shard_id, false);
+    }
     
-    nlohmann::json resume;
-    resume["op"] = 6;
-    resume["d"] = nlohmann::json{
-        {"token", bot_token_},
-        {"session_id", info.session_id},
-        {"seq", info.sequence_number}
+    // RESUMEs are not rate limited; bound how many handshakes are in flight
+    constexpr auto resume_timeout = std::chrono::seconds(15);
+    std::atomic<size_t> next{0};
+    
+    auto worker = [&]() {
+        for (size_t index = next++; index < resumes.size(); index = next++) {
+            if (is_reconnect_cancelled(job)) {
+                return;
+            }
+            
+            int shard_id = resumes[index];
+            ShardState* state = set->states.get(shard_id);
+            uint32_t handshakes = state->handshakes.load(std::memory_order_acquire);
+            
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                restart_shard(*set, shard_id, true);
+            }
+            
+            // A failed resume falls back to IDENTIFY, which also ends the wait
+            auto deadline = std::chrono::steady_clock::now() + resume_timeout;
+            while (state->handshakes.load(std::memory_order_acquire) == handshakes &&
+                   std::chrono::steady_clock::now() < deadline &&
+                   !is_reconnect_cancelled(job)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+        }
     };
     
-    shard->send(resume);
-    LOG_DEBUG("Sent RESUME for shard " + std::to_string(shard_id));
+    size_t worker_count = std::min(resumes.size(), static_cast<size_t>(std::max(1, config_.reconnect_concurrency)));
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+    for (size_t i = 1; i < worker_count; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+void ShardManager::open_session_store(ShardSet& set) {
+    if (config_.session_store_path.empty()) {
+        session_store_.reset();
+        return;
+    }
+    
+    if (!session_store_) {
+        session_store_ = std::make_unique<SessionStore>(config_.session_store_path);
+    }
+    
+    if (!session_store_->open(set.range.first, set.range.size(), set.shard_count)) {
+        session_store_.reset();
+        return;
+    }
+    
+    // Sessions still held in memory (stop()/start()) are newer than the file
+    int restored = 0;
+    for (int shard_id = set.range.first; shard_id <= set.range.last; ++shard_id) {
+        ShardState* state = set.states.get(shard_id);
+        if (state->is_resumable.load(std::memory_order_acquire)) {
+            continue;
+        }
+        
+        auto session = session_store_->load(shard_id);
+        if (session) {
+            state->sequence_number.store(session->sequence_number, std::memory_order_relaxed);
+            state->set_session(session->session_id, session->resume_gateway_url);
+            restored++;
+        }
+    }
+    
+    if (restored > 0) {
+        LOG_INFO("Restored " + std::to_string(restored) + " shard sessions from " + config_.session_store_path);
+    }
+}
+
+void ShardManager::persist_sessions() {
+    if (!session_store_) {
+        return;
+    }
+    
+    auto set = active_set();
+    for (int shard_id = set->range.first; shard_id <= set->range.last; ++shard_id) {
+        ShardInfo info = set->states.snapshot(shard_id);
+        if (info.is_resumable && !info.session_id.empty()) {
+            session_store_->save(shard_id, info.session_id, info.sequence_number, info.resume_gateway_url);
+        } else {
+            session_store_->clear(shard_id);
+        }
+    }
+}
+
+void ShardManager::persist_sequences() {
+    if (!session_store_) {
+        return;
+    }
+    
+    auto set = active_set();
+    for (int shard_id = set->range.first; shard_id <= set->range.last; ++shard_id) {
+        ShardState* state = set->states.get(shard_id);
+        if (state->is_resumable.load(std::memory_order_acquire)) {
+            session_store_->save_sequence(shard_id, state->sequence_number.load(std::memory_order_relaxed));
+        }
+    }
+}
+
+bool ShardManager::is_reconnect_cancelled(uint64_t job) const {
+    return is_shutting_down_.load() || reconnect_job_.load() != job;
+}
+
+void ShardManager::start_health_monitor() {
+    if (config_.health_check_interval.count() <= 0 || health_thread_.joinable()) {
+        return;
+    }
+    
+    health_thread_ = std::thread(&ShardManager::run_health_monitor, this);
+}
+
+void ShardManager::stop_health_monitor() {
+    {
+        // is_shutting_down_ is already set; the lock orders it before the wakeup
+        std::lock_guard<std::mutex> lock(health_mutex_);
+    }
+    health_cv_.notify_all();
+    
+    if (health_thread_.joinable()) {
+        health_thread_.join();
+    }
+}
+
+void ShardManager::run_health_monitor() {
+    std::unordered_map<int, uint64_t> last_counts;
+    uint64_t generation = active_set()->generation;
+    auto last_check = std::chrono::steady_clock::now();
+    
+    std::unique_lock<std::mutex> lock(health_mutex_);
+    while (!health_cv_.wait_for(lock, config_.health_check_interval, [this]() { return is_shutting_down_.load(); })) {
+        lock.unlock();
+        
+        // Counters restart with a new shard set
+        uint64_t current_generation = active_set()->generation;
+        if (current_generation != generation) {
+            last_counts.clear();
+            generation = current_generation;
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        try {
+            check_shard_health(now - last_check, last_counts);
+            persist_sequences();
+            member_chunker_->expire();
+        } catch (const std::exception& e) {
+            LOG_ERROR("Shard health check failed: " + std::string(e.what()));
+        }
+        last_check = now;
+        
+        lock.lock();
+    }
+}
+
+void ShardManager::check_shard_health(std::chrono::steady_clock::duration elapsed,
+                                      std::unordered_map<int, uint64_t>& last_counts) {
+    auto set = active_set();
+    std::unordered_map<int, std::chrono::milliseconds> intervals;
+    
+    // Heartbeat stats live in the clients; copy them into the lock-free state
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int shard_id = set->range.first; shard_id <= set->range.last; ++shard_id) {
+            WebSocketClient* client = set->get_client(shard_id);
+            if (!client) {
+                continue;
+            }
+            
+            HeartbeatStats heartbeat = client->get_heartbeat_stats();
+            ShardState* state = set->states.get(shard_id);
+            state->heartbeat_latency_ms.store(heartbeat.latency.count(), std::memory_order_relaxed);
+            state->missed_acks.store(heartbeat.missed_acks, std::memory_order_relaxed);
+            intervals.emplace(shard_id, heartbeat.interval);
+        }
+    }
+    
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    std::vector<std::pair<int, std::chrono::milliseconds>> zombies;
+    
+    for (const auto& [shard_id, interval] : intervals) {
+        ShardState* state = set->states.get(shard_id);
+        
+        uint64_t events = state->events_received.load(std::memory_order_relaxed);
+        auto last = last_counts.find(shard_id);
+        if (last != last_counts.end() && seconds > 0 && events >= last->second) {
+            state->events_per_second.store(static_cast<double>(events - last->second) / seconds,
+                                           std::memory_order_relaxed);
+        }
+        last_counts[shard_id] = events;
+        
+        // Every frame counts, HEARTBEAT_ACKs included: silence means the socket is dead
+        auto timeout = config_.zombie_timeout.count() > 0 ? config_.zombie_timeout : interval * 3 / 2;
+        if (timeout.count() <= 0 || !state->is_connected.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        
+        ShardHealth health = set->states.health(shard_id);
+        if (health.silence > timeout) {
+            zombies.emplace_back(shard_id, health.silence);
+        }
+    }
+    
+    for (const auto& [shard_id, silence] : zombies) {
+        LOG_WARN("Shard " + std::to_string(shard_id) + " silent for " + std::to_string(silence.count()) +
+                 "ms, resuming on a new connection");
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        set->states.get(shard_id)->zombie_restarts.fetch_add(1, std::memory_order_relaxed);
+        restart_shard(*set, shard_id, true);
+    }
 }
 
 // ShardFactory implementation
@@ -627,7 +1439,7 @@ ShardConfig ShardFactory::create_small_bot_config() {
     ShardConfig config;
     config.shard_count = 1;
     config.max_concurrency = 1;
-    config.connection_delay = std::chrono::milliseconds(5000);
+    config.io_threads = 1;
     return config;
 }
 
@@ -635,7 +1447,6 @@ ShardConfig ShardFactory::create_medium_bot_config() {
     ShardConfig config;
     config.shard_count = 4;
     config.max_concurrency = 2;
-    config.connection_delay = std::chrono::milliseconds(2500);
     return config;
 }
 
@@ -643,7 +1454,7 @@ ShardConfig ShardFactory::create_large_bot_config() {
     ShardConfig config;
     config.shard_count = 16;
     config.max_concurrency = 4;
-    config.connection_delay = std::chrono::milliseconds(1000);
+    config.io_threads = std::thread::hardware_concurrency();
     return config;
 }
 
@@ -659,7 +1470,6 @@ ShardConfig ShardFactory::create_config_for_guild_count(int guild_count) {
     ShardConfig config;
     config.shard_count = shard_count;
     config.max_concurrency = std::min(4, shard_count);
-    config.connection_delay = std::chrono::milliseconds(std::max(500, 5000 / shard_count));
     
     return config;
 }
@@ -0,0 +1,57 @@
+#include <discord/gateway/shard_set.h>
+#include <string>
+
+namespace discord {
+
+EventDeduplicator::EventDeduplicator(std::chrono::milliseconds window) : window_(window) {}
+
+bool EventDeduplicator::check(const nlohmann::json& event) {
+    std::string key = fingerprint(event);
+    auto now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    expire(now);
+
+    auto [it, inserted] = seen_.insert(std::move(key));
+    if (!inserted) {
+        return false;
+    }
+
+    order_.emplace_back(now, &*it);
+    return true;
+}
+
+void EventDeduplicator::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    seen_.clear();
+    order_.clear();
+}
+
+size_t EventDeduplicator::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return seen_.size();
+}
+
+std::string EventDeduplicator::fingerprint(const nlohmann::json& event) {
+    // The sequence number differs between sets; type and data do not
+    std::string key = event.value("t", "");
+    key += '\n';
+
+    auto data = event.find("d");
+    if (data != event.end()) {
+        key += data->dump();
+    }
+
+    return key;
+}
+
+// Private methods
+
+void EventDeduplicator::expire(Clock::time_point now) {
+    while (!order_.empty() && now - order_.front().first > window_) {
+        seen_.erase(seen_.find(*order_.front().second));
+        order_.pop_front();
+    }
+}
+
+} // namespace discord
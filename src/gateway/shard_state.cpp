@@ -0,0 +1,127 @@
+#include <discord/gateway/shard_state.h>
+#include <algorithm>
+
+namespace discord {
+
+void ShardState::set_session(const std::string& id, const std::string& url) {
+    {
+        std::lock_guard<std::mutex> lock(session_mutex);
+        session_id = id;
+        resume_gateway_url = url;
+    }
+    is_resumable.store(!id.empty(), std::memory_order_release);
+}
+
+void ShardState::clear_session() {
+    {
+        std::lock_guard<std::mutex> lock(session_mutex);
+        session_id.clear();
+        resume_gateway_url.clear();
+    }
+    is_resumable.store(false, std::memory_order_release);
+    sequence_number.store(-1, std::memory_order_relaxed);
+    guilds_pending.store(-1, std::memory_order_relaxed);
+}
+
+void ShardState::record_connect(bool success) {
+    if (success) {
+        connect_time.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        reconnect_attempts.store(0, std::memory_order_relaxed);
+    } else {
+        is_connected.store(false, std::memory_order_relaxed);
+        reconnect_attempts.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ShardStateTable::reset(int first_shard, int size, int shard_count) {
+    states_ = std::make_unique<ShardState[]>(static_cast<size_t>(size));
+    first_shard_ = first_shard;
+    size_ = size;
+    shard_count_ = shard_count;
+}
+
+ShardInfo ShardStateTable::snapshot(int shard_id) const {
+    ShardInfo info(shard_id, shard_count_);
+
+    const ShardState* state = get(shard_id);
+    if (!state) {
+        return info;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state->session_mutex);
+        info.session_id = state->session_id;
+        info.resume_gateway_url = state->resume_gateway_url;
+    }
+
+    info.sequence_number = state->sequence_number.load(std::memory_order_relaxed);
+    info.is_connected = state->is_connected.load(std::memory_order_relaxed);
+    info.is_resumable = state->is_resumable.load(std::memory_order_acquire);
+    info.reconnect_attempts = state->reconnect_attempts.load(std::memory_order_relaxed);
+    info.events_received = state->events_received.load(std::memory_order_relaxed);
+    info.connect_time = ShardState::Clock::time_point(
+        ShardState::Clock::duration(state->connect_time.load(std::memory_order_relaxed)));
+    info.last_heartbeat = ShardState::Clock::time_point(
+        ShardState::Clock::duration(state->last_event.load(std::memory_order_relaxed)));
+    return info;
+}
+
+ShardHealth ShardStateTable::health(int shard_id) const {
+    ShardHealth health;
+    health.shard_id = shard_id;
+
+    const ShardState* state = get(shard_id);
+    if (!state) {
+        return health;
+    }
+
+    auto now = ShardState::Clock::now();
+    ShardState::Clock::time_point last_event(ShardState::Clock::duration(state->last_event.load(std::memory_order_relaxed)));
+    ShardState::Clock::time_point connected_at(ShardState::Clock::duration(state->connect_time.load(std::memory_order_relaxed)));
+
+    health.is_connected = state->is_connected.load(std::memory_order_relaxed);
+    health.is_resumable = state->is_resumable.load(std::memory_order_relaxed);
+    health.sequence_number = state->sequence_number.load(std::memory_order_relaxed);
+    health.events_received = state->events_received.load(std::memory_order_relaxed);
+    health.events_per_second = state->events_per_second.load(std::memory_order_relaxed);
+    health.heartbeat_latency = std::chrono::milliseconds(state->heartbeat_latency_ms.load(std::memory_order_relaxed));
+    health.missed_acks = state->missed_acks.load(std::memory_order_relaxed);
+    health.sequence_gaps = state->sequence_gaps.load(std::memory_order_relaxed);
+    health.zombie_restarts = state->zombie_restarts.load(std::memory_order_relaxed);
+    health.reconnect_attempts = state->reconnect_attempts.load(std::memory_order_relaxed);
+    health.silence = std::chrono::duration_cast<std::chrono::milliseconds>(now - std::max(last_event, connected_at));
+    health.uptime = std::chrono::duration_cast<std::chrono::seconds>(now - connected_at);
+    return health;
+}
+
+int ShardStateTable::count_connected() const {
+    int count = 0;
+    for (int i = 0; i < size_; ++i) {
+        if (states_[i].is_connected.load(std::memory_order_relaxed)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int ShardStateTable::count_resumable() const {
+    int count = 0;
+    for (int i = 0; i < size_; ++i) {
+        if (states_[i].is_resumable.load(std::memory_order_relaxed)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int ShardStateTable::count_warm() const {
+    int count = 0;
+    for (int i = 0; i < size_; ++i) {
+        if (states_[i].is_warm()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+} // namespace discord
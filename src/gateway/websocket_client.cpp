@@ -1,25 +1,99 @@
 #include <discord/gateway/websocket_client.h>
+#include <discord/gateway/message_pool.h>
 #include <discord/utils/logger.h>
 #include <websocketpp/config/asio_client.hpp>
 #include <websocketpp/client.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
 #include <zlib.h>
 #include <iostream>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string_view>
 #include <vector>
 #include <cstring>
 
 namespace discord {
 
-using websocket_client = websocketpp::client<websocketpp::config::asio_tls_client>;
+using websocket_client = websocketpp::client<PooledTlsClientConfig>;
+
+namespace {
+
+/**
+ * @brief Tracks handlers of a client that may still run on a shared event loop
+ *
+ * Strand posts, timers, connection and heartbeat callbacks capture the
+ * client, and on a shared IoContextPool they can run after it is gone.
+ * Each one enters the lifetime first; once the client is destroyed they
+ * do nothing, and the destructor waits for those already running.
+ */
+struct HandlerLifetime {
+    std::mutex mutex;
+    std::condition_variable idle;
+    size_t running = 0;
+    bool alive = true;
+};
+
+// Lifetime of the handler running on this thread, if any
+thread_local const HandlerLifetime* current_lifetime = nullptr;
+
+class HandlerScope {
+private:
+    HandlerLifetime& lifetime_;
+    const HandlerLifetime* previous_;
+    bool entered_;
+
+public:
+    explicit HandlerScope(HandlerLifetime& lifetime) : lifetime_(lifetime), previous_(current_lifetime) {
+        std::lock_guard<std::mutex> lock(lifetime_.mutex);
+        entered_ = lifetime_.alive;
+        if (entered_) {
+            lifetime_.running++;
+            current_lifetime = &lifetime_;
+        }
+    }
+
+    ~HandlerScope() {
+        if (!entered_) {
+            return;
+        }
+        current_lifetime = previous_;
+        std::lock_guard<std::mutex> lock(lifetime_.mutex);
+        lifetime_.running--;
+        lifetime_.idle.notify_all();
+    }
+
+    HandlerScope(const HandlerScope&) = delete;
+    HandlerScope& operator=(const HandlerScope&) = delete;
+
+    explicit operator bool() const { return entered_; }
+};
+
+} // namespace
 
 class WebSocketClient::Impl {
 public:
-    Impl() : is_connected_(false), compression_enabled_(false), 
-              zlib_stream_(), reconnect_manager_(std::make_unique<ReconnectionManager>()) {
+    enum class PendingHandshake { NONE, IDENTIFY, RESUME };
+    
+    explicit Impl(std::shared_ptr<IoContextPool> io_pool = nullptr)
+        : io_pool_(std::move(io_pool)), is_connected_(false), compression_enabled_(false), 
+          zlib_stream_(), reconnect_manager_(std::make_unique<ReconnectionManager>()) {
         client_.set_access_channels(websocketpp::log::alevel::none);
         client_.clear_access_channels(websocketpp::log::alevel::all);
         client_.set_error_channels(websocketpp::log::elevel::none);
         
-        client_.init_asio();
+        if (io_pool_) {
+            // Shared event loop: the pool's threads drive this connection
+            client_.init_asio(&io_pool_->get_io_context());
+        } else {
+            client_.init_asio();
+        }
+        
+        // Outbound sends are drained by a single consumer on this strand
+        send_strand_ = std::make_unique<SendStrand>(boost::asio::make_strand(client_.get_io_service()));
+        send_timer_ = std::make_unique<boost::asio::steady_timer>(*send_strand_);
         
         client_.set_tls_init_handler([](websocketpp::connection_hdl) {
             auto ctx = std::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tlsv12);
@@ -27,17 +101,28 @@ public:
             return ctx;
         });
         
-        client_.set_open_handler([this](websocketpp::connection_hdl hdl) {
+        client_.set_open_handler(guarded([this](websocketpp::connection_hdl hdl) {
+            if (!is_current_connection(hdl)) {
+                return;
+            }
+            send_limiter_.reset();
             is_connected_ = true;
-            connection_hdl_ = hdl;
             reconnect_manager_->handle_connection_restored();
             LOG_INFO("WebSocket connection established");
-        });
+        }));
         
-        client_.set_close_handler([this](websocketpp::connection_hdl hdl) {
+        client_.set_close_handler(guarded([this](websocketpp::connection_hdl hdl) {
+            // A connection replaced by reconnect() must not tear down its successor
+            if (!is_current_connection(hdl)) {
+                return;
+            }
+            
             is_connected_ = false;
+            hello_received_ = false;
+            stop_heartbeat();
+            discard_pending_sends();
             auto con = client_.get_con_from_hdl(hdl);
-            auto close_code = con->get_remote_close_reason();
+            int close_code = con->get_remote_close_code();
             auto reason = con->get_remote_close_reason();
             
             LOG_WARN("WebSocket connection closed: " + std::to_string(close_code) + " " + reason);
@@ -47,36 +132,84 @@ public:
             }
             
             // Handle reconnection
-            reconnect_manager_->handle_disconnect(close_code, reason);
-        });
+            if (!closing_) {
+                reconnect_manager_->handle_disconnect(close_code, reason);
+            }
+        }));
         
-        client_.set_message_handler([this](websocketpp::connection_hdl hdl, websocket_client::message_ptr msg) {
+        client_.set_fail_handler(guarded([this](websocketpp::connection_hdl hdl) {
+            if (!is_current_connection(hdl)) {
+                return;
+            }
+            
+            is_connected_ = false;
+            auto con = client_.get_con_from_hdl(hdl);
+            LOG_ERROR("WebSocket connection failed: " + con->get_ec().message());
+            
+            if (!closing_) {
+                reconnect_manager_->handle_disconnect(websocketpp::close::status::abnormal_close, con->get_ec().message());
+            }
+        }));
+        
+        client_.set_message_handler(guarded([this](websocketpp::connection_hdl hdl, websocket_client::message_ptr msg) {
+            // Frames still arriving on a replaced connection belong to a dead session,
+            // and its inflate state now belongs to the new connection
+            if (!is_current_connection(hdl)) {
+                return;
+            }
+            
             try {
-                std::string payload_str;
+                // Parse straight out of the frame buffer (or the inflate buffer), no copies
+                std::string_view payload_view = msg->get_payload();
                 
                 // Check if message is compressed (binary messages)
                 if (msg->get_opcode() == websocketpp::frame::opcode::binary) {
-                    payload_str = decompress_message(msg->get_payload());
-                } else {
-                    payload_str = msg->get_payload();
+                    if (!decompress_message(payload_view, payload_view)) {
+                        return;
+                    }
+                }
+                
+                // A dispatch the frame consumer takes is never built into a JSON document
+                if (frame_callback_) {
+                    FrameHeader header = peek_frame_header(payload_view);
+                    if (header.opcode == static_cast<int>(GatewayOpcode::DISPATCH) &&
+                        header.type != EventType::UNKNOWN && header.type != EventType::READY &&
+                        header.type != EventType::RESUMED && frame_callback_(payload_view, header)) {
+                        if (header.sequence >= 0) {
+                            last_sequence_ = header.sequence;
+                        }
+                        return;
+                    }
                 }
                 
-                auto payload = nlohmann::json::parse(payload_str);
+                auto payload = nlohmann::json::parse(payload_view.data(), payload_view.data() + payload_view.size());
                 
                 // Handle gateway events that affect reconnection
                 if (payload.contains("op")) {
                     int opcode = payload["op"];
-                    if (opcode == static_cast<int>(GatewayOpcode::HELLO)) {
+                    if (opcode == static_cast<int>(GatewayOpcode::DISPATCH)) {
+                        track_session(payload);
+                    } else if (opcode == static_cast<int>(GatewayOpcode::HELLO)) {
                         // Start heartbeat
                         if (payload.contains("d") && payload["d"].contains("heartbeat_interval")) {
                             int interval = payload["d"]["heartbeat_interval"];
                             start_heartbeat(interval);
                         }
+                        hello_received_ = true;
+                        perform_pending_handshake();
+                    } else if (opcode == static_cast<int>(GatewayOpcode::HEARTBEAT_ACK)) {
+                        HeartbeatScheduler::instance().acknowledge(heartbeat_id_.load());
+                    } else if (opcode == static_cast<int>(GatewayOpcode::HEARTBEAT)) {
+                        // Discord may request an immediate heartbeat
+                        HeartbeatScheduler::instance().beat_now(heartbeat_id_.load());
                     } else if (opcode == static_cast<int>(GatewayOpcode::INVALID_SESSION)) {
                         bool can_resume = payload.value("d", false);
                         reconnect_manager_->handle_invalid_session(can_resume);
                     } else if (opcode == static_cast<int>(GatewayOpcode::RECONNECT)) {
-                        reconnect_manager_->handle_disconnect(1000, "Reconnect requested by Discord");
+                        // Close with a non-1000 code so the session stays resumable;
+                        // the close handler hands off to the reconnection manager
+                        websocketpp::lib::error_code ec;
+                        client_.close(hdl, websocketpp::close::status::service_restart, "Reconnect requested by Discord", ec);
                     }
                 }
                 
@@ -86,53 +219,111 @@ public:
             } catch (const std::exception& e) {
                 LOG_ERROR("Failed to parse WebSocket message: " + std::string(e.what()));
             }
-        });
+        }));
         
-        // Setup reconnection callbacks
+        // Setup reconnection callbacks; reconnect() performs the handshake itself
         reconnect_manager_->set_callbacks(
             [this](bool should_resume) {
-                if (should_resume) {
-                    resume();
-                } else {
-                    identify();
-                }
+                reconnect(should_resume);
             },
-            [this]() {
-                resume();
-            }
+            nullptr
         );
     }
     
-    bool connect(const std::string& url) {
-        try {
+    ~Impl() {
+        closing_ = true;
+        reconnect_manager_->stop_reconnecting();
+        stop_heartbeat();
+        
+        if (is_connected_) {
             websocketpp::lib::error_code ec;
-            websocket_client::connection_ptr con = client_.get_connection(url, ec);
-            
-            if (ec) {
-                return false;
+            client_.close(current_connection(), websocketpp::close::status::normal, "", ec);
+            is_connected_ = false;
+        }
+        
+        // Queued handlers become no-ops; wait for the ones already running,
+        // except the one this destructor may have been called from
+        {
+            std::unique_lock<std::mutex> lock(lifetime_->mutex);
+            lifetime_->alive = false;
+            size_t own = current_lifetime == lifetime_.get() ? 1 : 0;
+            lifetime_->idle.wait(lock, [this, own] { return lifetime_->running <= own; });
+        }
+        
+        if (!io_pool_) {
+            client_.stop();
+            if (thread_.joinable()) {
+                if (thread_.get_id() == std::this_thread::get_id()) {
+                    thread_.detach();
+                } else {
+                    thread_.join();
+                }
             }
+        }
+    }
+    
+    bool connect(const std::string& url, bool resume) {
+        std::string target;
+        {
+            std::lock_guard<std::mutex> lock(session_mutex_);
+            gateway_url_ = url;
+            target = url;
             
-            client_.connect(con);
+            if (resume && !session_id_.empty()) {
+                target = build_resume_url();
+                pending_handshake_ = PendingHandshake::RESUME;
+            }
+        }
+        
+        return open_connection(target);
+    }
+    
+    bool reconnect(bool resume) {
+        std::string target;
+        {
+            std::lock_guard<std::mutex> lock(session_mutex_);
             
-            thread_ = std::thread([this]() {
-                try {
-                    client_.run();
-                } catch (const std::exception& e) {
-                    is_connected_ = false;
-                }
-            });
+            if (!resume) {
+                session_id_.clear();
+                resume_gateway_url_.clear();
+                last_sequence_ = -1;
+            }
             
-            return true;
-        } catch (const std::exception& e) {
+            if (!session_id_.empty()) {
+                target = build_resume_url();
+                pending_handshake_ = PendingHandshake::RESUME;
+            } else {
+                target = gateway_url_;
+                pending_handshake_ = PendingHandshake::IDENTIFY;
+            }
+        }
+        
+        if (target.empty()) {
+            LOG_ERROR("Cannot reconnect before an initial connect()");
             return false;
         }
+        
+        LOG_INFO(std::string(resume ? "Resuming" : "Re-identifying") + " on " + target);
+        
+        // Any code other than 1000/1001 keeps the session alive on Discord's side
+        closing_ = true;
+        stop_heartbeat();
+        websocketpp::lib::error_code ec;
+        client_.close(current_connection(), websocketpp::close::status::service_restart, "Reconnecting", ec);
+        is_connected_ = false;
+        
+        return open_connection(target);
     }
     
-    void disconnect() {
+    void disconnect(bool keep_session) {
+        closing_ = true;
+        stop_heartbeat();
         if (is_connected_) {
-            client_.close(connection_hdl_, websocketpp::close::status::normal, "");
+            websocketpp::lib::error_code ec;
+            auto code = keep_session ? websocketpp::close::status::service_restart : websocketpp::close::status::normal;
+            client_.close(current_connection(), code, "", ec);
         }
-        if (thread_.joinable()) {
+        if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
             thread_.join();
         }
     }
@@ -142,19 +333,95 @@ public:
     }
     
     void send(const nlohmann::json& payload) {
-        if (is_connected_) {
-            try {
-                client_.send(connection_hdl_, payload.dump(), websocketpp::frame::opcode::text);
-            } catch (const std::exception& e) {
-                // Silent error handling
+        // Serialize on the caller's thread, never on the I/O thread
+        int opcode = payload.value("op", -1);
+        bool priority = opcode == static_cast<int>(GatewayOpcode::HEARTBEAT) ||
+                        opcode == static_cast<int>(GatewayOpcode::IDENTIFY) ||
+                        opcode == static_cast<int>(GatewayOpcode::RESUME);
+        send_serialized(payload.dump(), priority);
+    }
+    
+    void send_serialized(std::string payload, bool priority) {
+        if (!is_connected_) {
+            LOG_DEBUG("Dropping gateway payload, connection is not open");
+            return;
+        }
+        
+        if (priority) {
+            priority_sends_.push(std::move(payload));
+        } else {
+            pending_sends_.push(std::move(payload));
+        }
+        
+        if (!drain_scheduled_.exchange(true)) {
+            boost::asio::post(*send_strand_, guarded([this]() { drain_send_queue(); }));
+        } else if (priority) {
+            // Wake a drain that is waiting for the regular window to reopen
+            boost::asio::post(*send_strand_, guarded([this]() { send_timer_->cancel(); }));
+        }
+    }
+    
+    size_t get_pending_send_count() const {
+        return priority_sends_.size() + pending_sends_.size();
+    }
+    
+    void drain_send_queue() {
+        while (true) {
+            while (!priority_sends_.empty() || !pending_sends_.empty()) {
+                bool priority = !priority_sends_.empty();
+                
+                if (!send_limiter_.try_acquire(priority)) {
+                    // Keep drain_scheduled_ set; the timer resumes draining
+                    send_timer_->expires_after(send_limiter_.time_until_available(priority));
+                    send_timer_->async_wait(guarded([this](const boost::system::error_code&) {
+                        drain_send_queue();
+                    }));
+                    return;
+                }
+                
+                std::string payload;
+                (priority ? priority_sends_ : pending_sends_).try_pop(payload);
+                
+                websocketpp::lib::error_code ec;
+                client_.send(current_connection(), payload, websocketpp::frame::opcode::text, ec);
+                if (ec) {
+                    LOG_ERROR("Failed to send gateway payload: " + ec.message());
+                }
+            }
+            
+            drain_scheduled_ = false;
+            
+            // A producer may have pushed after the queues were seen empty
+            bool has_more = !priority_sends_.empty() || !pending_sends_.empty();
+            if (!has_more || drain_scheduled_.exchange(true)) {
+                return;
             }
         }
     }
     
+    void discard_pending_sends() {
+        boost::asio::post(*send_strand_, guarded([this]() {
+            // Commands queued for a closed connection must not leak into the next one
+            send_timer_->cancel();
+            std::string payload;
+            size_t discarded = 0;
+            while (priority_sends_.try_pop(payload) || pending_sends_.try_pop(payload)) {
+                discarded++;
+            }
+            if (discarded > 0) {
+                LOG_WARN("Discarded " + std::to_string(discarded) + " unsent gateway payloads");
+            }
+        }));
+    }
+    
     void on_event(EventCallback callback) {
         event_callback_ = std::move(callback);
     }
     
+    void on_frame(FrameCallback callback) {
+        frame_callback_ = std::move(callback);
+    }
+    
     void on_close(CloseCallback callback) {
         close_callback_ = std::move(callback);
     }
@@ -167,9 +434,54 @@ public:
         intents_ = intents;
     }
     
+    void set_shard(int shard_id, int shard_count) {
+        shard_id_ = shard_id;
+        shard_count_ = shard_count;
+    }
+    
     void identify() {
+        request_handshake(PendingHandshake::IDENTIFY);
+    }
+    
+    void resume() {
+        request_handshake(PendingHandshake::RESUME);
+    }
+    
+    void request_handshake(PendingHandshake handshake) {
+        // IDENTIFY/RESUME are only valid after HELLO; until then just remember the request
+        pending_handshake_ = handshake;
+        if (hello_received_) {
+            perform_pending_handshake();
+        }
+    }
+    
+    void perform_pending_handshake() {
+        auto handshake = pending_handshake_.exchange(PendingHandshake::NONE);
+        if (handshake == PendingHandshake::RESUME) {
+            send_resume();
+        } else if (handshake == PendingHandshake::IDENTIFY) {
+            if (identify_gate_) {
+                // New sessions wait for a session start slot; resumes are not limited
+                uint64_t generation = connection_generation_.load();
+                identify_gate_(guarded([this, generation]() {
+                    // The slot may open after this connection was replaced
+                    if (generation == connection_generation_.load() && hello_received_) {
+                        send_identify();
+                    }
+                }));
+            } else {
+                send_identify();
+            }
+        }
+    }
+    
+    void set_identify_gate(IdentifyGate gate) {
+        identify_gate_ = std::move(gate);
+    }
+    
+    void send_identify() {
         nlohmann::json identify;
-        identify["op"] = 2;
+        identify["op"] = static_cast<int>(GatewayOpcode::IDENTIFY);
         identify["d"] = nlohmann::json{
             {"token", token_},
             {"intents", intents_},
@@ -179,43 +491,143 @@ public:
                 {"device", "discord.cpp"}
             }}
         };
+        if (shard_count_ > 0) {
+            identify["d"]["shard"] = nlohmann::json::array({shard_id_, shard_count_});
+        }
         send(identify);
     }
     
-    void resume() {
-        if (session_id_.empty()) {
-            identify();
+    void send_resume() {
+        std::string session_id;
+        {
+            std::lock_guard<std::mutex> lock(session_mutex_);
+            session_id = session_id_;
+        }
+        
+        if (session_id.empty()) {
+            request_handshake(PendingHandshake::IDENTIFY);
             return;
         }
         
         nlohmann::json resume;
-        resume["op"] = 6;
+        resume["op"] = static_cast<int>(GatewayOpcode::RESUME);
         resume["d"] = nlohmann::json{
             {"token", token_},
-            {"session_id", session_id_},
-            {"seq", last_sequence_}
+            {"session_id", session_id},
+            {"seq", sequence_json()}
         };
         send(resume);
-        LOG_INFO("Attempting to resume session");
+        LOG_INFO("Attempting to resume session " + session_id + " at seq " + std::to_string(last_sequence_.load()));
     }
     
-    void start_heartbeat(int interval_ms) {
-        if (heartbeat_thread_.joinable()) {
-            heartbeat_thread_.join();
+    void track_session(const nlohmann::json& payload) {
+        auto seq = payload.find("s");
+        if (seq != payload.end() && seq->is_number_integer()) {
+            last_sequence_ = seq->get<int64_t>();
         }
         
-        heartbeat_thread_ = std::thread([this, interval_ms]() {
-            while (is_connected_) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
-                
-                if (is_connected_) {
-                    nlohmann::json heartbeat;
-                    heartbeat["op"] = 1;
-                    heartbeat["d"] = last_sequence_;
-                    send(heartbeat);
-                }
+        auto type = payload.find("t");
+        if (type == payload.end() || !type->is_string()) {
+            return;
+        }
+        
+        const auto& event_type = type->get_ref<const std::string&>();
+        if (event_type == "READY" && payload.contains("d")) {
+            const auto& data = payload["d"];
+            std::string session_id = data.value("session_id", "");
+            {
+                std::lock_guard<std::mutex> lock(session_mutex_);
+                session_id_ = session_id;
+                resume_gateway_url_ = data.value("resume_gateway_url", "");
             }
-        });
+            reconnect_manager_->update_session(session_id);
+        } else if (event_type == "RESUMED") {
+            LOG_INFO("Session resumed at seq " + std::to_string(last_sequence_.load()));
+        }
+    }
+    
+    nlohmann::json sequence_json() const {
+        int64_t seq = last_sequence_.load();
+        return seq < 0 ? nlohmann::json(nullptr) : nlohmann::json(seq);
+    }
+    
+    std::string get_session_id() const {
+        std::lock_guard<std::mutex> lock(session_mutex_);
+        return session_id_;
+    }
+    
+    std::string get_resume_gateway_url() const {
+        std::lock_guard<std::mutex> lock(session_mutex_);
+        return resume_gateway_url_;
+    }
+    
+    int64_t get_sequence() const {
+        return last_sequence_.load();
+    }
+    
+    void restore_session(const std::string& session_id, int64_t sequence, const std::string& resume_gateway_url) {
+        {
+            std::lock_guard<std::mutex> lock(session_mutex_);
+            session_id_ = session_id;
+            resume_gateway_url_ = resume_gateway_url;
+            last_sequence_ = sequence;
+        }
+        reconnect_manager_->update_session(session_id);
+    }
+    
+    void start_heartbeat(int interval_ms) {
+        stop_heartbeat();
+        
+        heartbeat_id_ = HeartbeatScheduler::instance().add(
+            std::chrono::milliseconds(interval_ms),
+            guarded([this]() { send_heartbeat(); }),
+            guarded([this]() { handle_zombie_connection(); }));
+    }
+    
+    void stop_heartbeat() {
+        auto id = heartbeat_id_.exchange(0);
+        if (id != 0) {
+            HeartbeatScheduler::instance().remove(id);
+        }
+    }
+    
+    void send_heartbeat() {
+        if (is_connected_) {
+            nlohmann::json heartbeat;
+            heartbeat["op"] = static_cast<int>(GatewayOpcode::HEARTBEAT);
+            heartbeat["d"] = sequence_json();
+            send(heartbeat);
+        }
+    }
+    
+    void handle_zombie_connection() {
+        // Runs on the timer thread shared by every connection: only hand off, never block it
+        uint64_t generation = connection_generation_.load();
+        boost::asio::post(*send_strand_, guarded([this, generation]() {
+            close_zombie_connection(generation);
+        }));
+    }
+    
+    void close_zombie_connection(uint64_t generation) {
+        // The connection may have been replaced while this was queued
+        if (generation != connection_generation_.load()) {
+            return;
+        }
+        
+        heartbeat_id_ = 0;
+        LOG_WARN("Heartbeat ACK not received, closing zombied connection");
+        
+        // Any code other than 1000/1001 keeps the session resumable
+        websocketpp::lib::error_code ec;
+        client_.close(current_connection(), websocketpp::close::status::service_restart, "Zombied connection", ec);
+        is_connected_ = false;
+        
+        reconnect_manager_->handle_disconnect(websocketpp::close::status::abnormal_close, "Heartbeat ACK not received");
+    }
+    
+    HeartbeatStats get_heartbeat_stats() const {
+        auto stats = HeartbeatScheduler::instance().get_stats(heartbeat_id_.load());
+        return stats ? *stats : HeartbeatStats{};
     }
     
     void enable_auto_reconnect(bool enabled) {
@@ -246,7 +658,7 @@ public:
     }
     
     void initialize_compression() {
-        compression_buffer_.resize(COMPRESSION_BUFFER_SIZE);
+        inflate_buffer_.reserve(INFLATE_BUFFER_SIZE);
         
         zlib_stream_.zalloc = Z_NULL;
         zlib_stream_.zfree = Z_NULL;
@@ -266,75 +678,219 @@ public:
         }
     }
     
-    std::string decompress_message(const std::string& compressed_data) {
+    /**
+     * Inflate one zlib-stream frame into the reusable inflate buffer.
+     * Discord flushes the shared stream after every payload, so a complete
+     * payload ends with the 00 00 FF FF sync-flush marker; frames without it
+     * are partial and are held until the rest arrives.
+     */
+    bool decompress_message(std::string_view compressed_data, std::string_view& out) {
         if (!compression_enabled_) {
-            return compressed_data;
+            out = compressed_data;
+            return true;
         }
         
-        // Discord sends zlib-compressed messages with 4-byte header
-        if (compressed_data.size() < 4) {
-            return compressed_data;
+        static constexpr std::string_view ZLIB_SUFFIX("\x00\x00\xff\xff", 4);
+        
+        bool complete = compressed_data.size() >= ZLIB_SUFFIX.size() &&
+                        compressed_data.substr(compressed_data.size() - ZLIB_SUFFIX.size()) == ZLIB_SUFFIX;
+        
+        if (!pending_compressed_.empty() || !complete) {
+            pending_compressed_.append(compressed_data);
+            if (!complete) {
+                return false;
+            }
+            compressed_data = pending_compressed_;
         }
         
-        // Skip the 4-byte header
-        const char* data_ptr = compressed_data.data() + 4;
-        size_t data_size = compressed_data.size() - 4;
+        zlib_stream_.avail_in = static_cast<uInt>(compressed_data.size());
+        zlib_stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed_data.data()));
         
-        zlib_stream_.avail_in = static_cast<uInt>(data_size);
-        zlib_stream_.next_in = reinterpret_cast<const Bytef*>(data_ptr);
+        size_t produced = 0;
+        inflate_buffer_.clear();
         
-        std::string result;
         do {
-            zlib_stream_.avail_out = static_cast<uInt>(compression_buffer_.size());
-            zlib_stream_.next_out = compression_buffer_.data();
+            // Grow without zero-filling; capacity is kept across frames
+            size_t target = std::max(inflate_buffer_.capacity(), produced + INFLATE_BUFFER_SIZE);
+            inflate_buffer_.resize_and_overwrite(target, [](char*, size_t size) { return size; });
+            
+            zlib_stream_.next_out = reinterpret_cast<Bytef*>(inflate_buffer_.data() + produced);
+            zlib_stream_.avail_out = static_cast<uInt>(inflate_buffer_.size() - produced);
             
-            int ret = inflate(&zlib_stream_, Z_NO_FLUSH);
+            int ret = inflate(&zlib_stream_, Z_SYNC_FLUSH);
             
             if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR) {
                 LOG_ERROR("Zlib decompression error: " + std::to_string(ret));
-                return compressed_data; // Return original data on error
+                pending_compressed_.clear();
+                return false;
             }
             
-            size_t have = compression_buffer_.size() - zlib_stream_.avail_out;
-            result.append(reinterpret_cast<char*>(compression_buffer_.data()), have);
-            
+            produced = inflate_buffer_.size() - zlib_stream_.avail_out;
         } while (zlib_stream_.avail_out == 0);
         
-        return result;
+        inflate_buffer_.resize(produced);
+        pending_compressed_.clear();
+        
+        out = inflate_buffer_;
+        return true;
     }
 
 private:
+    /**
+     * Wrap a handler that captures this so that it does nothing once the
+     * client is destroyed (see HandlerLifetime)
+     */
+    template<typename Handler>
+    auto guarded(Handler handler) {
+        return [lifetime = lifetime_, handler = std::move(handler)](auto&&... args) {
+            HandlerScope scope(*lifetime);
+            if (scope) {
+                handler(std::forward<decltype(args)>(args)...);
+            }
+        };
+    }
+    
+    bool open_connection(const std::string& url) {
+        try {
+            if (!io_pool_) {
+                // The private I/O thread exits once the previous connection is gone
+                if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+                    thread_.join();
+                }
+                client_.reset();
+            }
+            
+            websocketpp::lib::error_code ec;
+            websocket_client::connection_ptr con = client_.get_connection(url, ec);
+            
+            if (ec) {
+                LOG_ERROR("Failed to create connection to " + url + ": " + ec.message());
+                return false;
+            }
+            
+            // Every connection starts a fresh zlib stream
+            if (compression_enabled_) {
+                inflateReset(&zlib_stream_);
+                pending_compressed_.clear();
+            }
+            
+            hello_received_ = false;
+            connection_generation_++;
+            {
+                std::lock_guard<std::mutex> lock(session_mutex_);
+                connection_hdl_ = con->get_handle();
+            }
+            closing_ = false;
+            
+            client_.connect(con);
+            
+            if (!io_pool_) {
+                thread_ = std::thread([this]() {
+                    try {
+                        client_.run();
+                    } catch (const std::exception& e) {
+                        is_connected_ = false;
+                    }
+                });
+            }
+            
+            return true;
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to connect to " + url + ": " + std::string(e.what()));
+            return false;
+        }
+    }
+    
+    websocketpp::connection_hdl current_connection() const {
+        std::lock_guard<std::mutex> lock(session_mutex_);
+        return connection_hdl_;
+    }
+    
+    bool is_current_connection(websocketpp::connection_hdl hdl) const {
+        std::lock_guard<std::mutex> lock(session_mutex_);
+        return !connection_hdl_.owner_before(hdl) && !hdl.owner_before(connection_hdl_);
+    }
+    
+    // Caller holds session_mutex_
+    std::string build_resume_url() const {
+        if (resume_gateway_url_.empty()) {
+            return gateway_url_;
+        }
+        
+        // resume_gateway_url carries no query; reuse version, encoding and compression
+        auto query = gateway_url_.find('?');
+        std::string url = resume_gateway_url_;
+        if (url.back() != '/') {
+            url += '/';
+        }
+        url += query != std::string::npos ? gateway_url_.substr(query) : "?v=10&encoding=json";
+        return url;
+    }
+    
+    using SendStrand = boost::asio::strand<boost::asio::io_context::executor_type>;
+    
+    std::shared_ptr<IoContextPool> io_pool_;
+    std::shared_ptr<HandlerLifetime> lifetime_ = std::make_shared<HandlerLifetime>();
     websocket_client client_;
     std::thread thread_;
-    std::thread heartbeat_thread_;
+    
+    // Outbound queue, drained on send_strand_ within the gateway command limit
+    MpscQueue<std::string> priority_sends_;
+    MpscQueue<std::string> pending_sends_;
+    GatewaySendLimiter send_limiter_;
+    std::atomic<bool> drain_scheduled_{false};
+    std::unique_ptr<SendStrand> send_strand_;
+    std::unique_ptr<boost::asio::steady_timer> send_timer_;
+    std::atomic<HeartbeatScheduler::HeartbeatId> heartbeat_id_{0};
     websocketpp::connection_hdl connection_hdl_;
     std::atomic<bool> is_connected_;
+    std::atomic<bool> closing_{false};
+    std::atomic<bool> hello_received_{false};
+    std::atomic<uint64_t> connection_generation_{0};
+    std::atomic<PendingHandshake> pending_handshake_{PendingHandshake::NONE};
     std::string token_;
-    int intents_;
+    int intents_ = 0;
+    int shard_id_ = 0;
+    int shard_count_ = 0;
+    
+    // Session state for RESUME, guarded by session_mutex_ (sequence is lock-free)
+    mutable std::mutex session_mutex_;
+    std::string gateway_url_;
     std::string session_id_;
-    int last_sequence_;
+    std::string resume_gateway_url_;
+    std::atomic<int64_t> last_sequence_{-1};
     bool compression_enabled_;
     
-    // Compression support
+    // Compression support (zlib-stream, one inflate context per connection)
     z_stream zlib_stream_;
-    std::vector<uint8_t> compression_buffer_;
-    static constexpr size_t COMPRESSION_BUFFER_SIZE = 8192;
+    std::string inflate_buffer_;
+    std::string pending_compressed_;
+    static constexpr size_t INFLATE_BUFFER_SIZE = 8192;
     
     EventCallback event_callback_;
+    FrameCallback frame_callback_;
     CloseCallback close_callback_;
+    IdentifyGate identify_gate_;
     std::unique_ptr<ReconnectionManager> reconnect_manager_;
 };
 
 WebSocketClient::WebSocketClient() : pImpl(std::make_unique<Impl>()) {}
 
+WebSocketClient::WebSocketClient(std::shared_ptr<IoContextPool> io_pool)
+    : pImpl(std::make_unique<Impl>(std::move(io_pool))) {}
+
 WebSocketClient::~WebSocketClient() = default;
 
-bool WebSocketClient::connect(const std::string& url) {
-    return pImpl->connect(url);
+bool WebSocketClient::connect(const std::string& url, bool resume) {
+    return pImpl->connect(url, resume);
+}
+
+bool WebSocketClient::reconnect(bool resume) {
+    return pImpl->reconnect(resume);
 }
 
-void WebSocketClient::disconnect() {
-    pImpl->disconnect();
+void WebSocketClient::disconnect(bool keep_session) {
+    pImpl->disconnect(keep_session);
 }
 
 bool WebSocketClient::is_connected() const {
@@ -345,10 +901,22 @@ void WebSocketClient::send(const nlohmann::json& payload) {
     pImpl->send(payload);
 }
 
+void WebSocketClient::send_serialized(std::string payload, bool priority) {
+    pImpl->send_serialized(std::move(payload), priority);
+}
+
+size_t WebSocketClient::get_pending_send_count() const {
+    return pImpl->get_pending_send_count();
+}
+
 void WebSocketClient::on_event(EventCallback callback) {
     pImpl->on_event(std::move(callback));
 }
 
+void WebSocketClient::on_frame(FrameCallback callback) {
+    pImpl->on_frame(std::move(callback));
+}
+
 void WebSocketClient::on_close(CloseCallback callback) {
     pImpl->on_close(std::move(callback));
 }
@@ -361,10 +929,39 @@ void WebSocketClient::set_intents(int intents) {
     pImpl->set_intents(intents);
 }
 
+void WebSocketClient::set_shard(int shard_id, int shard_count) {
+    pImpl->set_shard(shard_id, shard_count);
+}
+
 void WebSocketClient::identify() {
     pImpl->identify();
 }
 
+void WebSocketClient::set_identify_gate(IdentifyGate gate) {
+    pImpl->set_identify_gate(std::move(gate));
+}
+
+void WebSocketClient::resume() {
+    pImpl->resume();
+}
+
+std::string WebSocketClient::get_session_id() const {
+    return pImpl->get_session_id();
+}
+
+std::string WebSocketClient::get_resume_gateway_url() const {
+    return pImpl->get_resume_gateway_url();
+}
+
+int64_t WebSocketClient::get_sequence() const {
+    return pImpl->get_sequence();
+}
+
+void WebSocketClient::restore_session(const std::string& session_id, int64_t sequence,
+                                      const std::string& resume_gateway_url) {
+    pImpl->restore_session(session_id, sequence, resume_gateway_url);
+}
+
 void WebSocketClient::enable_auto_reconnect(bool enabled) {
     pImpl->enable_auto_reconnect(enabled);
 }
@@ -387,6 +984,14 @@ void WebSocketClient::enable_compression(bool enabled) {
     pImpl->enable_compression(enabled);
 }
 
+std::chrono::milliseconds WebSocketClient::get_latency() const {
+    return pImpl->get_heartbeat_stats().latency;
+}
+
+HeartbeatStats WebSocketClient::get_heartbeat_stats() const {
+    return pImpl->get_heartbeat_stats();
+}
+
 bool WebSocketClient::is_compression_enabled() const {
     return pImpl->compression_enabled_;
 }
@@ -0,0 +1,93 @@
+#include <discord/utils/keyed_executor.h>
+#include <discord/utils/logger.h>
+
+namespace discord {
+
+KeyedExecutor::KeyedExecutor(std::shared_ptr<IThreadPool> pool)
+    : pool_(std::move(pool)) {}
+
+void KeyedExecutor::submit(uint64_t key, Task task) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+
+    bool needs_drain;
+    {
+        Stripe& stripe = stripe_for(key);
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        auto [it, inserted] = stripe.queues.try_emplace(key);
+        it->second.tasks.push_back(std::move(task));
+        needs_drain = inserted;
+    }
+
+    // A key present in its stripe already has a drain job that will pick the task up
+    if (needs_drain) {
+        schedule(key);
+    }
+}
+
+bool KeyedExecutor::wait_idle(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    return idle_cv_.wait_for(lock, timeout, [this] {
+        return pending_.load(std::memory_order_acquire) == 0;
+    });
+}
+
+size_t KeyedExecutor::get_pending_count() const {
+    return pending_.load(std::memory_order_relaxed);
+}
+
+// Private methods
+
+KeyedExecutor::Stripe& KeyedExecutor::stripe_for(uint64_t key) {
+    // Snowflakes keep their low bits for the increment; mix so stripes fill evenly
+    uint64_t mixed = key * 0x9E3779B97F4A7C15ull;
+    return stripes_[(mixed >> 58) % STRIPE_COUNT];
+}
+
+void KeyedExecutor::schedule(uint64_t key) {
+    try {
+        pool_->submit(Task([self = shared_from_this(), key] { self->drain(key); }));
+    } catch (const std::exception& e) {
+        // The pool is shutting down; run the key's tasks here rather than lose them
+        LOG_WARN("Thread pool rejected keyed tasks: " + std::string(e.what()));
+        drain(key);
+    }
+}
+
+void KeyedExecutor::drain(uint64_t key) {
+    Stripe& stripe = stripe_for(key);
+
+    for (size_t run = 0; run < MAX_BATCH; ++run) {
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            auto it = stripe.queues.find(key);
+            if (it->second.tasks.empty()) {
+                stripe.queues.erase(it);
+                return;
+            }
+            task = std::move(it->second.tasks.front());
+            it->second.tasks.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            LOG_ERROR("Keyed task error: " + std::string(e.what()));
+        } catch (...) {
+            LOG_ERROR("Keyed task error: unknown exception");
+        }
+        task_done();
+    }
+
+    // Let other keys use this worker; ordering holds because only this job drains the key
+    schedule(key);
+}
+
+void KeyedExecutor::task_done() {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        idle_cv_.notify_all();
+    }
+}
+
+} // namespace discord
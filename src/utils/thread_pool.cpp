@@ -14,15 +14,16 @@ ThreadPool::~ThreadPool() {
 }
 
 std::future<void> ThreadPool::submit(std::function<void()> task) {
-    auto promise = std::promise<void>();
-    auto future = promise.get_future();
+    // std::function needs a copyable target, so the promise is shared
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
     
-    auto wrapped_task = [promise = std::move(promise), task = std::move(task)]() mutable {
+    auto wrapped_task = [promise, task = std::move(task)]() {
         try {
             task();
-            promise.set_value();
+            promise->set_value();
         } catch (...) {
-            promise.set_exception(std::current_exception());
+            promise->set_exception(std::current_exception());
         }
     };
     
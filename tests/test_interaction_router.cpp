@@ -0,0 +1,34 @@
+#include <catch2/catch.hpp>
+#include <discord/events/interaction_router.h>
+#include <stdexcept>
+
+namespace discord::tests {
+
+namespace {
+
+void noop(const nlohmann::json&, const RouteParams&) {}
+
+} // namespace
+
+TEST_CASE("CustomIdRouter::add counts '*' against MAX_PARAMS") {
+    CustomIdRouter router;
+
+    SECTION("eight parameters plus a wildcard are rejected") {
+        REQUIRE_THROWS_AS(router.add("{a}:{b}:{c}:{d}:{e}:{f}:{g}:{h}:*", noop), std::invalid_argument);
+
+        RouteParams params;
+        REQUIRE(router.find("1:2:3:4:5:6:7:8:rest", params) == nullptr);
+    }
+
+    SECTION("seven parameters plus a wildcard capture every value") {
+        router.add("{a}:{b}:{c}:{d}:{e}:{f}:{g}:*", noop);
+
+        RouteParams params;
+        REQUIRE(router.find("1:2:3:4:5:6:7:rest", params) != nullptr);
+        REQUIRE(params.size() == RouteParams::MAX_PARAMS);
+        REQUIRE(params.get("g") == "7");
+        REQUIRE(params.get("*") == "rest");
+    }
+}
+
+} // namespace discord::tests